@@ -0,0 +1,325 @@
+// Standalone physics benchmark. Builds scenes straight into a World and steps a PhysicsWorld
+// without a window or renderer, then reports per-stage timings, pair counts and memory.
+// With --determinism it hashes every body transform after the run and checks the hash is
+// the same across repeated runs and thread counts.
+
+#include "../Engine/Core/Log.h"
+#include "../Engine/Core/JobSystem.h"
+#include "../Engine/ECS/World.h"
+#include "../Engine/ECS/Components/Transform.h"
+#include "../Engine/ECS/Components/Collider.h"
+#include "../Engine/ECS/Components/RigidBody.h"
+#include "../Engine/Physics/PhysicsWorld.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Xi {
+
+    // Small deterministic generator so scenes don't depend on the C library's rand
+    class Random {
+    public:
+        explicit Random(uint32_t seed) : m_State(seed ? seed : 1u) {}
+
+        float Next() {
+            m_State ^= m_State << 13;
+            m_State ^= m_State >> 17;
+            m_State ^= m_State << 5;
+            return static_cast<float>(m_State & 0xFFFFFF) / static_cast<float>(0x1000000);
+        }
+
+        float Range(float low, float high) { return low + (high - low) * Next(); }
+
+    private:
+        uint32_t m_State;
+    };
+
+    struct BenchmarkOptions {
+        std::string scene = "all";
+        uint32_t bodies = 0;  // 0 uses the scene's default
+        uint32_t steps = 300;
+        int threads = -1;     // -1 uses every hardware thread
+        bool determinism = false;
+    };
+
+    struct BenchmarkScene {
+        const char* name;
+        uint32_t defaultBodies;
+        void (*build)(World& world, uint32_t bodies);
+        uint32_t raysPerStep;
+    };
+
+    struct BenchmarkResult {
+        PhysicsStepStats average;
+        float maxStepMs = 0.0f;
+        float raycastMs = 0.0f;  // Per step
+        uint32_t rayHits = 0;
+        size_t memoryBytes = 0;
+        uint32_t sleepingBodies = 0;
+        uint64_t hash = 0;
+    };
+
+    static Entity CreateGround(World& world, float size) {
+        Entity ground = world.CreateEntity("Ground");
+        world.AddComponent<Transform>(ground);
+        Collider& collider = world.AddComponent<Collider>(ground);
+        collider.size = glm::vec3(size, 0.2f, size);
+        collider.center = glm::vec3(0.0f, -0.1f, 0.0f);
+        return ground;
+    }
+
+    static Entity CreateBody(World& world, const glm::vec3& position, ColliderType type) {
+        Entity entity = world.CreateEntity("Body");
+        world.AddComponent<Transform>(entity).position = position;
+        Collider& collider = world.AddComponent<Collider>(entity);
+        collider.type = type;
+        collider.radius = type == ColliderType::Capsule ? 0.3f : 0.5f;
+        world.AddComponent<RigidBody>(entity);
+        return entity;
+    }
+
+    // Towers of ten boxes on a grid
+    static void BuildStacks(World& world, uint32_t bodies) {
+        uint32_t towers = (bodies + 9) / 10;
+        uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(towers))));
+        CreateGround(world, side * 3.0f + 10.0f);
+
+        for (uint32_t i = 0; i < bodies; i++) {
+            uint32_t tower = i / 10;
+            float x = (tower % side) * 3.0f - side * 1.5f;
+            float z = (tower / side) * 3.0f - side * 1.5f;
+            CreateBody(world, glm::vec3(x, 0.5f + (i % 10) * 1.0f, z), ColliderType::Box);
+        }
+    }
+
+    // Spheres with a few boxes and capsules falling from a jittered grid onto a floor
+    static void BuildRain(World& world, uint32_t bodies) {
+        uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(bodies / 4.0f)));
+        CreateGround(world, side * 1.5f + 20.0f);
+
+        Random random(7);
+        for (uint32_t i = 0; i < bodies; i++) {
+            uint32_t cell = i % (side * side);
+            uint32_t layer = i / (side * side);
+            glm::vec3 position((cell % side) * 1.5f - side * 0.75f + random.Range(-0.2f, 0.2f),
+                               2.0f + layer * 1.5f,
+                               (cell / side) * 1.5f - side * 0.75f + random.Range(-0.2f, 0.2f));
+
+            ColliderType type = i % 8 == 0 ? ColliderType::Box : (i % 8 == 1 ? ColliderType::Capsule : ColliderType::Sphere);
+            CreateBody(world, position, type);
+        }
+    }
+
+    // A loose pile to cast rays into; the rays are cast while stepping
+    static void BuildRaycastTargets(World& world, uint32_t bodies) {
+        BuildRain(world, bodies);
+    }
+
+    // Many static boxes without rigid bodies and a few dynamic spheres bouncing between them
+    static void BuildStatics(World& world, uint32_t bodies) {
+        uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(bodies))));
+        CreateGround(world, side * 2.0f + 10.0f);
+
+        Random random(11);
+        for (uint32_t i = 0; i < bodies; i++) {
+            Entity entity = world.CreateEntity("Static");
+            Transform& transform = world.AddComponent<Transform>(entity);
+            transform.position = glm::vec3((i % side) * 2.0f - side, random.Range(0.0f, 3.0f), (i / side) * 2.0f - side);
+            transform.rotation = glm::vec3(0.0f, random.Range(0.0f, 90.0f), 0.0f);
+            world.AddComponent<Collider>(entity).size = glm::vec3(1.0f, random.Range(0.5f, 2.0f), 1.0f);
+        }
+
+        uint32_t dynamicCount = glm::max(bodies / 100, 8u);
+        for (uint32_t i = 0; i < dynamicCount; i++) {
+            glm::vec3 position(random.Range(-0.5f, 0.5f) * side * 2.0f, 8.0f, random.Range(-0.5f, 0.5f) * side * 2.0f);
+            Entity entity = CreateBody(world, position, ColliderType::Sphere);
+            RigidBody& rb = world.GetComponent<RigidBody>(entity);
+            rb.velocity = glm::vec3(random.Range(-5.0f, 5.0f), 0.0f, random.Range(-5.0f, 5.0f));
+            rb.bounciness = 0.5f;
+        }
+    }
+
+    static const BenchmarkScene s_Scenes[] = {
+        { "stacks", 2000, BuildStacks, 0 },
+        { "rain", 4000, BuildRain, 0 },
+        { "raycasts", 2000, BuildRaycastTargets, 2000 },
+        { "statics", 10000, BuildStatics, 0 },
+    };
+
+    // FNV-1a over the bits of every body's position and rotation, in pool order
+    static uint64_t HashTransforms(World& world) {
+        uint64_t hash = 14695981039346656037ull;
+        auto* pool = world.GetComponentPool<RigidBody>();
+        if (!pool) return hash;
+
+        for (Entity entity : pool->GetEntities()) {
+            const Transform& transform = world.GetComponent<Transform>(entity);
+            unsigned char bytes[sizeof(glm::vec3) * 2];
+            std::memcpy(bytes, &transform.position, sizeof(glm::vec3));
+            std::memcpy(bytes + sizeof(glm::vec3), &transform.rotation, sizeof(glm::vec3));
+            for (unsigned char byte : bytes) {
+                hash ^= byte;
+                hash *= 1099511628211ull;
+            }
+        }
+        return hash;
+    }
+
+    static BenchmarkResult RunScene(const BenchmarkScene& scene, uint32_t bodies, uint32_t steps, JobSystem* jobs) {
+        World world;
+        PhysicsWorld physics;
+        physics.SetWorld(&world);
+        physics.SetJobSystem(jobs);
+        scene.build(world, bodies);
+
+        BenchmarkResult result;
+        Random random(3);
+        double raycastMs = 0.0;
+
+        for (uint32_t step = 0; step < steps; step++) {
+            physics.Step(1.0f / 60.0f);
+
+            const PhysicsStepStats& stats = physics.GetStepStats();
+            result.average.integrateMs += stats.integrateMs;
+            result.average.broadphaseMs += stats.broadphaseMs;
+            result.average.narrowphaseMs += stats.narrowphaseMs;
+            result.average.solveMs += stats.solveMs;
+            result.average.totalMs += stats.totalMs;
+            result.average.broadphasePairs += stats.broadphasePairs;
+            result.average.contactCount += stats.contactCount;
+            result.average.islandCount += stats.islandCount;
+            result.maxStepMs = glm::max(result.maxStepMs, stats.totalMs);
+
+            auto raycastStart = std::chrono::high_resolution_clock::now();
+            for (uint32_t i = 0; i < scene.raysPerStep; i++) {
+                glm::vec3 origin(random.Range(-40.0f, 40.0f), 30.0f, random.Range(-40.0f, 40.0f));
+                glm::vec3 direction(random.Range(-0.5f, 0.5f), -1.0f, random.Range(-0.5f, 0.5f));
+                if (physics.Raycast(Ray(origin, direction), 100.0f).hit) result.rayHits++;
+            }
+            raycastMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - raycastStart).count();
+        }
+
+        float count = static_cast<float>(glm::max(steps, 1u));
+        result.average.integrateMs /= count;
+        result.average.broadphaseMs /= count;
+        result.average.narrowphaseMs /= count;
+        result.average.solveMs /= count;
+        result.average.totalMs /= count;
+        result.average.broadphasePairs /= glm::max(steps, 1u);
+        result.average.contactCount /= glm::max(steps, 1u);
+        result.average.islandCount /= glm::max(steps, 1u);
+        result.average.bodyCount = physics.GetStepStats().bodyCount;
+        result.average.colliderCount = physics.GetStepStats().colliderCount;
+        result.raycastMs = static_cast<float>(raycastMs / count);
+        result.memoryBytes = physics.GetMemoryUsage();
+        result.sleepingBodies = physics.GetSleepingBodyCount();
+        result.hash = HashTransforms(world);
+        return result;
+    }
+
+    static void PrintResult(const BenchmarkScene& scene, uint32_t steps, const BenchmarkResult& result) {
+        const PhysicsStepStats& s = result.average;
+        std::printf("%-9s bodies %6u  colliders %6u  steps %u\n", scene.name, s.bodyCount, s.colliderCount, steps);
+        std::printf("  per step (ms)  integrate %7.3f  broadphase %7.3f  narrowphase %7.3f  solve %7.3f  total %7.3f  max %7.3f\n",
+                    s.integrateMs, s.broadphaseMs, s.narrowphaseMs, s.solveMs, s.totalMs, result.maxStepMs);
+        std::printf("  per step       pairs %7u  contacts %7u  islands %7u  sleeping at end %u\n",
+                    s.broadphasePairs, s.contactCount, s.islandCount, result.sleepingBodies);
+        if (scene.raysPerStep > 0) {
+            std::printf("  raycasts       %u per step, %.3f ms per step, %u hits\n", scene.raysPerStep, result.raycastMs, result.rayHits);
+        }
+        std::printf("  memory         %.1f KB\n", result.memoryBytes / 1024.0);
+    }
+
+    // Runs the scene twice on the calling thread and once for each thread count, and compares
+    static bool CheckDeterminism(const BenchmarkScene& scene, uint32_t bodies, uint32_t steps) {
+        uint32_t hardwareThreads = glm::max(std::thread::hardware_concurrency(), 2u);
+        std::vector<uint32_t> workerCounts = { 1, 2 };
+        if (hardwareThreads - 1 > 2) workerCounts.push_back(hardwareThreads - 1);
+
+        uint64_t reference = RunScene(scene, bodies, steps, nullptr).hash;
+        bool match = RunScene(scene, bodies, steps, nullptr).hash == reference;
+        std::printf("%-9s reference %016llx (no job system, run twice: %s)\n", scene.name,
+                    static_cast<unsigned long long>(reference), match ? "same" : "DIFFERENT");
+
+        for (uint32_t workers : workerCounts) {
+            JobSystem jobs(workers);
+            uint64_t hash = RunScene(scene, bodies, steps, &jobs).hash;
+            bool same = hash == reference;
+            std::printf("          %2u workers %016llx %s\n", workers, static_cast<unsigned long long>(hash), same ? "same" : "DIFFERENT");
+            match = match && same;
+        }
+
+        std::printf("          %s\n", match ? "PASS" : "FAIL");
+        return match;
+    }
+
+    static void PrintUsage() {
+        std::printf("Usage: XiPhysicsBenchmark [options]\n"
+                    "  --scene <name>    stacks, rain, raycasts, statics or all (default all)\n"
+                    "  --bodies <n>      body or collider count, default depends on the scene\n"
+                    "  --steps <n>       steps of 1/60 s to run (default 300)\n"
+                    "  --threads <n>     worker threads, 0 steps on the calling thread only (default all)\n"
+                    "  --determinism     hash transforms and compare across runs and thread counts\n");
+    }
+
+    static bool ParseOptions(int argc, char** argv, BenchmarkOptions& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--scene" && hasValue) options.scene = argv[++i];
+            else if (arg == "--bodies" && hasValue) options.bodies = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (arg == "--steps" && hasValue) options.steps = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (arg == "--threads" && hasValue) options.threads = std::atoi(argv[++i]);
+            else if (arg == "--determinism") options.determinism = true;
+            else return false;
+        }
+        return true;
+    }
+
+    static int RunBenchmark(int argc, char** argv) {
+        BenchmarkOptions options;
+        if (!ParseOptions(argc, argv, options)) {
+            PrintUsage();
+            return 1;
+        }
+
+        std::unique_ptr<JobSystem> jobs;
+        if (options.threads != 0) {
+            jobs = std::make_unique<JobSystem>(options.threads > 0 ? static_cast<uint32_t>(options.threads) : 0u);
+        }
+
+        bool found = false;
+        bool passed = true;
+        for (const BenchmarkScene& scene : s_Scenes) {
+            if (options.scene != "all" && options.scene != scene.name) continue;
+            found = true;
+
+            uint32_t bodies = options.bodies ? options.bodies : scene.defaultBodies;
+            if (options.determinism) {
+                passed = CheckDeterminism(scene, bodies, options.steps) && passed;
+            } else {
+                PrintResult(scene, options.steps, RunScene(scene, bodies, options.steps, jobs.get()));
+            }
+        }
+
+        if (!found) {
+            std::printf("Unknown scene '%s'\n", options.scene.c_str());
+            PrintUsage();
+            return 1;
+        }
+        return passed ? 0 : 2;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    return Xi::RunBenchmark(argc, argv);
+}
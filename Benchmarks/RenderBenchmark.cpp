@@ -0,0 +1,305 @@
+// Standalone renderer benchmark. Runs the Renderer on the null render device, so no window,
+// context or GPU is needed, and reports the CPU cost of each EndFrame stage, light binning
+// included, along with the draw calls, state changes and device calls a frame of the scene makes.
+
+#include "../Engine/Core/Log.h"
+#include "../Engine/Core/JobSystem.h"
+#include "../Engine/Renderer/Renderer.h"
+#include "../Engine/Renderer/Material.h"
+#include "../Engine/Renderer/Mesh.h"
+#include "../Engine/Renderer/Primitives.h"
+#include "../Engine/Renderer/NullRenderDevice.h"
+#include "../Engine/Renderer/RenderThread.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Xi {
+
+    // Small deterministic generator so scenes don't depend on the C library's rand
+    class Random {
+    public:
+        explicit Random(uint32_t seed) : m_State(seed ? seed : 1u) {}
+
+        float Next() {
+            m_State ^= m_State << 13;
+            m_State ^= m_State >> 17;
+            m_State ^= m_State << 5;
+            return static_cast<float>(m_State & 0xFFFFFF) / static_cast<float>(0x1000000);
+        }
+
+        float Range(float low, float high) { return low + (high - low) * Next(); }
+
+    private:
+        uint32_t m_State;
+    };
+
+    struct BenchmarkOptions {
+        uint32_t objects = 100000;
+        uint32_t frames = 60;
+        uint32_t meshes = 8;
+        uint32_t materials = 32;
+        float transparent = 0.1f;  // Fraction of materials
+        uint32_t lights = 0;       // Point and spot lights, besides one directional light
+        int threads = -1;          // -1 uses every hardware thread, 0 submits serially without a job system
+        uint32_t renderThread = 0; // Frame latency of a render thread drawing the packets, 0 draws in EndFrame
+        bool log = false;
+    };
+
+    struct BenchmarkScene {
+        std::vector<std::shared_ptr<Mesh>> meshes;
+        std::vector<std::shared_ptr<Material>> materials;
+
+        struct Object {
+            uint32_t mesh;
+            uint32_t material;
+            glm::mat4 transform;
+        };
+        std::vector<Object> objects;
+        std::vector<LightData> lights;
+    };
+
+    struct FrameTotals {
+        double submitMs = 0.0;  // The Submit calls
+        double cullMs = 0.0;
+        double sortMs = 0.0;
+        double batchMs = 0.0;
+        double lightMs = 0.0;
+        double drawMs = 0.0;
+        double frameMs = 0.0;   // Submit through EndFrame, on the calling thread
+        double wallMs = 0.0;    // Every frame, including draws still running on the render thread
+    };
+
+    // Objects scattered over a square field around the camera, which turns a little every
+    // frame so the visible set and the depth order change
+    static BenchmarkScene BuildScene(const BenchmarkOptions& options) {
+        typedef std::shared_ptr<Mesh> (*MeshFactory)();
+        static const MeshFactory s_Factories[] = {
+            []() { return Primitives::CreateCube(); },
+            []() { return Primitives::CreateSphere(16, 8); },
+            []() { return Primitives::CreateCylinder(16); },
+            []() { return Primitives::CreateCone(16); },
+        };
+
+        BenchmarkScene scene;
+        for (uint32_t i = 0; i < glm::max(options.meshes, 1u); i++) {
+            scene.meshes.push_back(s_Factories[i % 4]());
+        }
+
+        uint32_t transparentCount = static_cast<uint32_t>(options.materials * options.transparent);
+        for (uint32_t i = 0; i < glm::max(options.materials, 1u); i++) {
+            auto material = std::make_shared<Material>();
+            material->albedoColor = glm::vec4(0.2f + 0.8f * (i % 5) / 4.0f, 0.5f, 0.8f, 1.0f);
+            material->transparent = i < transparentCount;
+            if (material->transparent) material->albedoColor.a = 0.5f;
+            scene.materials.push_back(material);
+        }
+
+        Random random(1234);
+        float halfSize = glm::sqrt(static_cast<float>(options.objects)) * 1.5f;
+        scene.objects.resize(options.objects);
+        for (BenchmarkScene::Object& object : scene.objects) {
+            object.mesh = static_cast<uint32_t>(random.Next() * scene.meshes.size()) % scene.meshes.size();
+            object.material = static_cast<uint32_t>(random.Next() * scene.materials.size()) % scene.materials.size();
+
+            glm::vec3 position(random.Range(-halfSize, halfSize), random.Range(0.0f, 10.0f), random.Range(-halfSize, halfSize));
+            object.transform = glm::translate(glm::mat4(1.0f), position);
+            object.transform = glm::rotate(object.transform, random.Range(0.0f, 6.28f), glm::vec3(0.0f, 1.0f, 0.0f));
+            object.transform = glm::scale(object.transform, glm::vec3(random.Range(0.5f, 2.0f)));
+        }
+
+        LightData sun;
+        sun.direction = glm::normalize(glm::vec3(-0.3f, -1.0f, -0.2f));
+        scene.lights.push_back(sun);
+
+        // Every fourth light a spot pointing down at the field
+        for (uint32_t i = 0; i < options.lights; i++) {
+            LightData light;
+            light.type = i % 4 == 3 ? LightData::Type::Spot : LightData::Type::Point;
+            light.position = glm::vec3(random.Range(-halfSize, halfSize), random.Range(1.0f, 12.0f), random.Range(-halfSize, halfSize));
+            light.direction = glm::normalize(glm::vec3(random.Range(-0.5f, 0.5f), -1.0f, random.Range(-0.5f, 0.5f)));
+            light.color = glm::vec3(random.Range(0.5f, 1.0f), random.Range(0.5f, 1.0f), random.Range(0.5f, 1.0f));
+            light.range = random.Range(5.0f, 20.0f);
+            light.spotAngle = random.Range(20.0f, 50.0f);
+            scene.lights.push_back(light);
+        }
+        return scene;
+    }
+
+    static double Milliseconds(std::chrono::high_resolution_clock::time_point start,
+                               std::chrono::high_resolution_clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // Counts divided by frames, for counters that cover more than one
+    static void PrintDeviceCalls(const NullRenderDevice::Counters& counters, uint32_t frames) {
+        std::printf("  device calls   %llu total%s\n", static_cast<unsigned long long>(counters.GetTotal() / frames),
+                    frames > 1 ? " per frame" : "");
+        for (size_t i = 0; i < counters.calls.size(); i++) {
+            if (counters.calls[i] == 0) continue;
+            std::printf("    %-20s %llu\n", GetDeviceCallName(static_cast<DeviceCall>(i)),
+                        static_cast<unsigned long long>(counters.calls[i] / frames));
+        }
+        std::printf("  uploaded       %.1f KB, %llu instances drawn\n", counters.bytesUploaded / 1024.0 / frames,
+                    static_cast<unsigned long long>(counters.instancesDrawn / frames));
+    }
+
+    static void PrintUsage() {
+        std::printf("Usage: XiRenderBenchmark [options]\n"
+                    "  --objects <n>      objects submitted per frame (default 100000)\n"
+                    "  --frames <n>       frames to run (default 60)\n"
+                    "  --meshes <n>       distinct meshes (default 8)\n"
+                    "  --materials <n>    distinct materials (default 32)\n"
+                    "  --transparent <f>  fraction of materials that are transparent (default 0.1)\n"
+                    "  --lights <n>       point and spot lights binned into clusters each frame (default 0)\n"
+                    "  --threads <n>      worker threads, 0 submits serially on the calling thread (default all)\n"
+                    "  --render-thread <n> draw on a render thread with up to n frames in flight (default 0, off)\n"
+                    "  --log              log every device call of the last frame, without a render thread\n");
+    }
+
+    static bool ParseOptions(int argc, char** argv, BenchmarkOptions& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--objects" && hasValue) options.objects = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (arg == "--frames" && hasValue) options.frames = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (arg == "--meshes" && hasValue) options.meshes = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (arg == "--materials" && hasValue) options.materials = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (arg == "--transparent" && hasValue) options.transparent = static_cast<float>(std::atof(argv[++i]));
+            else if (arg == "--lights" && hasValue) options.lights = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (arg == "--threads" && hasValue) options.threads = std::atoi(argv[++i]);
+            else if (arg == "--render-thread" && hasValue) options.renderThread = static_cast<uint32_t>(std::atoi(argv[++i]));
+            else if (arg == "--log") options.log = true;
+            else return false;
+        }
+        return true;
+    }
+
+    static int RunBenchmark(int argc, char** argv) {
+        BenchmarkOptions options;
+        if (!ParseOptions(argc, argv, options)) {
+            PrintUsage();
+            return 1;
+        }
+
+        // Before anything creates a resource
+        auto ownedDevice = std::make_unique<NullRenderDevice>();
+        NullRenderDevice& device = *ownedDevice;
+        RenderDevice::SetCurrent(std::move(ownedDevice));
+
+        std::unique_ptr<JobSystem> jobs;
+        if (options.threads != 0) {
+            jobs = std::make_unique<JobSystem>(options.threads > 0 ? static_cast<uint32_t>(options.threads) : 0u);
+        }
+
+        Renderer renderer;
+        renderer.SetJobSystem(jobs.get());
+        renderer.Init();
+
+        BenchmarkScene scene = BuildScene(options);
+
+        Camera camera;
+        camera.SetPerspective(60.0f, 16.0f / 9.0f, 0.1f, 500.0f);
+        camera.SetPosition(glm::vec3(0.0f, 5.0f, 0.0f));
+
+        // The device counters are shared with the render thread, so with one they cover every
+        // frame instead of the last
+        std::unique_ptr<RenderThread> renderThread;
+        if (options.renderThread > 0) {
+            renderThread = std::make_unique<RenderThread>(nullptr, renderer, options.renderThread);
+            renderThread->Start();
+        }
+
+        FrameTotals totals;
+        Renderer::Stats lastStats;
+        uint32_t frames = glm::max(options.frames, 1u);
+
+        device.ResetCounters();
+        auto wallStart = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            bool lastFrame = frame + 1 == frames;
+            if (!renderThread) {
+                device.ResetCounters();
+                device.SetLogging(options.log && lastFrame);
+            }
+
+            camera.SetRotation(glm::vec3(10.0f, frame * 360.0f / frames, 0.0f));
+            renderer.SetCamera(camera);
+
+            auto frameStart = std::chrono::high_resolution_clock::now();
+            renderer.BeginFrame();
+            for (const LightData& light : scene.lights) {
+                renderer.AddLight(light);
+            }
+            if (jobs) {
+                renderer.SubmitParallel(static_cast<uint32_t>(scene.objects.size()), 1024,
+                    [&scene](RenderCommandList& list, uint32_t begin, uint32_t end) {
+                        for (uint32_t i = begin; i < end; i++) {
+                            const BenchmarkScene::Object& object = scene.objects[i];
+                            list.Submit(*scene.meshes[object.mesh], *scene.materials[object.material], object.transform);
+                        }
+                    });
+            } else {
+                for (const BenchmarkScene::Object& object : scene.objects) {
+                    renderer.Submit(*scene.meshes[object.mesh], *scene.materials[object.material], object.transform);
+                }
+            }
+            auto submitEnd = std::chrono::high_resolution_clock::now();
+            if (renderThread) {
+                FramePacket& packet = renderThread->AcquirePacket();
+                renderer.EndFrame(packet);
+                renderThread->SubmitPacket(packet);
+            } else {
+                renderer.EndFrame();
+            }
+            auto frameEnd = std::chrono::high_resolution_clock::now();
+
+            const Renderer::Stats& stats = renderer.GetStats();
+            totals.submitMs += Milliseconds(frameStart, submitEnd);
+            totals.cullMs += stats.cullTimeMs;
+            totals.sortMs += stats.sortTimeMs;
+            totals.batchMs += stats.batchTimeMs;
+            totals.lightMs += stats.lightTimeMs;
+            totals.drawMs += stats.submitTimeMs;
+            totals.frameMs += Milliseconds(frameStart, frameEnd);
+            lastStats = stats;
+        }
+        if (renderThread) {
+            renderThread->Stop();
+        }
+        totals.wallMs = Milliseconds(wallStart, std::chrono::high_resolution_clock::now());
+        device.SetLogging(false);
+
+        std::printf("objects %u  meshes %zu  materials %zu  frames %u  threads %u  render thread %s  device %s\n",
+                    options.objects, scene.meshes.size(), scene.materials.size(), frames,
+                    jobs ? jobs->GetThreadCount() : 1u, renderThread ? std::to_string(renderThread->GetMaxFrameLatency()).c_str() : "off",
+                    device.GetName());
+        std::printf("  per frame (ms) submit %7.3f  cull %7.3f  sort %7.3f  batch %7.3f  lights %7.3f  draw %7.3f  total %7.3f  wall %7.3f\n",
+                    totals.submitMs / frames, totals.cullMs / frames, totals.sortMs / frames, totals.batchMs / frames,
+                    totals.lightMs / frames, totals.drawMs / frames, totals.frameMs / frames, totals.wallMs / frames);
+        std::printf("  last frame     visible %u  culled %u  draw calls %u  instanced %u (%u objects)\n",
+                    lastStats.visibleObjects, lastStats.culledObjects, lastStats.drawCalls,
+                    lastStats.instancedDrawCalls, lastStats.instancedObjects);
+        std::printf("                 material binds %u  state changes %u  avoided %u\n",
+                    lastStats.materialBinds, lastStats.stateChanges, lastStats.stateChangesAvoided);
+        std::printf("                 lights %u  clustered %u  cluster entries %u\n",
+                    lastStats.lights, lastStats.clusteredLights, lastStats.lightAssignments);
+        PrintDeviceCalls(device.GetCounters(), renderThread ? frames : 1u);
+
+        renderThread.reset();
+        scene = BenchmarkScene();
+        renderer.Shutdown();
+        return 0;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    return Xi::RunBenchmark(argc, argv);
+}
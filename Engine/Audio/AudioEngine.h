@@ -38,6 +38,7 @@ namespace Xi {
         // Listener (camera) position
         void SetListenerPosition(const glm::vec3& position);
         void SetListenerOrientation(const glm::vec3& forward, const glm::vec3& up);
+        const glm::vec3& GetListenerPosition() const { return m_ListenerPosition; }
 
         // Master volume
         void SetMasterVolume(float volume);
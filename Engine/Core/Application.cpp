@@ -2,10 +2,13 @@
 #include "Log.h"
 #include "Time.h"
 #include "Input.h"
+#include "JobSystem.h"
 
 #include "../ECS/World.h"
 #include "../Renderer/Renderer.h"
+#include "../Renderer/RenderThread.h"
 #include "../Physics/PhysicsWorld.h"
+#include "../Physics/PhysicsSystem.h"
 #include "../Audio/AudioEngine.h"
 #include "../Editor/EditorUI.h"
 #include "../Scripting/ScriptEngine.h"
@@ -51,11 +54,15 @@ namespace Xi {
         Input::Init(m_Window->GetNativeWindow());
 
         // Initialize subsystems
+        m_JobSystem = std::make_unique<JobSystem>();
         m_World = std::make_unique<World>();
         m_Renderer = std::make_unique<Renderer>();
         m_Physics = std::make_unique<PhysicsWorld>();
         m_Audio = std::make_unique<AudioEngine>();
 
+        m_Physics->SetJobSystem(m_JobSystem.get());
+        m_Renderer->SetJobSystem(m_JobSystem.get());
+
         m_Renderer->Init();
         m_Audio->Init();
 
@@ -71,9 +78,20 @@ namespace Xi {
 
         // Register default systems
         m_World->RegisterDefaultSystems(*m_Renderer, *m_Physics);
+        m_PhysicsSystem = m_World->GetSystem<PhysicsSystem>();
 
         OnInit();
 
+        // After OnInit, so startup resources are created without going through the thread
+        if (m_RenderThreadEnabled) {
+            if (m_EditorMode) {
+                XI_LOG_WARN("Render thread disabled in editor mode, ImGui needs the context on the main thread");
+            } else {
+                m_RenderThread = std::make_unique<RenderThread>(m_Window.get(), *m_Renderer, m_MaxFrameLatency);
+                m_RenderThread->Start();
+            }
+        }
+
         XI_LOG_INFO("Xi Engine initialized successfully");
     }
 
@@ -85,13 +103,25 @@ namespace Xi {
             m_Window->PollEvents();
             Input::Update();
 
-            // Fixed timestep physics updates
+            // In the editor, bodies only simulate in play mode
+            m_PhysicsSystem->SetEnabled(!m_EditorMode || (m_Editor && m_Editor->IsPlayMode()));
+
+            // Physics from the last frame may still be running; nothing below may touch it before this
+            m_PhysicsSystem->Sync();
+
+            // Simulation LOD is measured from what the player sees and hears
+            glm::vec3 viewers[] = { m_Renderer->GetCamera().GetPosition(), m_Audio->GetListenerPosition() };
+            m_Physics->SetLODViewers(viewers);
+
+            // Fixed timestep updates. The physics steps are queued and run together by the
+            // physics system, after scripts, overlapping with rendering.
             while (Time::ShouldRunFixedUpdate()) {
                 float fixedDt = Time::GetFixedDeltaTime();
                 OnFixedUpdate(fixedDt);
-                m_Physics->Step(fixedDt);
+                m_PhysicsSystem->QueueStep(fixedDt);
                 Time::ConsumeAccumulator(fixedDt);
             }
+            m_PhysicsSystem->SetQueuedAlpha(Time::GetInterpolationAlpha());
 
             // Variable timestep update
             OnUpdate(dt);
@@ -122,11 +152,30 @@ namespace Xi {
                 glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
                 glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+                // The editor can change any component
+                m_PhysicsSystem->Sync();
+
                 // Render ImGui
                 m_Editor->BeginFrame();
                 m_Editor->Render(*m_World, *m_Renderer, m_ScriptSystem, m_ScriptEngine.get());
                 OnImGui();
                 m_Editor->EndFrame();
+            } else if (m_RenderThread) {
+                // Build the frame here; the render thread clears, draws and presents it
+                m_Renderer->BeginFrame();
+                m_World->Render(*m_Renderer);
+                OnRender();
+
+                // Waits while the render thread is maxFrameLatency frames behind
+                FramePacket& packet = m_RenderThread->AcquirePacket();
+                m_Renderer->EndFrame(packet);
+
+                int windowWidth, windowHeight;
+                glfwGetFramebufferSize(m_Window->GetNativeWindow(), &windowWidth, &windowHeight);
+                packet.targetWidth = static_cast<uint32_t>(windowWidth);
+                packet.targetHeight = static_cast<uint32_t>(windowHeight);
+                packet.clearColor = glm::vec4(0.1f, 0.1f, 0.1f, 1.0f);
+                m_RenderThread->SubmitPacket(packet);
             } else {
                 // Non-editor mode: render directly to screen
                 glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
@@ -138,13 +187,25 @@ namespace Xi {
                 m_Renderer->EndFrame();
             }
 
-            m_Window->SwapBuffers();
+            if (!m_RenderThread) {
+                m_Window->SwapBuffers();
+            }
         }
     }
 
     void Application::Shutdown() {
         XI_LOG_INFO("Xi Engine shutting down...");
 
+        if (m_PhysicsSystem) {
+            m_PhysicsSystem->Sync();
+        }
+
+        // Draws the frames still queued and gives the context back to this thread
+        if (m_RenderThread) {
+            m_RenderThread->Stop();
+            m_RenderThread.reset();
+        }
+
         OnShutdown();
 
         // Stop scripts before shutdown
@@ -170,6 +231,7 @@ namespace Xi {
         m_Audio.reset();
         m_Editor.reset();
         m_ScriptEngine.reset();
+        m_JobSystem.reset();
 
         Input::Shutdown();
         m_Window->Shutdown();
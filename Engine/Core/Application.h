@@ -1,13 +1,17 @@
 #pragma once
 
 #include "Window.h"
+#include <cstdint>
 #include <memory>
 
 namespace Xi {
 
+    class JobSystem;
     class World;
     class Renderer;
+    class RenderThread;
     class PhysicsWorld;
+    class PhysicsSystem;
     class AudioEngine;
     class EditorUI;
     class ScriptEngine;
@@ -25,13 +29,24 @@ namespace Xi {
         World& GetWorld() { return *m_World; }
         Renderer& GetRenderer() { return *m_Renderer; }
         PhysicsWorld& GetPhysics() { return *m_Physics; }
+        PhysicsSystem& GetPhysicsSystem() { return *m_PhysicsSystem; }
         AudioEngine& GetAudio() { return *m_Audio; }
+        JobSystem& GetJobSystem() { return *m_JobSystem; }
 
         static Application& Get() { return *s_Instance; }
 
         bool IsEditorMode() const { return m_EditorMode; }
         void SetEditorMode(bool enabled) { m_EditorMode = enabled; }
 
+        // Draws on a render thread that owns the GL context, with the game thread up to
+        // maxFrameLatency frames ahead. Set before Run. Not used in editor mode, where ImGui
+        // draws on the main thread.
+        void SetRenderThreadEnabled(bool enabled, uint32_t maxFrameLatency = 2) {
+            m_RenderThreadEnabled = enabled;
+            m_MaxFrameLatency = maxFrameLatency;
+        }
+        bool IsRenderThreadEnabled() const { return m_RenderThreadEnabled; }
+
     protected:
         virtual void OnInit() {}
         virtual void OnUpdate(float dt) { (void)dt; }
@@ -46,16 +61,21 @@ namespace Xi {
         void Shutdown();
 
         std::unique_ptr<Window> m_Window;
+        std::unique_ptr<JobSystem> m_JobSystem;
         std::unique_ptr<World> m_World;
         std::unique_ptr<Renderer> m_Renderer;
+        std::unique_ptr<RenderThread> m_RenderThread;
         std::unique_ptr<PhysicsWorld> m_Physics;
         std::unique_ptr<AudioEngine> m_Audio;
         std::unique_ptr<EditorUI> m_Editor;
         std::unique_ptr<ScriptEngine> m_ScriptEngine;
         ScriptSystem* m_ScriptSystem = nullptr;
+        PhysicsSystem* m_PhysicsSystem = nullptr;
 
         bool m_Running = true;
         bool m_EditorMode = true;
+        bool m_RenderThreadEnabled = false;
+        uint32_t m_MaxFrameLatency = 2;
 
         static Application* s_Instance;
     };
@@ -0,0 +1,98 @@
+#include "JobSystem.h"
+#include "Log.h"
+
+#include <algorithm>
+
+namespace Xi {
+
+    JobSystem::JobSystem(uint32_t workerCount) {
+        if (workerCount == 0) {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        m_Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++) {
+            m_Workers.emplace_back(&JobSystem::WorkerLoop, this);
+        }
+
+        XI_LOG_INFO("Job system started with " + std::to_string(workerCount) + " worker threads");
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Quit = true;
+        }
+        m_WorkReady.notify_all();
+
+        for (std::thread& worker : m_Workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const JobRangeFunc& func) {
+        if (count == 0) return;
+        batchSize = std::max(batchSize, 1u);
+
+        std::lock_guard<std::mutex> submitLock(m_SubmitMutex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Func = &func;
+            m_Count = count;
+            m_BatchSize = batchSize;
+            m_BatchCount = (count + batchSize - 1) / batchSize;
+            m_NextBatch.store(0, std::memory_order_relaxed);
+            m_FinishedBatches.store(0, std::memory_order_relaxed);
+            m_Generation++;
+        }
+        m_WorkReady.notify_all();
+
+        RunBatches();
+
+        // Wait for stragglers so func and the job state outlive every batch
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_WorkDone.wait(lock, [this] {
+            return m_FinishedBatches.load(std::memory_order_acquire) == m_BatchCount && m_ActiveWorkers == 0;
+        });
+        m_Func = nullptr;
+    }
+
+    void JobSystem::WorkerLoop() {
+        uint64_t seenGeneration = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WorkReady.wait(lock, [&] { return m_Quit || (m_Func && m_Generation != seenGeneration); });
+                if (m_Quit) return;
+
+                seenGeneration = m_Generation;
+                m_ActiveWorkers++;
+            }
+
+            RunBatches();
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_ActiveWorkers--;
+            }
+            m_WorkDone.notify_all();
+        }
+    }
+
+    void JobSystem::RunBatches() {
+        while (true) {
+            uint32_t batch = m_NextBatch.fetch_add(1, std::memory_order_relaxed);
+            if (batch >= m_BatchCount) break;
+
+            uint32_t begin = batch * m_BatchSize;
+            uint32_t end = std::min(begin + m_BatchSize, m_Count);
+            (*m_Func)(begin, end);
+
+            m_FinishedBatches.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Xi {
+
+    // Called with a half-open range [begin, end) of item indices
+    using JobRangeFunc = std::function<void(uint32_t begin, uint32_t end)>;
+
+    // Fixed pool of worker threads that split index ranges into batches.
+    // The calling thread helps out and blocks until every batch has run, so
+    // jobs must not call ParallelFor themselves. Calls from different threads
+    // take turns, one ParallelFor runs at a time.
+    class JobSystem {
+    public:
+        // workerCount of 0 picks hardware_concurrency - 1 (the caller is the extra thread)
+        explicit JobSystem(uint32_t workerCount = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // Runs func over [0, count) in batches of batchSize. Batch boundaries only depend
+        // on count and batchSize, never on the number of threads.
+        void ParallelFor(uint32_t count, uint32_t batchSize, const JobRangeFunc& func);
+
+        uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+        uint32_t GetThreadCount() const { return GetWorkerCount() + 1; }
+
+    private:
+        void WorkerLoop();
+        void RunBatches();
+
+        std::vector<std::thread> m_Workers;
+
+        std::mutex m_SubmitMutex;  // Held by the calling thread for a whole ParallelFor
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkReady;
+        std::condition_variable m_WorkDone;
+        uint64_t m_Generation = 0;
+        bool m_Quit = false;
+
+        // Current job, only valid while a ParallelFor is running
+        const JobRangeFunc* m_Func = nullptr;
+        uint32_t m_Count = 0;
+        uint32_t m_BatchSize = 1;
+        uint32_t m_BatchCount = 0;
+        std::atomic<uint32_t> m_NextBatch{ 0 };
+        std::atomic<uint32_t> m_FinishedBatches{ 0 };
+        uint32_t m_ActiveWorkers = 0;
+    };
+
+    // Runs func over [0, count) on the job system, or inline when there is none
+    inline void ParallelFor(JobSystem* jobs, uint32_t count, uint32_t batchSize, const JobRangeFunc& func) {
+        if (count == 0) return;
+        if (jobs && count > batchSize) {
+            jobs->ParallelFor(count, batchSize, func);
+        } else {
+            func(0, count);
+        }
+    }
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#include <cstdint>
+
+// Functions using AVX2 intrinsics are tagged with XI_TARGET_AVX2 so the rest of the
+// engine can be built for baseline x64. Only call them when Simd::HasAVX2() is true.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define XI_TARGET_AVX2
+#else
+#define XI_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace Xi {
+
+    namespace Simd {
+
+        // Checked once; also requires the OS to save YMM registers
+        inline bool HasAVX2() {
+            static const bool supported = [] {
+#if defined(_MSC_VER)
+                int info[4];
+                __cpuid(info, 0);
+                if (info[0] < 7) return false;
+
+                __cpuid(info, 1);
+                bool osxsave = (info[2] & (1 << 27)) != 0;
+                bool avx = (info[2] & (1 << 28)) != 0;
+                if (!osxsave || !avx) return false;
+                if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+                __cpuidex(info, 7, 0);
+                return (info[1] & (1 << 5)) != 0;
+#else
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") != 0;
+#endif
+            }();
+            return supported;
+        }
+
+        // Width of the AVX2 float lanes; SoA buffers are padded to a multiple of this
+        constexpr uint32_t LANES = 8;
+
+        inline uint32_t PadToLanes(uint32_t count) {
+            return (count + LANES - 1) & ~(LANES - 1);
+        }
+
+    }
+
+}
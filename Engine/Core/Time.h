@@ -22,6 +22,12 @@ namespace Xi {
         static void ConsumeAccumulator(float dt) { s_Accumulator -= dt; }
         static bool ShouldRunFixedUpdate() { return s_Accumulator >= s_FixedDeltaTime; }
 
+        // How far rendering is between the last two fixed updates, 0 to 1
+        static float GetInterpolationAlpha() {
+            float alpha = s_Accumulator / s_FixedDeltaTime;
+            return alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+        }
+
     private:
         using Clock = std::chrono::high_resolution_clock;
         using TimePoint = std::chrono::time_point<Clock>;
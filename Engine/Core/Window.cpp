@@ -130,6 +130,14 @@ namespace Xi {
         glfwSetWindowShouldClose(m_Window, close ? GLFW_TRUE : GLFW_FALSE);
     }
 
+    void Window::MakeContextCurrent() {
+        glfwMakeContextCurrent(m_Window);
+    }
+
+    void Window::ReleaseContext() {
+        glfwMakeContextCurrent(nullptr);
+    }
+
     void Window::SetVSync(bool enabled) {
         m_VSync = enabled;
         glfwSwapInterval(enabled ? 1 : 0);
@@ -143,7 +151,11 @@ namespace Xi {
     void Window::OnResize(int width, int height) {
         m_Width = width;
         m_Height = height;
-        glViewport(0, 0, width, height);
+
+        // With a render thread the context is current there, and frame packets carry the size
+        if (glfwGetCurrentContext() == m_Window) {
+            glViewport(0, 0, width, height);
+        }
 
         if (m_ResizeCallback) {
             m_ResizeCallback(width, height);
@@ -29,6 +29,11 @@ namespace Xi {
         void PollEvents();
         void SwapBuffers();
 
+        // The GL context is current on one thread at a time; a render thread takes it over.
+        // SwapBuffers has to run where it is current.
+        void MakeContextCurrent();
+        static void ReleaseContext();  // From the calling thread
+
         bool ShouldClose() const;
         void SetShouldClose(bool close);
 
@@ -38,6 +43,7 @@ namespace Xi {
 
         GLFWwindow* GetNativeWindow() const { return m_Window; }
 
+        // Needs the context current on the calling thread
         void SetVSync(bool enabled);
         bool IsVSync() const { return m_VSync; }
 
@@ -32,6 +32,7 @@ namespace Xi {
             m_Components.emplace_back();
             m_Entities.push_back(entity);
             m_EntityToIndex[entity] = index;
+            m_Version++;
             return m_Components.back();
         }
 
@@ -64,12 +65,14 @@ namespace Xi {
             m_Components.pop_back();
             m_Entities.pop_back();
             m_EntityToIndex.erase(entity);
+            m_Version++;
         }
 
         void Clear() override {
             m_Components.clear();
             m_Entities.clear();
             m_EntityToIndex.clear();
+            m_Version++;
         }
 
         // Iteration support
@@ -80,10 +83,15 @@ namespace Xi {
 
         size_t Size() const { return m_Components.size(); }
 
+        // Changes whenever an entity is added or removed, which may also move the components
+        // in memory. Anything holding component pointers refreshes them when it changes.
+        uint32_t GetVersion() const { return m_Version; }
+
     private:
         std::vector<T> m_Components;
         std::vector<Entity> m_Entities;
         std::unordered_map<Entity, size_t> m_EntityToIndex;
+        uint32_t m_Version = 0;
     };
 
 }
@@ -1,13 +1,19 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <memory>
 
 namespace Xi {
 
+    class TriangleMesh;
+    class Heightfield;
+
     enum class ColliderType {
         Box,
         Sphere,
-        Capsule
+        Capsule,
+        Mesh,
+        Heightfield
     };
 
     struct Collider {
@@ -24,13 +30,19 @@ namespace Xi {
         float height = 1.0f;
         // radius is shared with sphere
 
+        // Mesh and heightfield colliders, for static level geometry. The shape data is
+        // shared between colliders and scaled by the transform.
+        std::shared_ptr<TriangleMesh> triangleMesh;
+        std::shared_ptr<Heightfield> heightfield;
+
         bool isTrigger = false;
 
         // Physics layer for collision filtering
         uint32_t layer = 0;
         uint32_t mask = 0xFFFFFFFF;
 
-        // Computed AABB (world space)
+        // Computed AABB (world space), primitive shapes only - mesh and heightfield
+        // bounds come from their shape data
         glm::vec3 GetAABBMin(const glm::vec3& position, const glm::vec3& scale) const {
             glm::vec3 worldCenter = position + center;
             if (type == ColliderType::Box) {
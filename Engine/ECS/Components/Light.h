@@ -16,8 +16,8 @@ namespace Xi {
         float intensity = 1.0f;
 
         // Point/Spot light properties
-        float range = 10.0f;
-        float attenuation = 1.0f;
+        float range = 10.0f;        // Light fades to nothing here
+        float attenuation = 1.0f;   // Inverse-square falloff: intensity / (1 + attenuation * distance^2)
 
         // Spot light properties
         float innerAngle = 30.0f;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstdint>
 
 namespace Xi {
 
@@ -31,6 +32,9 @@ namespace Xi {
         bool freezeRotationY = false;
         bool freezeRotationZ = false;
 
+        // Sweep fast motion so the body can't pass through thin colliders
+        bool isBullet = false;
+
         // Physics material properties
         float friction = 0.5f;
         float bounciness = 0.0f;
@@ -39,18 +43,39 @@ namespace Xi {
         glm::vec3 force = glm::vec3(0.0f);
         glm::vec3 torque = glm::vec3(0.0f);
 
+        // Sleeping (managed by PhysicsWorld)
+        bool canSleep = true;
+        bool isSleeping = false;
+        float sleepTimer = 0.0f;
+
+        // Simulation level of detail (managed by PhysicsWorld). The body steps once every
+        // 2^lodLevel steps; waking it up brings it back to full rate for a while.
+        uint32_t lodLevel = 0;
+        uint32_t lodSkippedSteps = 0;  // Steps missed since it last stepped
+        float lodHoldTimer = 0.0f;     // Seconds left at full rate after a promotion
+        bool lodPromoted = false;
+
         void AddForce(const glm::vec3& f) {
             force += f;
+            WakeUp();
         }
 
         void AddImpulse(const glm::vec3& impulse) {
             if (mass > 0.0f) {
                 velocity += impulse / mass;
+                WakeUp();
             }
         }
 
         void AddTorque(const glm::vec3& t) {
             torque += t;
+            WakeUp();
+        }
+
+        void WakeUp() {
+            isSleeping = false;
+            sleepTimer = 0.0f;
+            lodPromoted = true;
         }
     };
 
@@ -1,5 +1,6 @@
 #include "World.h"
 #include "../Core/Log.h"
+#include "../Physics/PhysicsSystem.h"
 
 namespace Xi {
 
@@ -108,8 +109,7 @@ namespace Xi {
 
     void World::RegisterDefaultSystems(Renderer& renderer, PhysicsWorld& physics) {
         (void)renderer;
-        (void)physics;
-        // Systems will be added after component definitions
+        AddSystem<PhysicsSystem>(&physics);
     }
 
     void World::Update(float dt) {
@@ -166,6 +166,7 @@ namespace Xi {
         m_EntityMasks.clear();
         m_EntitiesToDestroy.clear();
         m_NextEntityID = 0;
+        m_ClearCount++;
     }
 
 }
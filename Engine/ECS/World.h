@@ -124,6 +124,17 @@ namespace Xi {
             return ptr;
         }
 
+        // First registered system of type T, or nullptr
+        template<typename T>
+        T* GetSystem() const {
+            for (const auto& system : m_Systems) {
+                if (T* ptr = dynamic_cast<T*>(system.get())) {
+                    return ptr;
+                }
+            }
+            return nullptr;
+        }
+
         void RegisterDefaultSystems(Renderer& renderer, PhysicsWorld& physics);
 
         // Update all systems
@@ -136,6 +147,10 @@ namespace Xi {
 
         void Clear();
 
+        // Bumped by Clear. Entity IDs start over after a clear, so anything kept per entity
+        // outside the world is stale once this changes.
+        uint32_t GetClearCount() const { return m_ClearCount; }
+
     private:
         template<typename T>
         void EnsureComponentPool(ComponentTypeID typeID) {
@@ -148,6 +163,7 @@ namespace Xi {
         }
 
         Entity m_NextEntityID = 0;
+        uint32_t m_ClearCount = 0;
         std::unordered_map<Entity, EntityInfo> m_EntityInfo;
         std::unordered_map<Entity, ComponentMask> m_EntityMasks;
         std::vector<std::unique_ptr<ComponentPoolBase>> m_ComponentPools;
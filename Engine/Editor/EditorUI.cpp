@@ -120,7 +120,7 @@ namespace Xi {
         }
 
         if (m_ShowStats) {
-            DrawStats();
+            DrawStats(renderer);
         }
 
         if (m_ShowScriptEditor) {
@@ -333,7 +333,7 @@ namespace Xi {
         ImGui::End();
     }
 
-    void EditorUI::DrawStats() {
+    void EditorUI::DrawStats(const Renderer& renderer) {
         ImGui::Begin("Stats");
 
         ImGui::Text("FPS: %d", Time::GetFPS());
@@ -342,6 +342,20 @@ namespace Xi {
 
         ImGui::Separator();
 
+        const Renderer::Stats& stats = renderer.GetStats();
+        ImGui::Text("Draw Calls: %u", stats.drawCalls);
+        ImGui::Text("Instanced: %u calls, %u objects", stats.instancedDrawCalls, stats.instancedObjects);
+        ImGui::Text("Triangles: %u", stats.triangles);
+        ImGui::Text("Visible: %u  Culled: %u", stats.visibleObjects, stats.culledObjects);
+        ImGui::Text("Cull %.3f  Sort %.3f  Batch %.3f  Lights %.3f  Submit %.3f ms",
+                    stats.cullTimeMs, stats.sortTimeMs, stats.batchTimeMs, stats.lightTimeMs, stats.submitTimeMs);
+        ImGui::Text("Lights: %u  Clustered: %u  Cluster Entries: %u",
+                    stats.lights, stats.clusteredLights, stats.lightAssignments);
+        ImGui::Text("Material Binds: %u", stats.materialBinds);
+        ImGui::Text("State Changes: %u  Avoided: %u", stats.stateChanges, stats.stateChangesAvoided);
+
+        ImGui::Separator();
+
         ImGui::Text("Camera Position: (%.1f, %.1f, %.1f)",
             m_EditorCamera.GetPosition().x,
             m_EditorCamera.GetPosition().y,
@@ -52,7 +52,7 @@ namespace Xi {
         void SetupImGuiStyle();
         void DrawMenuBar(World& world);
         void DrawToolbar(World& world, ScriptSystem* scriptSystem);
-        void DrawStats();
+        void DrawStats(const Renderer& renderer);
         void UpdateEditorCamera(float dt);
 
         SceneHierarchy m_Hierarchy;
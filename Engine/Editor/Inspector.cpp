@@ -11,6 +11,8 @@
 #include "../ECS/Components/AudioSource.h"
 #include "../ECS/Components/Script.h"
 #include "../Renderer/Material.h"
+#include "../Physics/TriangleMesh.h"
+#include "../Physics/Heightfield.h"
 
 #include <imgui.h>
 #include <glm/glm.hpp>
@@ -209,10 +211,33 @@ namespace Xi {
         if (ImGui::CollapsingHeader("Collider", ImGuiTreeNodeFlags_DefaultOpen)) {
             Collider& col = world.GetComponent<Collider>(entity);
 
-            const char* colliderTypes[] = { "Box", "Sphere", "Capsule" };
-            int currentType = static_cast<int>(col.type);
-            if (ImGui::Combo("Type##Collider", &currentType, colliderTypes, 3)) {
-                col.type = static_cast<ColliderType>(currentType);
+            // Mesh and heightfield colliders need shape data. Meshes can be built from the mesh
+            // renderer and heightfields are only made in code, so those types are only offered
+            // when there is data to use.
+            const MeshRenderer* meshRenderer = world.HasComponent<MeshRenderer>(entity) ? &world.GetComponent<MeshRenderer>(entity) : nullptr;
+            bool canBuildMesh = meshRenderer && meshRenderer->mesh;
+
+            const char* typeNames[5];
+            ColliderType types[5];
+            int typeCount = 0;
+            int currentType = 0;
+            auto offerType = [&](ColliderType type, const char* name) {
+                if (type == col.type) currentType = typeCount;
+                types[typeCount] = type;
+                typeNames[typeCount++] = name;
+            };
+
+            offerType(ColliderType::Box, "Box");
+            offerType(ColliderType::Sphere, "Sphere");
+            offerType(ColliderType::Capsule, "Capsule");
+            if (col.triangleMesh || canBuildMesh || col.type == ColliderType::Mesh) offerType(ColliderType::Mesh, "Mesh");
+            if (col.heightfield || col.type == ColliderType::Heightfield) offerType(ColliderType::Heightfield, "Heightfield");
+
+            if (ImGui::Combo("Type##Collider", &currentType, typeNames, typeCount)) {
+                col.type = types[currentType];
+                if (col.type == ColliderType::Mesh && !col.triangleMesh && canBuildMesh) {
+                    col.triangleMesh = std::make_shared<TriangleMesh>(*meshRenderer->mesh);
+                }
             }
 
             ImGui::DragFloat3("Center", glm::value_ptr(col.center), 0.1f);
@@ -224,6 +249,22 @@ namespace Xi {
             } else if (col.type == ColliderType::Capsule) {
                 ImGui::DragFloat("Radius##Capsule", &col.radius, 0.1f, 0.001f);
                 ImGui::DragFloat("Height", &col.height, 0.1f, 0.001f);
+            } else if (col.type == ColliderType::Mesh) {
+                if (col.triangleMesh) {
+                    ImGui::Text("Triangles: %u (%u BVH nodes)", col.triangleMesh->GetTriangleCount(), col.triangleMesh->GetNodeCount());
+                } else {
+                    ImGui::TextDisabled("No triangle mesh");
+                }
+
+                if (canBuildMesh && ImGui::Button("Build From Mesh Renderer")) {
+                    col.triangleMesh = std::make_shared<TriangleMesh>(*meshRenderer->mesh);
+                }
+            } else if (col.type == ColliderType::Heightfield) {
+                if (col.heightfield) {
+                    ImGui::Text("Samples: %u x %u", col.heightfield->GetColumns(), col.heightfield->GetRows());
+                } else {
+                    ImGui::TextDisabled("No heightfield");
+                }
             }
 
             ImGui::Checkbox("Is Trigger", &col.isTrigger);
@@ -251,6 +292,7 @@ namespace Xi {
                 ImGui::DragFloat("Drag", &rb.drag, 0.01f, 0.0f, 10.0f);
                 ImGui::DragFloat("Angular Drag", &rb.angularDrag, 0.01f, 0.0f, 10.0f);
                 ImGui::Checkbox("Use Gravity", &rb.useGravity);
+                ImGui::Checkbox("Continuous Collision", &rb.isBullet);
             }
 
             ImGui::DragFloat("Friction", &rb.friction, 0.01f, 0.0f, 1.0f);
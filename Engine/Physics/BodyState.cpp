@@ -0,0 +1,138 @@
+#include "BodyState.h"
+#include "../Core/Simd.h"
+
+#include <algorithm>
+
+namespace Xi {
+
+    void BodyState::Resize(uint32_t bodyCount) {
+        // Slots past the old count may hold bodies removed since, so they are cleared first
+        uint32_t kept = glm::min(count, bodyCount);
+        for (std::vector<float>* array : GetArrays()) {
+            array->resize(kept);
+        }
+        flags.resize(kept);
+
+        count = bodyCount;
+        capacity = Simd::PadToLanes(bodyCount);
+
+        for (std::vector<float>* array : GetArrays()) {
+            array->resize(capacity, 0.0f);
+        }
+        flags.resize(capacity, 0);
+    }
+
+    void BodyState::Move(uint32_t from, uint32_t to) {
+        for (std::vector<float>* array : GetArrays()) {
+            (*array)[to] = (*array)[from];
+        }
+        flags[to] = flags[from];
+    }
+
+    void BodyState::ClearPseudoVelocities() {
+        std::fill(pseudoX.begin(), pseudoX.end(), 0.0f);
+        std::fill(pseudoY.begin(), pseudoY.end(), 0.0f);
+        std::fill(pseudoZ.begin(), pseudoZ.end(), 0.0f);
+    }
+
+    // Scalar and AVX2 kernels use the same operation order (no FMA) so they give
+    // bit-identical results and a replay doesn't depend on the CPU it runs on.
+
+    static void IntegrateVelocitiesScalar(BodyState& s) {
+        for (uint32_t i = 0; i < s.count; i++) {
+            if (!(s.flags[i] & BODY_INTEGRATE_VELOCITY)) continue;
+
+            float dt = s.timeStep[i];
+            float ax = s.forceX[i] * s.invMass[i] + s.accX[i];
+            float ay = s.forceY[i] * s.invMass[i] + s.accY[i];
+            float az = s.forceZ[i] * s.invMass[i] + s.accZ[i];
+
+            s.velX[i] = (s.velX[i] + ax * dt) * s.damping[i];
+            s.velY[i] = (s.velY[i] + ay * dt) * s.damping[i];
+            s.velZ[i] = (s.velZ[i] + az * dt) * s.damping[i];
+        }
+    }
+
+    static void IntegratePositionsScalar(BodyState& s) {
+        for (uint32_t i = 0; i < s.count; i++) {
+            uint32_t f = s.flags[i];
+            if (!(f & BODY_INTEGRATE_POSITION)) continue;
+
+            float dt = s.timeStep[i];
+            if (f & BODY_MOVE_X) s.posX[i] = s.posX[i] + (s.velX[i] + s.pseudoX[i]) * dt;
+            if (f & BODY_MOVE_Y) s.posY[i] = s.posY[i] + (s.velY[i] + s.pseudoY[i]) * dt;
+            if (f & BODY_MOVE_Z) s.posZ[i] = s.posZ[i] + (s.velZ[i] + s.pseudoZ[i]) * dt;
+        }
+    }
+
+    XI_TARGET_AVX2
+    static __m256 FlagMask(__m256i flags, uint32_t bit) {
+        __m256i b = _mm256_set1_epi32(static_cast<int>(bit));
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(flags, b), b));
+    }
+
+    XI_TARGET_AVX2
+    static void IntegrateVelocityLanes(float* vel, const float* force, const float* acc,
+                                       __m256 invMass, __m256 damping, __m256 dt, __m256 active) {
+        __m256 v = _mm256_loadu_ps(vel);
+        __m256 a = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(force), invMass), _mm256_loadu_ps(acc));
+        __m256 result = _mm256_mul_ps(_mm256_add_ps(v, _mm256_mul_ps(a, dt)), damping);
+        _mm256_storeu_ps(vel, _mm256_blendv_ps(v, result, active));
+    }
+
+    XI_TARGET_AVX2
+    static void IntegratePositionLanes(float* pos, const float* vel, const float* pseudo, __m256 dt, __m256 active) {
+        __m256 p = _mm256_loadu_ps(pos);
+        __m256 v = _mm256_add_ps(_mm256_loadu_ps(vel), _mm256_loadu_ps(pseudo));
+        __m256 result = _mm256_add_ps(p, _mm256_mul_ps(v, dt));
+        _mm256_storeu_ps(pos, _mm256_blendv_ps(p, result, active));
+    }
+
+    XI_TARGET_AVX2
+    static void IntegrateVelocitiesAVX2(BodyState& s) {
+        for (uint32_t i = 0; i < s.capacity; i += Simd::LANES) {
+            __m256i flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s.flags[i]));
+            __m256 active = FlagMask(flags, BODY_INTEGRATE_VELOCITY);
+            if (_mm256_movemask_ps(active) == 0) continue;
+
+            __m256 invMass = _mm256_loadu_ps(&s.invMass[i]);
+            __m256 damping = _mm256_loadu_ps(&s.damping[i]);
+            __m256 vdt = _mm256_loadu_ps(&s.timeStep[i]);
+
+            IntegrateVelocityLanes(&s.velX[i], &s.forceX[i], &s.accX[i], invMass, damping, vdt, active);
+            IntegrateVelocityLanes(&s.velY[i], &s.forceY[i], &s.accY[i], invMass, damping, vdt, active);
+            IntegrateVelocityLanes(&s.velZ[i], &s.forceZ[i], &s.accZ[i], invMass, damping, vdt, active);
+        }
+    }
+
+    XI_TARGET_AVX2
+    static void IntegratePositionsAVX2(BodyState& s) {
+        for (uint32_t i = 0; i < s.capacity; i += Simd::LANES) {
+            __m256i flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s.flags[i]));
+            __m256 active = FlagMask(flags, BODY_INTEGRATE_POSITION);
+            if (_mm256_movemask_ps(active) == 0) continue;
+
+            __m256 vdt = _mm256_loadu_ps(&s.timeStep[i]);
+            IntegratePositionLanes(&s.posX[i], &s.velX[i], &s.pseudoX[i], vdt, _mm256_and_ps(active, FlagMask(flags, BODY_MOVE_X)));
+            IntegratePositionLanes(&s.posY[i], &s.velY[i], &s.pseudoY[i], vdt, _mm256_and_ps(active, FlagMask(flags, BODY_MOVE_Y)));
+            IntegratePositionLanes(&s.posZ[i], &s.velZ[i], &s.pseudoZ[i], vdt, _mm256_and_ps(active, FlagMask(flags, BODY_MOVE_Z)));
+        }
+    }
+
+    void BodyState::IntegrateVelocities() {
+        if (Simd::HasAVX2()) {
+            IntegrateVelocitiesAVX2(*this);
+        } else {
+            IntegrateVelocitiesScalar(*this);
+        }
+    }
+
+    void BodyState::IntegratePositions() {
+        if (Simd::HasAVX2()) {
+            IntegratePositionsAVX2(*this);
+        } else {
+            IntegratePositionsScalar(*this);
+        }
+    }
+
+}
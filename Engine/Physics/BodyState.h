@@ -0,0 +1,67 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Xi {
+
+    // Per-body flags packed for the integration kernels
+    enum BodyStateFlags : uint32_t {
+        BODY_INTEGRATE_VELOCITY = 1 << 0,  // Awake dynamic body with mass
+        BODY_INTEGRATE_POSITION = 1 << 1,  // Awake dynamic or kinematic body
+        BODY_MOVE_X = 1 << 2,              // Position axis not frozen
+        BODY_MOVE_Y = 1 << 3,
+        BODY_MOVE_Z = 1 << 4
+    };
+
+    // Hot linear state of every body in structure-of-arrays form, so the integrators
+    // stream through it without touching the cold RigidBody fields. Bodies keep their
+    // slot from step to step. Arrays are padded to a multiple of the SIMD width with
+    // inert bodies.
+    struct BodyState {
+        uint32_t count = 0;     // Real bodies
+        uint32_t capacity = 0;  // Padded array length
+
+        // Sets count and pads to the SIMD width. Bodies below the old count keep their
+        // state, new ones start zeroed.
+        void Resize(uint32_t bodyCount);
+
+        // Copies a body into another slot, for filling the slot of a removed body
+        void Move(uint32_t from, uint32_t to);
+
+        void ClearPseudoVelocities();
+
+        void SetPosition(uint32_t i, const glm::vec3& p) { posX[i] = p.x; posY[i] = p.y; posZ[i] = p.z; }
+        void SetVelocity(uint32_t i, const glm::vec3& v) { velX[i] = v.x; velY[i] = v.y; velZ[i] = v.z; }
+        void SetPseudoVelocity(uint32_t i, const glm::vec3& v) { pseudoX[i] = v.x; pseudoY[i] = v.y; pseudoZ[i] = v.z; }
+        void SetAcceleration(uint32_t i, const glm::vec3& a) { accX[i] = a.x; accY[i] = a.y; accZ[i] = a.z; }
+
+        glm::vec3 GetPosition(uint32_t i) const { return glm::vec3(posX[i], posY[i], posZ[i]); }
+        glm::vec3 GetVelocity(uint32_t i) const { return glm::vec3(velX[i], velY[i], velZ[i]); }
+
+        // v = (v + (force * invMass + gravity) * timeStep) * damping
+        void IntegrateVelocities();
+
+        // p += (v + pseudoVelocity) * timeStep on unfrozen axes
+        void IntegratePositions();
+
+        std::vector<float> posX, posY, posZ;
+        std::vector<float> velX, velY, velZ;
+        std::vector<float> pseudoX, pseudoY, pseudoZ;  // Split impulse correction
+        std::vector<float> forceX, forceY, forceZ;
+        std::vector<float> accX, accY, accZ;           // Gravity, or zero when disabled
+        std::vector<float> invMass;
+        std::vector<float> damping;                    // 1 - drag * timeStep
+        std::vector<float> timeStep;                   // The step, or several for bodies at a reduced rate
+        std::vector<uint32_t> flags;
+
+    private:
+        std::array<std::vector<float>*, 18> GetArrays() {
+            return { &posX, &posY, &posZ, &velX, &velY, &velZ, &pseudoX, &pseudoY, &pseudoZ,
+                     &forceX, &forceY, &forceZ, &accX, &accY, &accZ, &invMass, &damping, &timeStep };
+        }
+    };
+
+}
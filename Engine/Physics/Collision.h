@@ -10,7 +10,7 @@ namespace Xi {
         Entity entityB = INVALID_ENTITY;
 
         glm::vec3 contactPoint = glm::vec3(0.0f);
-        glm::vec3 contactNormal = glm::vec3(0.0f);
+        glm::vec3 contactNormal = glm::vec3(0.0f);  // Points from B towards A
         float penetrationDepth = 0.0f;
 
         bool isTrigger = false;
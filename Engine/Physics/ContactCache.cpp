@@ -0,0 +1,103 @@
+#include "ContactCache.h"
+
+#include <algorithm>
+
+namespace Xi {
+
+    void ContactEvents::Push(ContactEventType type, const CollisionInfo& info) {
+        std::vector<ContactEvent>& buffer = m_Buffers[info.isTrigger ? 1 : 0][static_cast<size_t>(type)];
+
+        ContactEvent event;
+        event.entity = info.entityA;
+        event.other = info.entityB;
+        event.point = info.contactPoint;
+        event.normal = info.contactNormal;
+        event.penetrationDepth = info.penetrationDepth;
+        buffer.push_back(event);
+
+        std::swap(event.entity, event.other);
+        event.normal = -event.normal;
+        buffer.push_back(event);
+    }
+
+    // Each entity pair has one cache entry, so (entity, other) is unique within a buffer and
+    // the order doesn't depend on the cache's hash map
+    void ContactEvents::Sort() {
+        for (auto& buffers : m_Buffers) {
+            for (std::vector<ContactEvent>& buffer : buffers) {
+                std::sort(buffer.begin(), buffer.end(), [](const ContactEvent& a, const ContactEvent& b) {
+                    return a.entity != b.entity ? a.entity < b.entity : a.other < b.other;
+                });
+            }
+        }
+    }
+
+    void ContactEvents::Clear() {
+        for (auto& buffers : m_Buffers) {
+            for (std::vector<ContactEvent>& buffer : buffers) {
+                buffer.clear();
+            }
+        }
+    }
+
+    size_t ContactEvents::GetEventCount() const {
+        size_t count = 0;
+        for (const auto& buffers : m_Buffers) {
+            for (const std::vector<ContactEvent>& buffer : buffers) {
+                count += buffer.size();
+            }
+        }
+        return count;
+    }
+
+    std::span<const ContactEvent> ContactEvents::Filter(std::span<const ContactEvent> events, Entity entity) {
+        auto begin = std::lower_bound(events.begin(), events.end(), entity,
+            [](const ContactEvent& event, Entity e) { return event.entity < e; });
+        auto end = std::upper_bound(begin, events.end(), entity,
+            [](Entity e, const ContactEvent& event) { return e < event.entity; });
+        return events.subspan(begin - events.begin(), end - begin);
+    }
+
+    ContactPair& ContactCache::Acquire(Entity a, Entity b) {
+        ContactPair& pair = m_Pairs[MakePairKey(a, b)];
+        if (pair.entityA == INVALID_ENTITY) {
+            pair.entityA = a;
+            pair.entityB = b;
+        }
+        pair.lastStep = m_Step;
+        return pair;
+    }
+
+    void ContactCache::Report(ContactPair& pair, bool touching, ContactEvents& events) {
+        // A collider switched to or from a trigger ends the old kind of contact and begins the new one
+        bool switched = touching && pair.touching && pair.info.isTrigger != pair.touchingTrigger;
+
+        if (switched || (!touching && pair.touching)) {
+            CollisionInfo ended = pair.info;
+            ended.isTrigger = pair.touchingTrigger;
+            events.Push(ContactEventType::End, ended);
+        }
+
+        if (touching && (!pair.touching || switched)) {
+            events.Push(ContactEventType::Begin, pair.info);
+        } else if (touching) {
+            events.Push(ContactEventType::Persist, pair.info);
+        }
+        pair.touching = touching;
+        pair.touchingTrigger = pair.info.isTrigger;
+    }
+
+    void ContactCache::EndStep(ContactEvents& events) {
+        for (auto it = m_Pairs.begin(); it != m_Pairs.end();) {
+            if (it->second.lastStep != m_Step) {
+                if (it->second.touching) {
+                    events.Push(ContactEventType::End, it->second.info);
+                }
+                it = m_Pairs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+}
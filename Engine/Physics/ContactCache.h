@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Collision.h"
+#include "Narrowphase.h"
+#include "../ECS/Entity.h"
+#include <glm/glm.hpp>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Xi {
+
+    // Order-independent key for an entity pair
+    inline uint64_t MakePairKey(Entity a, Entity b) {
+        if (a > b) std::swap(a, b);
+        return (static_cast<uint64_t>(a) << 32) | static_cast<uint64_t>(b);
+    }
+
+    // The collider fields a narrowphase result depends on
+    struct ColliderSnapshot {
+        ColliderType type = ColliderType::Box;
+        glm::vec3 center = glm::vec3(0.0f);
+        glm::vec3 size = glm::vec3(1.0f);
+        float radius = 0.5f;
+        float height = 1.0f;
+        const TriangleMesh* triangleMesh = nullptr;
+        const Heightfield* heightfield = nullptr;
+        bool isTrigger = false;
+
+        bool operator==(const ColliderSnapshot&) const = default;
+    };
+
+    // Pose and shape snapshot taken when a pair last ran full narrowphase
+    struct ContactSnapshot {
+        glm::vec3 positionA = glm::vec3(0.0f);
+        glm::vec3 rotationA = glm::vec3(0.0f);
+        glm::vec3 scaleA = glm::vec3(1.0f);
+        glm::vec3 positionB = glm::vec3(0.0f);
+        glm::vec3 rotationB = glm::vec3(0.0f);
+        glm::vec3 scaleB = glm::vec3(1.0f);
+        ColliderSnapshot colliderA;
+        ColliderSnapshot colliderB;
+    };
+
+    // Persistent state for an entity pair whose bounds overlapped
+    struct ContactPair {
+        Entity entityA = INVALID_ENTITY;
+        Entity entityB = INVALID_ENTITY;
+
+        CollisionInfo info;
+        ContactManifold manifold;  // All contact points; info holds their center and deepest depth
+        ContactSnapshot snapshot;
+
+        // Solver impulses from the previous step, used for warm starting
+        float normalImpulse = 0.0f;
+        glm::vec3 frictionImpulse = glm::vec3(0.0f);  // World space, applied to A (negated for B)
+
+        bool touching = false;         // Narrowphase reported contact this step
+        bool touchingTrigger = false;  // That contact was reported as a trigger
+        bool hasSnapshot = false;      // Snapshot/info can be reused
+        uint32_t lastStep = 0;         // Step the pair was last seen by the broadphase
+    };
+
+    enum class ContactEventType {
+        Begin,
+        Persist,
+        End
+    };
+
+    // One side of a contact. Every contact is recorded once for each of its two entities,
+    // so all of an entity's events sit next to each other in a sorted buffer.
+    struct ContactEvent {
+        Entity entity = INVALID_ENTITY;
+        Entity other = INVALID_ENTITY;
+        glm::vec3 point = glm::vec3(0.0f);
+        glm::vec3 normal = glm::vec3(0.0f);  // Points from other towards entity
+        float penetrationDepth = 0.0f;
+    };
+
+    // Contact events produced by the most recent step, in contiguous buffers sorted by
+    // entity then other entity. Read them as spans once the step is done.
+    class ContactEvents {
+    public:
+        std::span<const ContactEvent> GetCollisions(ContactEventType type) const { return GetBuffer(false, type); }
+        std::span<const ContactEvent> GetTriggers(ContactEventType type) const { return GetBuffer(true, type); }
+
+        // Only the events of one entity
+        std::span<const ContactEvent> GetCollisions(ContactEventType type, Entity entity) const { return Filter(GetBuffer(false, type), entity); }
+        std::span<const ContactEvent> GetTriggers(ContactEventType type, Entity entity) const { return Filter(GetBuffer(true, type), entity); }
+
+        size_t GetEventCount() const;
+
+        void Push(ContactEventType type, const CollisionInfo& info);
+        void Sort();
+        void Clear();
+
+    private:
+        static constexpr size_t TYPE_COUNT = 3;
+
+        std::span<const ContactEvent> GetBuffer(bool trigger, ContactEventType type) const {
+            return m_Buffers[trigger ? 1 : 0][static_cast<size_t>(type)];
+        }
+
+        static std::span<const ContactEvent> Filter(std::span<const ContactEvent> events, Entity entity);
+
+        std::vector<ContactEvent> m_Buffers[2][TYPE_COUNT];  // [collision, trigger][type]
+    };
+
+    class ContactCache {
+    public:
+        void BeginStep() { m_Step++; }
+
+        // Returns the pair for (a, b), creating it if needed, and marks it as seen this step
+        ContactPair& Acquire(Entity a, Entity b);
+
+        // Records the narrowphase result for a pair and emits begin/persist/end events
+        void Report(ContactPair& pair, bool touching, ContactEvents& events);
+
+        // Drops pairs not seen this step and emits end events for those that were touching
+        void EndStep(ContactEvents& events);
+
+        void Clear() { m_Pairs.clear(); }
+
+        std::unordered_map<uint64_t, ContactPair>& GetPairs() { return m_Pairs; }
+        const std::unordered_map<uint64_t, ContactPair>& GetPairs() const { return m_Pairs; }
+        size_t Size() const { return m_Pairs.size(); }
+
+    private:
+        std::unordered_map<uint64_t, ContactPair> m_Pairs;
+        uint32_t m_Step = 0;
+    };
+
+}
@@ -0,0 +1,166 @@
+#include "ContactSolver.h"
+#include "ContactCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Xi {
+
+    static SolverBody& GetBody(std::vector<SolverBody>& bodies, uint32_t index, SolverBody& ground) {
+        return index != INVALID_BODY ? bodies[index] : ground;
+    }
+
+    static float EffectiveMass(const SolverBody& a, const SolverBody& b, const glm::vec3& direction) {
+        float k = a.invMass * glm::dot(direction, a.linearFactor * direction) +
+                  b.invMass * glm::dot(direction, b.linearFactor * direction);
+        return k > 0.0f ? 1.0f / k : 0.0f;
+    }
+
+    static void ApplyImpulse(SolverBody& a, SolverBody& b, const glm::vec3& impulse) {
+        // Bodies with infinite mass are shared between islands and must never be written
+        if (a.invMass > 0.0f) a.velocity += a.linearFactor * impulse * a.invMass;
+        if (b.invMass > 0.0f) b.velocity -= b.linearFactor * impulse * b.invMass;
+    }
+
+    static void ApplyPseudoImpulse(SolverBody& a, SolverBody& b, const glm::vec3& impulse) {
+        if (a.invMass > 0.0f) a.pseudoVelocity += a.linearFactor * impulse * a.invMass;
+        if (b.invMass > 0.0f) b.pseudoVelocity -= b.linearFactor * impulse * b.invMass;
+    }
+
+    static void ComputeBasis(const glm::vec3& normal, glm::vec3& tangent1, glm::vec3& tangent2) {
+        if (std::abs(normal.x) >= 0.57735f) {
+            tangent1 = glm::normalize(glm::vec3(normal.y, -normal.x, 0.0f));
+        } else {
+            tangent1 = glm::normalize(glm::vec3(0.0f, normal.z, -normal.y));
+        }
+        tangent2 = glm::cross(normal, tangent1);
+    }
+
+    void ContactSolver::PreStep(std::vector<SolverBody>& bodies, SolverContact& contact, float dt) const {
+        SolverBody ground;
+        SolverBody& a = GetBody(bodies, contact.bodyA, ground);
+        SolverBody& b = GetBody(bodies, contact.bodyB, ground);
+
+        ComputeBasis(contact.normal, contact.tangent1, contact.tangent2);
+
+        contact.normalMass = EffectiveMass(a, b, contact.normal);
+        contact.tangentMass1 = EffectiveMass(a, b, contact.tangent1);
+        contact.tangentMass2 = EffectiveMass(a, b, contact.tangent2);
+
+        // Restitution is based on the closing speed before any impulses are applied
+        float closingSpeed = glm::dot(a.velocity - b.velocity, contact.normal);
+        float bounce = (closingSpeed < -m_Settings.restitutionThreshold) ? -contact.restitution * closingSpeed : 0.0f;
+
+        if (contact.penetration < 0.0f) {
+            // Speculative contact: the bodies may close the gap this step but not pass through it
+            float speculative = contact.penetration / dt;
+            contact.velocityBias = (closingSpeed < speculative) ? std::max(speculative, bounce) : speculative;
+        } else {
+            contact.velocityBias = bounce;
+        }
+
+        float correction = std::max(contact.penetration - m_Settings.linearSlop, 0.0f);
+        contact.positionBias = std::min(m_Settings.baumgarte / dt * correction, m_Settings.maxCorrectionSpeed);
+
+        if (!m_Settings.splitImpulse) {
+            contact.velocityBias = std::max(contact.velocityBias, contact.positionBias);
+        }
+
+        contact.pseudoImpulse = 0.0f;
+
+        if (m_Settings.warmStarting && contact.pair) {
+            contact.normalImpulse = contact.pair->normalImpulse;
+            contact.tangentImpulse1 = glm::dot(contact.pair->frictionImpulse, contact.tangent1);
+            contact.tangentImpulse2 = glm::dot(contact.pair->frictionImpulse, contact.tangent2);
+
+            glm::vec3 impulse = contact.normal * contact.normalImpulse +
+                                contact.tangent1 * contact.tangentImpulse1 +
+                                contact.tangent2 * contact.tangentImpulse2;
+            ApplyImpulse(a, b, impulse);
+        } else {
+            contact.normalImpulse = 0.0f;
+            contact.tangentImpulse1 = 0.0f;
+            contact.tangentImpulse2 = 0.0f;
+        }
+    }
+
+    void ContactSolver::SolveIsland(std::vector<SolverBody>& bodies, std::vector<SolverContact>& contacts,
+                                    const std::vector<uint32_t>& indices, float dt) const {
+        if (indices.empty() || dt <= 0.0f) return;
+
+        SolverBody ground;
+
+        for (uint32_t index : indices) {
+            PreStep(bodies, contacts[index], dt);
+        }
+
+        // Velocity constraints
+        for (int iteration = 0; iteration < m_Settings.velocityIterations; iteration++) {
+            for (uint32_t index : indices) {
+                SolverContact& c = contacts[index];
+                SolverBody& a = GetBody(bodies, c.bodyA, ground);
+                SolverBody& b = GetBody(bodies, c.bodyB, ground);
+
+                // Friction first, bounded by the current normal impulse (Coulomb cone)
+                glm::vec3 relativeVelocity = a.velocity - b.velocity;
+                float lambda1 = -glm::dot(relativeVelocity, c.tangent1) * c.tangentMass1;
+                float lambda2 = -glm::dot(relativeVelocity, c.tangent2) * c.tangentMass2;
+
+                float newTangent1 = c.tangentImpulse1 + lambda1;
+                float newTangent2 = c.tangentImpulse2 + lambda2;
+                float maxFriction = c.friction * c.normalImpulse;
+                float tangentLength = std::sqrt(newTangent1 * newTangent1 + newTangent2 * newTangent2);
+                if (tangentLength > maxFriction) {
+                    float scale = tangentLength > 0.0f ? maxFriction / tangentLength : 0.0f;
+                    newTangent1 *= scale;
+                    newTangent2 *= scale;
+                }
+                lambda1 = newTangent1 - c.tangentImpulse1;
+                lambda2 = newTangent2 - c.tangentImpulse2;
+                c.tangentImpulse1 = newTangent1;
+                c.tangentImpulse2 = newTangent2;
+                ApplyImpulse(a, b, c.tangent1 * lambda1 + c.tangent2 * lambda2);
+
+                // Normal impulse, accumulated and clamped to push only
+                relativeVelocity = a.velocity - b.velocity;
+                float normalSpeed = glm::dot(relativeVelocity, c.normal);
+                float lambda = c.normalMass * (-normalSpeed + c.velocityBias);
+                float newImpulse = std::max(c.normalImpulse + lambda, 0.0f);
+                lambda = newImpulse - c.normalImpulse;
+                c.normalImpulse = newImpulse;
+                ApplyImpulse(a, b, c.normal * lambda);
+            }
+        }
+
+        // Split impulse position correction. Pseudo velocities move bodies apart this step
+        // without feeding energy back into the real velocities.
+        if (m_Settings.splitImpulse) {
+            for (int iteration = 0; iteration < m_Settings.positionIterations; iteration++) {
+                for (uint32_t index : indices) {
+                    SolverContact& c = contacts[index];
+                    if (c.positionBias <= 0.0f) continue;
+
+                    SolverBody& a = GetBody(bodies, c.bodyA, ground);
+                    SolverBody& b = GetBody(bodies, c.bodyB, ground);
+
+                    float separatingSpeed = glm::dot(a.pseudoVelocity - b.pseudoVelocity, c.normal);
+                    float lambda = c.normalMass * (-separatingSpeed + c.positionBias);
+                    float newImpulse = std::max(c.pseudoImpulse + lambda, 0.0f);
+                    lambda = newImpulse - c.pseudoImpulse;
+                    c.pseudoImpulse = newImpulse;
+                    ApplyPseudoImpulse(a, b, c.normal * lambda);
+                }
+            }
+        }
+
+        // Keep the accumulated impulses for warm starting next step
+        for (uint32_t index : indices) {
+            SolverContact& c = contacts[index];
+            if (c.pair) {
+                c.pair->normalImpulse = c.normalImpulse;
+                c.pair->frictionImpulse = c.tangent1 * c.tangentImpulse1 + c.tangent2 * c.tangentImpulse2;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Island.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Xi {
+
+    struct ContactPair;
+
+    struct SolverSettings {
+        int velocityIterations = 8;
+        int positionIterations = 3;          // Split impulse iterations
+        bool warmStarting = true;
+        bool splitImpulse = true;            // Otherwise Baumgarte bias is fed into the velocity solve
+        float baumgarte = 0.2f;              // Fraction of penetration removed per step
+        float linearSlop = 0.005f;           // Penetration allowed before correction kicks in
+        float maxCorrectionSpeed = 4.0f;     // Clamp on correction velocity (units per second)
+        float restitutionThreshold = 1.0f;   // Closing speeds below this do not bounce
+    };
+
+    // Velocity state of a body for the duration of a solve
+    struct SolverBody {
+        glm::vec3 velocity = glm::vec3(0.0f);
+        glm::vec3 pseudoVelocity = glm::vec3(0.0f);  // Position correction, never added to velocity
+        glm::vec3 linearFactor = glm::vec3(1.0f);    // Zero on frozen axes
+        float invMass = 0.0f;
+    };
+
+    // A single non-penetration constraint with Coulomb friction
+    struct SolverContact {
+        uint32_t bodyA = INVALID_BODY;
+        uint32_t bodyB = INVALID_BODY;
+
+        glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);  // Points from B towards A
+        glm::vec3 tangent1 = glm::vec3(1.0f, 0.0f, 0.0f);
+        glm::vec3 tangent2 = glm::vec3(0.0f, 0.0f, 1.0f);
+        float penetration = 0.0f;
+        float friction = 0.5f;
+        float restitution = 0.0f;
+
+        // Filled in by the solver
+        float normalMass = 0.0f;
+        float tangentMass1 = 0.0f;
+        float tangentMass2 = 0.0f;
+        float velocityBias = 0.0f;
+        float positionBias = 0.0f;
+
+        // Accumulated impulses, seeded from the contact cache when warm starting
+        float normalImpulse = 0.0f;
+        float tangentImpulse1 = 0.0f;
+        float tangentImpulse2 = 0.0f;
+        float pseudoImpulse = 0.0f;
+
+        ContactPair* pair = nullptr;
+    };
+
+    // Sequential impulse solver. Contacts are solved one at a time with accumulated,
+    // clamped impulses, iterating until the island converges.
+    class ContactSolver {
+    public:
+        void SetSettings(const SolverSettings& settings) { m_Settings = settings; }
+        const SolverSettings& GetSettings() const { return m_Settings; }
+
+        // Solves the given contacts (indices into contacts) in order. Bodies outside the
+        // island are never touched, so separate islands can be solved independently.
+        void SolveIsland(std::vector<SolverBody>& bodies, std::vector<SolverContact>& contacts,
+                         const std::vector<uint32_t>& indices, float dt) const;
+
+    private:
+        void PreStep(std::vector<SolverBody>& bodies, SolverContact& contact, float dt) const;
+
+        SolverSettings m_Settings;
+    };
+
+}
@@ -0,0 +1,152 @@
+#include "Heightfield.h"
+#include "../Core/Log.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace Xi {
+
+    Heightfield::Heightfield(uint32_t columns, uint32_t rows, std::vector<float> heights, float spacing)
+        : m_Columns(columns), m_Rows(rows), m_Spacing(spacing), m_Heights(std::move(heights)) {
+        if (m_Columns < 2 || m_Rows < 2 || m_Heights.size() != static_cast<size_t>(m_Columns) * m_Rows || m_Spacing <= 0.0f) {
+            XI_LOG_ERROR("Heightfield needs at least 2x2 samples, one height per sample and a positive spacing");
+            m_Columns = 0;
+            m_Rows = 0;
+            m_Heights.clear();
+            return;
+        }
+
+        m_Origin = glm::vec2(m_Columns - 1, m_Rows - 1) * (m_Spacing * -0.5f);
+
+        auto [low, high] = std::minmax_element(m_Heights.begin(), m_Heights.end());
+        m_Bounds = AABB(glm::vec3(m_Origin.x, *low, m_Origin.y), glm::vec3(-m_Origin.x, *high, -m_Origin.y));
+    }
+
+    glm::vec3 Heightfield::GetPoint(uint32_t x, uint32_t z) const {
+        return glm::vec3(m_Origin.x + x * m_Spacing, GetHeight(x, z), m_Origin.y + z * m_Spacing);
+    }
+
+    // Both triangles wind counter-clockwise seen from above, sharing the (x, z + 1) - (x + 1, z) diagonal
+    void Heightfield::GetCellTriangles(uint32_t x, uint32_t z, Triangle& first, Triangle& second) const {
+        glm::vec3 p00 = GetPoint(x, z);
+        glm::vec3 p10 = GetPoint(x + 1, z);
+        glm::vec3 p01 = GetPoint(x, z + 1);
+        glm::vec3 p11 = GetPoint(x + 1, z + 1);
+
+        first.a = p00;
+        first.b = p01;
+        first.c = p10;
+
+        second.a = p10;
+        second.b = p01;
+        second.c = p11;
+    }
+
+    float Heightfield::SampleHeight(float x, float z) const {
+        if (m_Columns < 2 || m_Rows < 2) return 0.0f;
+
+        float fx = glm::clamp((x - m_Origin.x) / m_Spacing, 0.0f, static_cast<float>(m_Columns - 1));
+        float fz = glm::clamp((z - m_Origin.y) / m_Spacing, 0.0f, static_cast<float>(m_Rows - 1));
+        uint32_t cx = glm::min(static_cast<uint32_t>(fx), m_Columns - 2);
+        uint32_t cz = glm::min(static_cast<uint32_t>(fz), m_Rows - 2);
+        float u = fx - cx;
+        float v = fz - cz;
+
+        float h00 = GetHeight(cx, cz), h10 = GetHeight(cx + 1, cz);
+        float h01 = GetHeight(cx, cz + 1), h11 = GetHeight(cx + 1, cz + 1);
+
+        if (u + v <= 1.0f) {
+            return h00 + (h10 - h00) * u + (h01 - h00) * v;
+        }
+        return h11 + (h01 - h11) * (1.0f - u) + (h10 - h11) * (1.0f - v);
+    }
+
+    bool Heightfield::RaycastCell(uint32_t x, uint32_t z, const glm::vec3& origin, const glm::vec3& direction,
+                                  float& t, glm::vec3& normal) const {
+        Triangle first, second;
+        GetCellTriangles(x, z, first, second);
+
+        bool hit = false;
+        for (const Triangle& triangle : { first, second }) {
+            float hitT;
+            if (triangle.Raycast(origin, direction, hitT) && hitT <= t) {
+                t = hitT;
+                normal = triangle.GetNormal();
+                hit = true;
+            }
+        }
+        return hit;
+    }
+
+    bool Heightfield::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxT,
+                              float& t, glm::vec3& normal) const {
+        if (m_Columns < 2 || m_Rows < 2) return false;
+
+        // Clip the ray to the bounds
+        glm::vec3 invDirection = 1.0f / direction;
+        glm::vec3 t1 = (m_Bounds.min - origin) * invDirection;
+        glm::vec3 t2 = (m_Bounds.max - origin) * invDirection;
+        glm::vec3 tNear = glm::min(t1, t2);
+        glm::vec3 tFar = glm::max(t1, t2);
+        float enter = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+        float exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxT));
+        if (enter > exit) return false;
+
+        // Walk the cells under the ray in order (Amanatides & Woo), so the first hit is the closest
+        glm::vec3 start = origin + direction * enter;
+        int maxCellX = static_cast<int>(m_Columns) - 2;
+        int maxCellZ = static_cast<int>(m_Rows) - 2;
+        int cellX = glm::clamp(static_cast<int>(std::floor((start.x - m_Origin.x) / m_Spacing)), 0, maxCellX);
+        int cellZ = glm::clamp(static_cast<int>(std::floor((start.z - m_Origin.y) / m_Spacing)), 0, maxCellZ);
+
+        int stepX = direction.x > 0.0f ? 1 : -1;
+        int stepZ = direction.z > 0.0f ? 1 : -1;
+
+        auto boundaryT = [&](int cell, int step, float originCoord, float gridOrigin, float invDir) {
+            float boundary = gridOrigin + (cell + (step > 0 ? 1 : 0)) * m_Spacing;
+            return std::isinf(invDir) ? FLT_MAX : (boundary - originCoord) * invDir;
+        };
+
+        float nextX = boundaryT(cellX, stepX, origin.x, m_Origin.x, invDirection.x);
+        float nextZ = boundaryT(cellZ, stepZ, origin.z, m_Origin.y, invDirection.z);
+        float deltaX = std::isinf(invDirection.x) ? FLT_MAX : m_Spacing * std::abs(invDirection.x);
+        float deltaZ = std::isinf(invDirection.z) ? FLT_MAX : m_Spacing * std::abs(invDirection.z);
+
+        float cellEnter = enter;
+        t = exit;
+
+        while (true) {
+            float cellExit = glm::min(glm::min(nextX, nextZ), exit);
+
+            // Skip cells whose height range the ray passes entirely above or below
+            float y0 = origin.y + direction.y * cellEnter;
+            float y1 = origin.y + direction.y * cellExit;
+            float h00 = GetHeight(cellX, cellZ), h10 = GetHeight(cellX + 1, cellZ);
+            float h01 = GetHeight(cellX, cellZ + 1), h11 = GetHeight(cellX + 1, cellZ + 1);
+            float low = glm::min(glm::min(h00, h10), glm::min(h01, h11));
+            float high = glm::max(glm::max(h00, h10), glm::max(h01, h11));
+
+            if (glm::min(y0, y1) <= high && glm::max(y0, y1) >= low &&
+                RaycastCell(cellX, cellZ, origin, direction, t, normal)) {
+                return true;
+            }
+
+            if (cellExit >= exit) break;
+
+            if (nextX < nextZ) {
+                cellX += stepX;
+                cellEnter = nextX;
+                nextX += deltaX;
+            } else {
+                cellZ += stepZ;
+                cellEnter = nextZ;
+                nextZ += deltaZ;
+            }
+
+            if (cellX < 0 || cellX > maxCellX || cellZ < 0 || cellZ > maxCellZ) break;
+        }
+
+        return false;
+    }
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Collider.h"
+#include "TriangleMesh.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace Xi {
+
+    // Regular grid of heights in the local XZ plane, centered on the origin, for terrain.
+    // Each cell is split into two triangles along the same diagonal. The grid is its own
+    // acceleration structure: a box maps straight to a range of cells and a ray walks the
+    // cells it crosses. Heights are sampled row by row, sample (x, z) at heights[z * columns + x].
+    class Heightfield {
+    public:
+        Heightfield(uint32_t columns, uint32_t rows, std::vector<float> heights, float spacing = 1.0f);
+
+        // Calls func(triangle) for the triangles of every cell overlapping the local-space box
+        template<typename Func>
+        void QueryTriangles(const AABB& bounds, Func&& func) const;
+
+        // Closest hit along origin + direction * t for t in [0, maxT], in local space
+        bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxT, float& t, glm::vec3& normal) const;
+
+        float GetHeight(uint32_t x, uint32_t z) const { return m_Heights[z * m_Columns + x]; }
+
+        // Interpolated surface height at a local position, clamped to the grid
+        float SampleHeight(float x, float z) const;
+
+        uint32_t GetColumns() const { return m_Columns; }
+        uint32_t GetRows() const { return m_Rows; }
+        float GetSpacing() const { return m_Spacing; }
+        const std::vector<float>& GetHeights() const { return m_Heights; }
+        const AABB& GetBounds() const { return m_Bounds; }
+
+    private:
+        glm::vec3 GetPoint(uint32_t x, uint32_t z) const;
+        void GetCellTriangles(uint32_t x, uint32_t z, Triangle& first, Triangle& second) const;
+        bool RaycastCell(uint32_t x, uint32_t z, const glm::vec3& origin, const glm::vec3& direction,
+                         float& t, glm::vec3& normal) const;
+
+        uint32_t m_Columns = 0;
+        uint32_t m_Rows = 0;
+        float m_Spacing = 1.0f;
+        std::vector<float> m_Heights;
+        glm::vec2 m_Origin = glm::vec2(0.0f);  // Local XZ of sample (0, 0)
+        AABB m_Bounds;
+    };
+
+    template<typename Func>
+    void Heightfield::QueryTriangles(const AABB& bounds, Func&& func) const {
+        if (m_Columns < 2 || m_Rows < 2 || !m_Bounds.Intersects(bounds)) return;
+
+        float cellsX = static_cast<float>(m_Columns - 2);
+        float cellsZ = static_cast<float>(m_Rows - 2);
+        uint32_t minX = static_cast<uint32_t>(glm::clamp(std::floor((bounds.min.x - m_Origin.x) / m_Spacing), 0.0f, cellsX));
+        uint32_t maxX = static_cast<uint32_t>(glm::clamp(std::floor((bounds.max.x - m_Origin.x) / m_Spacing), 0.0f, cellsX));
+        uint32_t minZ = static_cast<uint32_t>(glm::clamp(std::floor((bounds.min.z - m_Origin.y) / m_Spacing), 0.0f, cellsZ));
+        uint32_t maxZ = static_cast<uint32_t>(glm::clamp(std::floor((bounds.max.z - m_Origin.y) / m_Spacing), 0.0f, cellsZ));
+
+        for (uint32_t z = minZ; z <= maxZ; z++) {
+            for (uint32_t x = minX; x <= maxX; x++) {
+                float h00 = GetHeight(x, z), h10 = GetHeight(x + 1, z);
+                float h01 = GetHeight(x, z + 1), h11 = GetHeight(x + 1, z + 1);
+                float low = glm::min(glm::min(h00, h10), glm::min(h01, h11));
+                float high = glm::max(glm::max(h00, h10), glm::max(h01, h11));
+                if (low > bounds.max.y || high < bounds.min.y) continue;
+
+                Triangle first, second;
+                GetCellTriangles(x, z, first, second);
+                func(first);
+                func(second);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,69 @@
+#include "Island.h"
+
+namespace Xi {
+
+    void IslandBuilder::Reset(uint32_t bodyCount) {
+        m_Parent.resize(bodyCount);
+        m_Rank.assign(bodyCount, 0);
+        for (uint32_t i = 0; i < bodyCount; i++) {
+            m_Parent[i] = i;
+        }
+        m_Contacts.clear();
+    }
+
+    void IslandBuilder::AddContact(uint32_t contactIndex, uint32_t bodyA, uint32_t bodyB) {
+        if (bodyA == INVALID_BODY && bodyB == INVALID_BODY) return;
+
+        if (bodyA != INVALID_BODY && bodyB != INVALID_BODY) {
+            Union(bodyA, bodyB);
+        }
+
+        m_Contacts.push_back({ contactIndex, bodyA != INVALID_BODY ? bodyA : bodyB });
+    }
+
+    void IslandBuilder::Build(std::vector<Island>& islands) {
+        islands.clear();
+
+        uint32_t bodyCount = static_cast<uint32_t>(m_Parent.size());
+        m_RootToIsland.assign(bodyCount, INVALID_BODY);
+
+        // Bodies are visited in index order, so island order is stable between steps
+        for (uint32_t body = 0; body < bodyCount; body++) {
+            uint32_t root = Find(body);
+            if (m_RootToIsland[root] == INVALID_BODY) {
+                m_RootToIsland[root] = static_cast<uint32_t>(islands.size());
+                islands.emplace_back();
+            }
+            islands[m_RootToIsland[root]].bodies.push_back(body);
+        }
+
+        for (const PendingContact& contact : m_Contacts) {
+            islands[m_RootToIsland[Find(contact.body)]].contacts.push_back(contact.index);
+        }
+    }
+
+    uint32_t IslandBuilder::Find(uint32_t body) {
+        // Path halving
+        while (m_Parent[body] != body) {
+            m_Parent[body] = m_Parent[m_Parent[body]];
+            body = m_Parent[body];
+        }
+        return body;
+    }
+
+    void IslandBuilder::Union(uint32_t a, uint32_t b) {
+        uint32_t rootA = Find(a);
+        uint32_t rootB = Find(b);
+        if (rootA == rootB) return;
+
+        if (m_Rank[rootA] < m_Rank[rootB]) {
+            m_Parent[rootA] = rootB;
+        } else if (m_Rank[rootA] > m_Rank[rootB]) {
+            m_Parent[rootB] = rootA;
+        } else {
+            m_Parent[rootB] = rootA;
+            m_Rank[rootA]++;
+        }
+    }
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Xi {
+
+    constexpr uint32_t INVALID_BODY = UINT32_MAX;
+
+    // A group of dynamic bodies connected through contacts. Islands are solved
+    // and put to sleep as a unit.
+    struct Island {
+        std::vector<uint32_t> bodies;    // Body indices
+        std::vector<uint32_t> contacts;  // Contact indices
+        bool sleeping = false;
+    };
+
+    // Union-find over body indices, rebuilt every step from the contact list
+    class IslandBuilder {
+    public:
+        void Reset(uint32_t bodyCount);
+
+        // Either body may be INVALID_BODY (static geometry), which does not join islands
+        void AddContact(uint32_t contactIndex, uint32_t bodyA, uint32_t bodyB);
+
+        // Groups every body into exactly one island; contacts go to the island of their bodies
+        void Build(std::vector<Island>& islands);
+
+    private:
+        uint32_t Find(uint32_t body);
+        void Union(uint32_t a, uint32_t b);
+
+        struct PendingContact {
+            uint32_t index;
+            uint32_t body;
+        };
+
+        std::vector<uint32_t> m_Parent;
+        std::vector<uint32_t> m_Rank;
+        std::vector<PendingContact> m_Contacts;
+        std::vector<uint32_t> m_RootToIsland;
+    };
+
+}
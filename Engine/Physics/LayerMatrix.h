@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Xi {
+
+    // Which of the 32 collider layers collide with each other. Kept symmetric; every
+    // pair collides by default. A collider's own mask can only narrow this further.
+    class LayerMatrix {
+    public:
+        static constexpr uint32_t MAX_LAYERS = 32;
+
+        LayerMatrix() { m_Masks.fill(0xFFFFFFFFu); }
+
+        void SetCollision(uint32_t layerA, uint32_t layerB, bool collide) {
+            layerA %= MAX_LAYERS;
+            layerB %= MAX_LAYERS;
+            if (collide) {
+                m_Masks[layerA] |= 1u << layerB;
+                m_Masks[layerB] |= 1u << layerA;
+            } else {
+                m_Masks[layerA] &= ~(1u << layerB);
+                m_Masks[layerB] &= ~(1u << layerA);
+            }
+        }
+
+        bool ShouldCollide(uint32_t layerA, uint32_t layerB) const {
+            return (m_Masks[layerA % MAX_LAYERS] & (1u << (layerB % MAX_LAYERS))) != 0;
+        }
+
+        // Bit n is set if the layer collides with layer n
+        uint32_t GetMask(uint32_t layer) const { return m_Masks[layer % MAX_LAYERS]; }
+
+    private:
+        std::array<uint32_t, MAX_LAYERS> m_Masks;
+    };
+
+}
@@ -0,0 +1,845 @@
+#include "Narrowphase.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace Xi {
+
+    void ContactManifold::AddPoint(const glm::vec3& point, float depth) {
+        if (pointCount >= MAX_POINTS) return;
+        points[pointCount] = point;
+        depths[pointCount] = depth;
+        pointCount++;
+    }
+
+    float ContactManifold::GetMaxDepth() const {
+        float maxDepth = -FLT_MAX;
+        for (uint32_t i = 0; i < pointCount; i++) {
+            maxDepth = glm::max(maxDepth, depths[i]);
+        }
+        return maxDepth;
+    }
+
+    glm::vec3 ContactManifold::GetDeepestPoint() const {
+        uint32_t deepest = 0;
+        for (uint32_t i = 1; i < pointCount; i++) {
+            if (depths[i] > depths[deepest]) deepest = i;
+        }
+        return pointCount > 0 ? points[deepest] : glm::vec3(0.0f);
+    }
+
+    glm::vec3 ContactManifold::GetCenter() const {
+        glm::vec3 sum(0.0f);
+        for (uint32_t i = 0; i < pointCount; i++) {
+            sum += points[i];
+        }
+        return pointCount > 0 ? sum / static_cast<float>(pointCount) : sum;
+    }
+
+    // Two spheres (or closest points of swept spheres) with centers ca and cb
+    static bool SphereContact(const glm::vec3& ca, float ra, const glm::vec3& cb, float rb,
+                              float margin, ContactManifold& manifold) {
+        glm::vec3 diff = ca - cb;
+        float distanceSq = glm::dot(diff, diff);
+        float reach = ra + rb + margin;
+        if (distanceSq > reach * reach) return false;
+
+        float distance = std::sqrt(distanceSq);
+        glm::vec3 normal = (distance > 0.0001f) ? diff / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+
+        glm::vec3 surfaceA = ca - normal * ra;
+        glm::vec3 surfaceB = cb + normal * rb;
+
+        manifold.normal = normal;
+        manifold.pointCount = 0;
+        manifold.AddPoint((surfaceA + surfaceB) * 0.5f, ra + rb - distance);
+        return true;
+    }
+
+    bool CollideSpheres(const BoundingSphere& a, const BoundingSphere& b, float margin, ContactManifold& manifold) {
+        return SphereContact(a.center, a.radius, b.center, b.radius, margin, manifold);
+    }
+
+    bool CollideSphereBox(const BoundingSphere& sphere, const OrientedBox& box, float margin, ContactManifold& manifold) {
+        glm::vec3 local = box.ToLocal(sphere.center);
+        glm::vec3 closest = glm::clamp(local, -box.halfExtents, box.halfExtents);
+        glm::vec3 diff = local - closest;
+        float distanceSq = glm::dot(diff, diff);
+
+        manifold.pointCount = 0;
+
+        if (distanceSq > 1e-12f) {
+            // Center outside the box
+            float reach = sphere.radius + margin;
+            if (distanceSq > reach * reach) return false;
+
+            float distance = std::sqrt(distanceSq);
+            manifold.normal = box.axes * (diff / distance);
+
+            glm::vec3 surfaceBox = box.ToWorld(closest);
+            glm::vec3 surfaceSphere = sphere.center - manifold.normal * sphere.radius;
+            manifold.AddPoint((surfaceBox + surfaceSphere) * 0.5f, sphere.radius - distance);
+            return true;
+        }
+
+        // Center inside the box - push out through the nearest face
+        glm::vec3 faceDistance = box.halfExtents - glm::abs(local);
+        int axis = 0;
+        if (faceDistance.y < faceDistance[axis]) axis = 1;
+        if (faceDistance.z < faceDistance[axis]) axis = 2;
+
+        float sign = local[axis] >= 0.0f ? 1.0f : -1.0f;
+        manifold.normal = box.axes[axis] * sign;
+
+        glm::vec3 facePoint = local;
+        facePoint[axis] = box.halfExtents[axis] * sign;
+        manifold.AddPoint(box.ToWorld(facePoint), faceDistance[axis] + sphere.radius);
+        return true;
+    }
+
+    // Keeps the deepest point and three others spread as far apart as possible
+    static void ReduceManifold(const glm::vec3* points, const float* depths, uint32_t count, ContactManifold& manifold) {
+        manifold.pointCount = 0;
+        if (count <= ContactManifold::MAX_POINTS) {
+            for (uint32_t i = 0; i < count; i++) manifold.AddPoint(points[i], depths[i]);
+            return;
+        }
+
+        uint32_t chosen[ContactManifold::MAX_POINTS];
+
+        chosen[0] = 0;
+        for (uint32_t i = 1; i < count; i++) {
+            if (depths[i] > depths[chosen[0]]) chosen[0] = i;
+        }
+
+        for (uint32_t c = 1; c < ContactManifold::MAX_POINTS; c++) {
+            float bestDistance = -1.0f;
+            chosen[c] = chosen[0];
+
+            for (uint32_t i = 0; i < count; i++) {
+                // Distance to the nearest point already chosen
+                float nearest = FLT_MAX;
+                for (uint32_t k = 0; k < c; k++) {
+                    glm::vec3 d = points[i] - points[chosen[k]];
+                    nearest = glm::min(nearest, glm::dot(d, d));
+                }
+                if (nearest > bestDistance) {
+                    bestDistance = nearest;
+                    chosen[c] = i;
+                }
+            }
+        }
+
+        for (uint32_t c = 0; c < ContactManifold::MAX_POINTS; c++) {
+            manifold.AddPoint(points[chosen[c]], depths[chosen[c]]);
+        }
+    }
+
+    // Sutherland-Hodgman clip of a polygon against the half space dot(n, p) <= offset
+    static uint32_t ClipPolygon(const glm::vec3* in, uint32_t count, const glm::vec3& n, float offset, glm::vec3* out) {
+        uint32_t outCount = 0;
+        if (count == 0) return 0;
+
+        glm::vec3 prev = in[count - 1];
+        float prevDistance = glm::dot(n, prev) - offset;
+
+        for (uint32_t i = 0; i < count; i++) {
+            glm::vec3 curr = in[i];
+            float currDistance = glm::dot(n, curr) - offset;
+
+            if (prevDistance <= 0.0f) out[outCount++] = prev;
+            if ((prevDistance <= 0.0f) != (currDistance <= 0.0f)) {
+                float t = prevDistance / (prevDistance - currDistance);
+                out[outCount++] = prev + (curr - prev) * t;
+            }
+
+            prev = curr;
+            prevDistance = currDistance;
+        }
+
+        return outCount;
+    }
+
+    // Clips a polygon touching a box face against the face's side planes and keeps the
+    // points within the margin of it. refNormal points out of the face towards the polygon.
+    static bool ClipToBoxFace(const OrientedBox& ref, int refAxis, const glm::vec3& refNormal,
+                              glm::vec3* polygon, uint32_t count, float margin, ContactManifold& manifold) {
+        glm::vec3 clipped[8];
+
+        for (int side = 1; side <= 2; side++) {
+            int k = (refAxis + side) % 3;
+            const glm::vec3& axis = ref.axes[k];
+            float centerDot = glm::dot(axis, ref.center);
+
+            count = ClipPolygon(polygon, count, axis, centerDot + ref.halfExtents[k], clipped);
+            count = ClipPolygon(clipped, count, -axis, -centerDot + ref.halfExtents[k], polygon);
+        }
+
+        float faceOffset = glm::dot(refNormal, ref.center) + ref.halfExtents[refAxis];
+
+        glm::vec3 points[8];
+        float depths[8];
+        uint32_t pointCount = 0;
+
+        for (uint32_t i = 0; i < count; i++) {
+            float depth = faceOffset - glm::dot(refNormal, polygon[i]);
+            if (depth < -margin) continue;
+
+            // Midway between the incident point and its projection onto the reference face
+            points[pointCount] = polygon[i] + refNormal * (depth * 0.5f);
+            depths[pointCount] = depth;
+            pointCount++;
+        }
+
+        if (pointCount == 0) return false;
+
+        ReduceManifold(points, depths, pointCount, manifold);
+        return true;
+    }
+
+    // Face of the box most anti-parallel to a normal, as a quad
+    static void GetIncidentFace(const OrientedBox& box, const glm::vec3& normal, glm::vec3* polygon) {
+        int axis = 0;
+        float maxDot = -1.0f;
+        for (int i = 0; i < 3; i++) {
+            float d = glm::abs(glm::dot(box.axes[i], normal));
+            if (d > maxDot) {
+                maxDot = d;
+                axis = i;
+            }
+        }
+
+        float sign = glm::dot(box.axes[axis], normal) > 0.0f ? -1.0f : 1.0f;
+        glm::vec3 center = box.center + box.axes[axis] * (box.halfExtents[axis] * sign);
+
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        glm::vec3 du = box.axes[u] * box.halfExtents[u];
+        glm::vec3 dv = box.axes[v] * box.halfExtents[v];
+
+        polygon[0] = center + du + dv;
+        polygon[1] = center - du + dv;
+        polygon[2] = center - du - dv;
+        polygon[3] = center + du - dv;
+    }
+
+    // Clips the incident box face against the side planes of the reference face
+    static bool ClipFaceContact(const OrientedBox& ref, int refAxis, const glm::vec3& refNormal,
+                                const OrientedBox& inc, float margin, ContactManifold& manifold) {
+        // Room for the 4 corners plus one new vertex per clip plane
+        glm::vec3 polygon[8];
+        GetIncidentFace(inc, refNormal, polygon);
+        return ClipToBoxFace(ref, refAxis, refNormal, polygon, 4, margin, manifold);
+    }
+
+    bool CollideBoxes(const OrientedBox& a, const OrientedBox& b, float margin, ContactManifold& manifold) {
+        // Faces are preferred over edges, and A's faces over B's, unless clearly worse.
+        // This keeps the manifold from flipping between features on resting contacts.
+        constexpr float RELATIVE_TOLERANCE = 0.98f;
+        constexpr float ABSOLUTE_TOLERANCE = 0.001f;
+
+        glm::vec3 offset = a.center - b.center;
+
+        float absR[3][3];
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                absR[i][j] = glm::abs(glm::dot(a.axes[i], b.axes[j])) + 1e-6f;
+            }
+        }
+
+        float bestSeparation = -FLT_MAX;
+        int bestAxis = -1;
+        glm::vec3 bestNormal(0.0f);
+
+        auto testAxis = [&](const glm::vec3& axis, float ra, float rb, int index, bool preferExisting) {
+            float distance = glm::dot(offset, axis);
+            float separation = glm::abs(distance) - (ra + rb);
+            if (separation > margin) return false;
+
+            bool better = preferExisting
+                ? separation > RELATIVE_TOLERANCE * bestSeparation + ABSOLUTE_TOLERANCE
+                : separation > bestSeparation;
+
+            if (bestAxis < 0 || better) {
+                bestSeparation = separation;
+                bestAxis = index;
+                bestNormal = distance < 0.0f ? -axis : axis;
+            }
+            return true;
+        };
+
+        // Face normals of A
+        for (int i = 0; i < 3; i++) {
+            float rb = b.halfExtents.x * absR[i][0] + b.halfExtents.y * absR[i][1] + b.halfExtents.z * absR[i][2];
+            if (!testAxis(a.axes[i], a.halfExtents[i], rb, i, false)) return false;
+        }
+
+        // Face normals of B
+        for (int j = 0; j < 3; j++) {
+            float ra = a.halfExtents.x * absR[0][j] + a.halfExtents.y * absR[1][j] + a.halfExtents.z * absR[2][j];
+            if (!testAxis(b.axes[j], ra, b.halfExtents[j], 3 + j, true)) return false;
+        }
+
+        // Edge-edge cross products
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                glm::vec3 axis = glm::cross(a.axes[i], b.axes[j]);
+                float length = glm::length(axis);
+                if (length < 1e-5f) continue;  // Parallel edges, already covered by the face axes
+                axis /= length;
+
+                float ra = 0.0f;
+                float rb = 0.0f;
+                for (int k = 0; k < 3; k++) {
+                    ra += a.halfExtents[k] * glm::abs(glm::dot(a.axes[k], axis));
+                    rb += b.halfExtents[k] * glm::abs(glm::dot(b.axes[k], axis));
+                }
+
+                if (!testAxis(axis, ra, rb, 6 + i * 3 + j, true)) return false;
+            }
+        }
+
+        manifold.normal = bestNormal;
+        manifold.pointCount = 0;
+
+        if (bestAxis < 3) {
+            // Reference face on A faces B, so it points against the B->A normal
+            return ClipFaceContact(a, bestAxis, -bestNormal, b, margin, manifold);
+        }
+        if (bestAxis < 6) {
+            return ClipFaceContact(b, bestAxis - 3, bestNormal, a, margin, manifold);
+        }
+
+        // Edge-edge: closest points between the two edges nearest each other
+        int edgeA = (bestAxis - 6) / 3;
+        int edgeB = (bestAxis - 6) % 3;
+
+        glm::vec3 pointA = a.center;
+        glm::vec3 pointB = b.center;
+        for (int k = 0; k < 3; k++) {
+            if (k != edgeA) pointA += a.axes[k] * (a.halfExtents[k] * (glm::dot(a.axes[k], bestNormal) > 0.0f ? -1.0f : 1.0f));
+            if (k != edgeB) pointB += b.axes[k] * (b.halfExtents[k] * (glm::dot(b.axes[k], bestNormal) > 0.0f ? 1.0f : -1.0f));
+        }
+
+        glm::vec3 halfA = a.axes[edgeA] * a.halfExtents[edgeA];
+        glm::vec3 halfB = b.axes[edgeB] * b.halfExtents[edgeB];
+
+        glm::vec3 closestA, closestB;
+        ClosestPointsSegmentSegment(pointA - halfA, pointA + halfA, pointB - halfB, pointB + halfB, closestA, closestB);
+
+        manifold.AddPoint((closestA + closestB) * 0.5f, -bestSeparation);
+        return true;
+    }
+
+    bool CollideCapsuleSphere(const CapsuleShape& capsule, const BoundingSphere& sphere, float margin, ContactManifold& manifold) {
+        glm::vec3 closest = ClosestPointOnSegment(sphere.center, capsule.a, capsule.b);
+        return SphereContact(closest, capsule.radius, sphere.center, sphere.radius, margin, manifold);
+    }
+
+    bool CollideCapsules(const CapsuleShape& a, const CapsuleShape& b, float margin, ContactManifold& manifold) {
+        glm::vec3 closestA, closestB;
+        ClosestPointsSegmentSegment(a.a, a.b, b.a, b.b, closestA, closestB);
+        return SphereContact(closestA, a.radius, closestB, b.radius, margin, manifold);
+    }
+
+    // Squared distance from a box-space point to the box
+    static float DistanceSqToBox(const glm::vec3& local, const glm::vec3& halfExtents) {
+        glm::vec3 d = local - glm::clamp(local, -halfExtents, halfExtents);
+        return glm::dot(d, d);
+    }
+
+    bool CollideCapsuleBox(const CapsuleShape& capsule, const OrientedBox& box, float margin, ContactManifold& manifold) {
+        glm::vec3 localA = box.ToLocal(capsule.a);
+        glm::vec3 localB = box.ToLocal(capsule.b);
+        glm::vec3 segment = localB - localA;
+
+        // Distance to a convex box is convex along the segment, so a ternary search finds its minimum
+        float lo = 0.0f;
+        float hi = 1.0f;
+        for (int i = 0; i < 32; i++) {
+            float t1 = lo + (hi - lo) / 3.0f;
+            float t2 = hi - (hi - lo) / 3.0f;
+            if (DistanceSqToBox(localA + segment * t1, box.halfExtents) <= DistanceSqToBox(localA + segment * t2, box.halfExtents)) {
+                hi = t2;
+            } else {
+                lo = t1;
+            }
+        }
+
+        glm::vec3 closestSegment = localA + segment * ((lo + hi) * 0.5f);
+        glm::vec3 closestBox = glm::clamp(closestSegment, -box.halfExtents, box.halfExtents);
+        glm::vec3 diff = closestSegment - closestBox;
+        float distance = glm::length(diff);
+
+        manifold.pointCount = 0;
+
+        if (distance > 1e-4f) {
+            // Segment outside the box - a rounded contact like a sphere
+            if (distance > capsule.radius + margin) return false;
+
+            glm::vec3 localNormal = diff / distance;
+            manifold.normal = box.axes * localNormal;
+
+            // A capsule lying along a face gets a point at each end so it doesn't rock
+            for (const glm::vec3& end : { localA, localB }) {
+                glm::vec3 endBox = glm::clamp(end, -box.halfExtents, box.halfExtents);
+                glm::vec3 endDiff = end - endBox;
+                float endDistance = glm::length(endDiff);
+                if (endDistance < 1e-4f || endDistance > capsule.radius + margin) continue;
+                if (glm::dot(endDiff / endDistance, localNormal) < 0.999f) continue;
+
+                glm::vec3 surface = end - localNormal * capsule.radius;
+                manifold.AddPoint(box.ToWorld((surface + endBox) * 0.5f), capsule.radius - endDistance);
+            }
+
+            if (manifold.pointCount == 0) {
+                glm::vec3 surface = closestSegment - localNormal * capsule.radius;
+                manifold.AddPoint(box.ToWorld((surface + closestBox) * 0.5f), capsule.radius - distance);
+            }
+            return true;
+        }
+
+        // Segment passes through the box - SAT over the box faces and box edge x segment axes
+        glm::vec3 axes[6];
+        uint32_t axisCount = 0;
+        for (int i = 0; i < 3; i++) {
+            glm::vec3 axis(0.0f);
+            axis[i] = 1.0f;
+            axes[axisCount++] = axis;
+
+            glm::vec3 edgeAxis = glm::cross(axis, segment);
+            float length = glm::length(edgeAxis);
+            if (length > 1e-5f) axes[axisCount++] = edgeAxis / length;
+        }
+
+        float bestDepth = FLT_MAX;
+        glm::vec3 bestNormal(0.0f, 1.0f, 0.0f);
+        glm::vec3 bestPoint = closestSegment;
+
+        for (uint32_t i = 0; i < axisCount; i++) {
+            const glm::vec3& axis = axes[i];
+            float boxRadius = glm::dot(glm::abs(axis), box.halfExtents);
+            float projA = glm::dot(axis, localA);
+            float projB = glm::dot(axis, localB);
+
+            // Depth to push the capsule out along +axis, then along -axis
+            float depthPositive = boxRadius + capsule.radius - glm::min(projA, projB);
+            float depthNegative = glm::max(projA, projB) + capsule.radius + boxRadius;
+
+            if (depthPositive < bestDepth) {
+                bestDepth = depthPositive;
+                bestNormal = axis;
+                bestPoint = projA < projB ? localA : localB;
+            }
+            if (depthNegative < bestDepth) {
+                bestDepth = depthNegative;
+                bestNormal = -axis;
+                bestPoint = projA > projB ? localA : localB;
+            }
+        }
+
+        manifold.normal = box.axes * bestNormal;
+        manifold.AddPoint(box.ToWorld(bestPoint - bestNormal * (capsule.radius - bestDepth * 0.5f)), bestDepth);
+        return true;
+    }
+
+    // Closest points between segment [p, q] and a triangle
+    static void ClosestPointsSegmentTriangle(const glm::vec3& p, const glm::vec3& q, const Triangle& triangle,
+                                             glm::vec3& closestSegment, glm::vec3& closestTriangle) {
+        glm::vec3 segment = q - p;
+        bool isPoint = glm::dot(segment, segment) < 1e-12f;
+
+        float t;
+        if (!isPoint && triangle.Raycast(p, segment, t) && t <= 1.0f) {
+            closestSegment = p + segment * t;
+            closestTriangle = closestSegment;
+            return;
+        }
+
+        closestSegment = p;
+        closestTriangle = ClosestPointOnTriangle(p, triangle);
+        if (isPoint) return;
+
+        float bestSq = glm::dot(closestSegment - closestTriangle, closestSegment - closestTriangle);
+        auto consider = [&](const glm::vec3& onSegment, const glm::vec3& onTriangle) {
+            float distanceSq = glm::dot(onSegment - onTriangle, onSegment - onTriangle);
+            if (distanceSq < bestSq) {
+                bestSq = distanceSq;
+                closestSegment = onSegment;
+                closestTriangle = onTriangle;
+            }
+        };
+
+        consider(q, ClosestPointOnTriangle(q, triangle));
+
+        const glm::vec3 corners[3] = { triangle.a, triangle.b, triangle.c };
+        for (int i = 0; i < 3; i++) {
+            glm::vec3 onSegment, onEdge;
+            ClosestPointsSegmentSegment(p, q, corners[i], corners[(i + 1) % 3], onSegment, onEdge);
+            consider(onSegment, onEdge);
+        }
+    }
+
+    // Rounded contact between a sphere swept along [p, q] and one triangle. Shapes touching or
+    // crossing the triangle, or behind a one-sided one, are pushed out along the face normal.
+    static bool SweptSphereTriangleContact(const glm::vec3& p, const glm::vec3& q, float radius, const Triangle& triangle,
+                                           bool oneSided, float margin, glm::vec3& normal, glm::vec3& point, float& depth) {
+        glm::vec3 closestSegment, closestTriangle;
+        ClosestPointsSegmentTriangle(p, q, triangle, closestSegment, closestTriangle);
+
+        glm::vec3 diff = closestSegment - closestTriangle;
+        float distance = glm::length(diff);
+        if (distance > radius + margin) return false;
+
+        glm::vec3 faceNormal = triangle.GetNormal();
+        float separation;
+
+        if (distance > 1e-4f && (!oneSided || glm::dot(diff, faceNormal) >= 0.0f)) {
+            normal = diff / distance;
+            separation = distance;
+        } else {
+            float sideP = glm::dot(p - triangle.a, faceNormal);
+            float sideQ = glm::dot(q - triangle.a, faceNormal);
+            if (!oneSided && sideP + sideQ < 0.0f) {
+                faceNormal = -faceNormal;
+                sideP = -sideP;
+                sideQ = -sideQ;
+            }
+
+            // Measured from the end furthest behind the face
+            normal = faceNormal;
+            separation = glm::min(sideP, sideQ);
+            closestSegment = sideP < sideQ ? p : q;
+        }
+
+        depth = radius - separation;
+        point = closestSegment - normal * ((radius + separation) * 0.5f);
+        return true;
+    }
+
+    // The deepest triangle sets the normal. A capsule also gets a point at each end when
+    // both ends rest on (nearly) the same plane, so it lies still across several triangles.
+    static bool CollideSweptSphereGeometry(const glm::vec3& p, const glm::vec3& q, float radius,
+                                           const TriangleGeometry& geometry, float margin, ContactManifold& manifold) {
+        constexpr float COPLANAR_TOLERANCE = 0.99f;
+
+        AABB bounds(glm::min(p, q) - glm::vec3(radius + margin), glm::max(p, q) + glm::vec3(radius + margin));
+        bool oneSided = geometry.IsOneSided();
+        bool isSegment = p != q;
+
+        float bestDepth = -FLT_MAX;
+        glm::vec3 bestNormal(0.0f, 1.0f, 0.0f);
+        glm::vec3 bestPoint(0.0f);
+
+        float endDepth[2] = { -FLT_MAX, -FLT_MAX };
+        glm::vec3 endNormal[2];
+        glm::vec3 endPoint[2];
+
+        geometry.QueryTriangles(bounds, [&](const Triangle& triangle) {
+            glm::vec3 normal, point;
+            float depth;
+
+            if (SweptSphereTriangleContact(p, q, radius, triangle, oneSided, margin, normal, point, depth) && depth > bestDepth) {
+                bestDepth = depth;
+                bestNormal = normal;
+                bestPoint = point;
+            }
+
+            if (!isSegment) return;
+
+            const glm::vec3 ends[2] = { p, q };
+            for (int i = 0; i < 2; i++) {
+                if (SweptSphereTriangleContact(ends[i], ends[i], radius, triangle, oneSided, margin, normal, point, depth) &&
+                    depth > endDepth[i]) {
+                    endDepth[i] = depth;
+                    endNormal[i] = normal;
+                    endPoint[i] = point;
+                }
+            }
+        });
+
+        if (bestDepth == -FLT_MAX) return false;
+
+        manifold.normal = bestNormal;
+        manifold.pointCount = 0;
+
+        for (int i = 0; i < 2 && isSegment; i++) {
+            if (endDepth[i] > -FLT_MAX && glm::dot(endNormal[i], bestNormal) >= COPLANAR_TOLERANCE) {
+                manifold.AddPoint(endPoint[i], endDepth[i]);
+            }
+        }
+
+        if (manifold.pointCount == 0) {
+            manifold.AddPoint(bestPoint, bestDepth);
+        }
+        return true;
+    }
+
+    bool CollideSphereGeometry(const BoundingSphere& sphere, const TriangleGeometry& geometry, float margin, ContactManifold& manifold) {
+        return CollideSweptSphereGeometry(sphere.center, sphere.center, sphere.radius, geometry, margin, manifold);
+    }
+
+    bool CollideCapsuleGeometry(const CapsuleShape& capsule, const TriangleGeometry& geometry, float margin, ContactManifold& manifold) {
+        return CollideSweptSphereGeometry(capsule.a, capsule.b, capsule.radius, geometry, margin, manifold);
+    }
+
+    // Clips the incident box face against the triangle's edge planes
+    static bool ClipToTriangleFace(const Triangle& triangle, const glm::vec3& refNormal, const OrientedBox& box,
+                                   float margin, ContactManifold& manifold) {
+        // Room for the 4 corners plus one new vertex per clip plane
+        glm::vec3 polygon[8];
+        glm::vec3 clipped[8];
+        GetIncidentFace(box, refNormal, polygon);
+        uint32_t count = 4;
+
+        const glm::vec3 corners[3] = { triangle.a, triangle.b, triangle.c };
+        glm::vec3 faceNormal = triangle.GetNormal();
+
+        for (int i = 0; i < 3; i++) {
+            // Counter-clockwise winding, so edge x normal points out of the triangle
+            glm::vec3 outward = glm::cross(corners[(i + 1) % 3] - corners[i], faceNormal);
+            count = ClipPolygon(polygon, count, outward, glm::dot(outward, corners[i]), clipped);
+            std::copy(clipped, clipped + count, polygon);
+        }
+
+        float faceOffset = glm::dot(refNormal, triangle.a);
+
+        glm::vec3 points[8];
+        float depths[8];
+        uint32_t pointCount = 0;
+
+        for (uint32_t i = 0; i < count; i++) {
+            float depth = faceOffset - glm::dot(refNormal, polygon[i]);
+            if (depth < -margin) continue;
+
+            points[pointCount] = polygon[i] + refNormal * (depth * 0.5f);
+            depths[pointCount] = depth;
+            pointCount++;
+        }
+
+        if (pointCount == 0) return false;
+
+        ReduceManifold(points, depths, pointCount, manifold);
+        return true;
+    }
+
+    // SAT over the triangle normal, the box faces and the box edge x triangle edge axes,
+    // with the same feature preference as CollideBoxes
+    static bool CollideBoxTriangle(const OrientedBox& box, const Triangle& triangle, bool oneSided,
+                                   float margin, ContactManifold& manifold) {
+        constexpr float RELATIVE_TOLERANCE = 0.98f;
+        constexpr float ABSOLUTE_TOLERANCE = 0.001f;
+
+        const glm::vec3 corners[3] = { triangle.a, triangle.b, triangle.c };
+        glm::vec3 faceNormal = triangle.GetNormal();
+
+        float bestSeparation = -FLT_MAX;
+        int bestAxis = -1;
+        glm::vec3 bestNormal(0.0f);
+
+        auto testAxis = [&](const glm::vec3& axis, int index, bool preferExisting, bool positiveOnly) {
+            float boxCenter = glm::dot(axis, box.center);
+            float boxRadius = 0.0f;
+            for (int k = 0; k < 3; k++) {
+                boxRadius += box.halfExtents[k] * glm::abs(glm::dot(box.axes[k], axis));
+            }
+
+            float triangleMin = FLT_MAX;
+            float triangleMax = -FLT_MAX;
+            for (const glm::vec3& corner : corners) {
+                float d = glm::dot(axis, corner);
+                triangleMin = glm::min(triangleMin, d);
+                triangleMax = glm::max(triangleMax, d);
+            }
+
+            // Separation with the box on the positive side of the axis, then on the negative side
+            float positive = boxCenter - boxRadius - triangleMax;
+            float negative = triangleMin - boxCenter - boxRadius;
+            bool onPositive = positiveOnly || positive >= negative;
+            float separation = onPositive ? positive : negative;
+            if (separation > margin) return false;
+
+            bool better = preferExisting
+                ? separation > RELATIVE_TOLERANCE * bestSeparation + ABSOLUTE_TOLERANCE
+                : separation > bestSeparation;
+
+            if (bestAxis < 0 || better) {
+                bestSeparation = separation;
+                bestAxis = index;
+                bestNormal = onPositive ? axis : -axis;
+            }
+            return true;
+        };
+
+        if (!testAxis(faceNormal, 0, false, oneSided)) return false;
+
+        for (int i = 0; i < 3; i++) {
+            if (!testAxis(box.axes[i], 1 + i, true, false)) return false;
+        }
+
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                glm::vec3 axis = glm::cross(box.axes[i], corners[(j + 1) % 3] - corners[j]);
+                float length = glm::length(axis);
+                if (length < 1e-5f) continue;
+
+                if (!testAxis(axis / length, 4 + i * 3 + j, true, false)) return false;
+            }
+        }
+
+        manifold.normal = bestNormal;
+        manifold.pointCount = 0;
+
+        if (bestAxis == 0) {
+            return ClipToTriangleFace(triangle, bestNormal, box, margin, manifold);
+        }
+        if (bestAxis < 4) {
+            // Reference face on the box faces the triangle, against the triangle->box normal
+            glm::vec3 polygon[8] = { triangle.a, triangle.b, triangle.c };
+            return ClipToBoxFace(box, bestAxis - 1, -bestNormal, polygon, 3, margin, manifold);
+        }
+
+        // Edge-edge: the box edge nearest the triangle against the triangle edge
+        int boxEdge = (bestAxis - 4) / 3;
+        int triangleEdge = (bestAxis - 4) % 3;
+
+        glm::vec3 edgeCenter = box.center;
+        for (int k = 0; k < 3; k++) {
+            if (k != boxEdge) edgeCenter += box.axes[k] * (box.halfExtents[k] * (glm::dot(box.axes[k], bestNormal) > 0.0f ? -1.0f : 1.0f));
+        }
+        glm::vec3 halfEdge = box.axes[boxEdge] * box.halfExtents[boxEdge];
+
+        glm::vec3 closestBox, closestTriangle;
+        ClosestPointsSegmentSegment(edgeCenter - halfEdge, edgeCenter + halfEdge,
+                                    corners[triangleEdge], corners[(triangleEdge + 1) % 3], closestBox, closestTriangle);
+
+        manifold.AddPoint((closestBox + closestTriangle) * 0.5f, -bestSeparation);
+        return true;
+    }
+
+    bool CollideBoxGeometry(const OrientedBox& box, const TriangleGeometry& geometry, float margin, ContactManifold& manifold) {
+        constexpr float COPLANAR_TOLERANCE = 0.99f;
+        constexpr uint32_t MAX_GATHERED = 32;
+
+        AABB bounds = box.GetAABB();
+        bounds = AABB(bounds.min - glm::vec3(margin), bounds.max + glm::vec3(margin));
+        bool oneSided = geometry.IsOneSided();
+
+        // Every triangle's contacts are gathered; the deepest triangle picks the normal and
+        // points from triangles facing (nearly) the same way are merged into one manifold
+        glm::vec3 points[MAX_GATHERED];
+        glm::vec3 normals[MAX_GATHERED];
+        float depths[MAX_GATHERED];
+        uint32_t count = 0;
+
+        float bestDepth = -FLT_MAX;
+        glm::vec3 bestNormal(0.0f, 1.0f, 0.0f);
+
+        geometry.QueryTriangles(bounds, [&](const Triangle& triangle) {
+            ContactManifold contact;
+            if (!CollideBoxTriangle(box, triangle, oneSided, margin, contact)) return;
+
+            if (contact.GetMaxDepth() > bestDepth) {
+                bestDepth = contact.GetMaxDepth();
+                bestNormal = contact.normal;
+            }
+
+            for (uint32_t i = 0; i < contact.pointCount; i++) {
+                uint32_t slot = count;
+                if (count == MAX_GATHERED) {
+                    // Full - replace the shallowest point if this one is deeper
+                    slot = static_cast<uint32_t>(std::min_element(depths, depths + count) - depths);
+                    if (depths[slot] >= contact.depths[i]) continue;
+                } else {
+                    count++;
+                }
+
+                points[slot] = contact.points[i];
+                normals[slot] = contact.normal;
+                depths[slot] = contact.depths[i];
+            }
+        });
+
+        if (count == 0) return false;
+
+        uint32_t kept = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            if (glm::dot(normals[i], bestNormal) < COPLANAR_TOLERANCE) continue;
+            points[kept] = points[i];
+            depths[kept] = depths[i];
+            kept++;
+        }
+
+        manifold.normal = bestNormal;
+        ReduceManifold(points, depths, kept, manifold);
+        return true;
+    }
+
+    // Dispatch table
+
+    using CollideFunc = bool(*)(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& manifold);
+
+    static bool BoxBox(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        return CollideBoxes(a.box, b.box, margin, m);
+    }
+
+    static bool SphereSphere(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        return CollideSpheres(a.sphere, b.sphere, margin, m);
+    }
+
+    static bool SphereBox(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        return CollideSphereBox(a.sphere, b.box, margin, m);
+    }
+
+    static bool CapsuleSphere(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        return CollideCapsuleSphere(a.capsule, b.sphere, margin, m);
+    }
+
+    static bool CapsuleCapsule(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        return CollideCapsules(a.capsule, b.capsule, margin, m);
+    }
+
+    static bool CapsuleBox(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        return CollideCapsuleBox(a.capsule, b.box, margin, m);
+    }
+
+    static bool SphereGeometry(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        return CollideSphereGeometry(a.sphere, b.geometry, margin, m);
+    }
+
+    static bool CapsuleGeometry(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        return CollideCapsuleGeometry(a.capsule, b.geometry, margin, m);
+    }
+
+    static bool BoxGeometry(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        return CollideBoxGeometry(a.box, b.geometry, margin, m);
+    }
+
+    // Triangle geometry is static, so two pieces of it never need contacts
+    static bool NoContact(const WorldShape&, const WorldShape&, float, ContactManifold&) {
+        return false;
+    }
+
+    // Runs a test written for (B, A) and turns the result around
+    template<CollideFunc Func>
+    static bool Flipped(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& m) {
+        if (!Func(b, a, margin, m)) return false;
+        m.normal = -m.normal;
+        return true;
+    }
+
+    // Indexed by [ColliderType of A][ColliderType of B] - Box, Sphere, Capsule, Mesh, Heightfield
+    static constexpr CollideFunc s_CollideTable[5][5] = {
+        { BoxBox,                  Flipped<SphereBox>,     Flipped<CapsuleBox>,     BoxGeometry,     BoxGeometry },
+        { SphereBox,               SphereSphere,           Flipped<CapsuleSphere>,  SphereGeometry,  SphereGeometry },
+        { CapsuleBox,              CapsuleSphere,          CapsuleCapsule,          CapsuleGeometry, CapsuleGeometry },
+        { Flipped<BoxGeometry>,    Flipped<SphereGeometry>, Flipped<CapsuleGeometry>, NoContact,     NoContact },
+        { Flipped<BoxGeometry>,    Flipped<SphereGeometry>, Flipped<CapsuleGeometry>, NoContact,     NoContact },
+    };
+
+    bool Collide(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& manifold) {
+        CollideFunc func = s_CollideTable[static_cast<int>(a.type)][static_cast<int>(b.type)];
+        return func(a, b, margin, manifold);
+    }
+
+}
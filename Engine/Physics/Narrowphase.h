@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Shapes.h"
+#include <cstdint>
+
+namespace Xi {
+
+    // Up to four contact points sharing one normal
+    struct ContactManifold {
+        static constexpr uint32_t MAX_POINTS = 4;
+
+        glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);  // Points from B towards A
+        glm::vec3 points[MAX_POINTS];                    // Midway between the two surfaces
+        float depths[MAX_POINTS] = {};                   // Negative while separated (speculative)
+        uint32_t pointCount = 0;
+
+        void AddPoint(const glm::vec3& point, float depth);
+
+        float GetMaxDepth() const;
+        glm::vec3 GetDeepestPoint() const;
+        glm::vec3 GetCenter() const;
+    };
+
+    // Generates contacts between two shapes closer than margin. The manifold is always
+    // expressed in the A/B order given, whichever way round the table stores the test.
+    bool Collide(const WorldShape& a, const WorldShape& b, float margin, ContactManifold& manifold);
+
+    bool CollideSpheres(const BoundingSphere& a, const BoundingSphere& b, float margin, ContactManifold& manifold);
+    bool CollideSphereBox(const BoundingSphere& sphere, const OrientedBox& box, float margin, ContactManifold& manifold);
+    bool CollideBoxes(const OrientedBox& a, const OrientedBox& b, float margin, ContactManifold& manifold);
+    bool CollideCapsuleSphere(const CapsuleShape& capsule, const BoundingSphere& sphere, float margin, ContactManifold& manifold);
+    bool CollideCapsuleBox(const CapsuleShape& capsule, const OrientedBox& box, float margin, ContactManifold& manifold);
+    bool CollideCapsules(const CapsuleShape& a, const CapsuleShape& b, float margin, ContactManifold& manifold);
+
+    // Triangle geometry is always B, the normal points from the surface towards the shape
+    bool CollideSphereGeometry(const BoundingSphere& sphere, const TriangleGeometry& geometry, float margin, ContactManifold& manifold);
+    bool CollideCapsuleGeometry(const CapsuleShape& capsule, const TriangleGeometry& geometry, float margin, ContactManifold& manifold);
+    bool CollideBoxGeometry(const OrientedBox& box, const TriangleGeometry& geometry, float margin, ContactManifold& manifold);
+
+}
@@ -0,0 +1,131 @@
+#include "PhysicsSystem.h"
+#include "PhysicsWorld.h"
+#include "../ECS/World.h"
+
+#include <chrono>
+
+namespace Xi {
+
+    PhysicsSystem::PhysicsSystem(PhysicsWorld* physics)
+        : m_Physics(physics) {}
+
+    PhysicsSystem::~PhysicsSystem() {
+        Sync();
+
+        if (m_Thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Quit = true;
+            }
+            m_WorkReady.notify_one();
+            m_Thread.join();
+        }
+    }
+
+    void PhysicsSystem::SetAsync(bool async) {
+        Sync();
+        m_Async = async;
+    }
+
+    void PhysicsSystem::QueueStep(float fixedDt) {
+        if (m_Enabled) {
+            m_QueuedSteps.push_back(fixedDt);
+        }
+    }
+
+    void PhysicsSystem::Update(World& world, float dt) {
+        (void)dt;
+        if (!m_Physics) return;
+
+        // Normally a no-op: the application syncs at the start of the frame
+        Sync();
+
+        // Goes with the steps handed out below, even none, and is published with their poses.
+        // Without async they run and publish here.
+        m_PendingAlpha = m_QueuedAlpha;
+        if (!m_Async) {
+            m_InterpolationAlpha = m_PendingAlpha;
+        }
+
+        m_Physics->SetWorld(&world);
+        if (m_QueuedSteps.empty()) {
+            // Nothing publishes this frame, so transforms changed from outside have to be
+            // picked up here or their bodies keep drawing at the last stepped pose
+            m_Physics->RefreshPublishedPoses();
+            return;
+        }
+
+        std::swap(m_ActiveSteps, m_QueuedSteps);
+        m_QueuedSteps.clear();
+
+        if (!m_Async) {
+            RunSteps();
+            m_Physics->PublishPoses();
+            return;
+        }
+
+        m_Physics->PublishNewBodies();
+
+        if (!m_Thread.joinable()) {
+            m_Thread = std::thread(&PhysicsSystem::ThreadLoop, this);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_HasWork = true;
+        }
+        m_Stepping = true;
+        m_WorkReady.notify_one();
+    }
+
+    void PhysicsSystem::Sync() {
+        // The published poses end with the steps handed out by the last Update, or earlier ones
+        // if it had none, so they go with the alpha it set
+        m_InterpolationAlpha = m_PendingAlpha;
+
+        if (m_Stepping) {
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WorkDone.wait(lock, [this] { return !m_HasWork; });
+            }
+            m_Stepping = false;
+            m_Physics->PublishPoses();
+        }
+
+        // Nothing steps while disabled, so the last published poses would never follow the transforms
+        if (!m_Enabled && m_Physics) {
+            m_Physics->ClearPublishedPoses();
+        }
+    }
+
+    void PhysicsSystem::ThreadLoop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WorkReady.wait(lock, [this] { return m_Quit || m_HasWork; });
+                if (m_Quit) return;
+            }
+
+            RunSteps();
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_HasWork = false;
+            }
+            m_WorkDone.notify_one();
+        }
+    }
+
+    void PhysicsSystem::RunSteps() {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (float fixedDt : m_ActiveSteps) {
+            m_Physics->Step(fixedDt);
+        }
+
+        m_LastStepCount = static_cast<uint32_t>(m_ActiveSteps.size());
+        m_LastStepTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        m_ActiveSteps.clear();
+    }
+
+}
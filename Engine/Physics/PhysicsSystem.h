@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../ECS/System.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Xi {
+
+    class PhysicsWorld;
+    class World;
+
+    // Steps the physics world from the ECS. Fixed steps are queued during the frame and run
+    // together when the system updates, after the systems registered before it. In async mode
+    // they run on a dedicated thread while the main thread renders the previously published
+    // poses, and Sync() is the point where the results are handed back.
+    //
+    // Between Update and Sync the step owns the bodies' transforms and rigid bodies and every
+    // collider. The main thread may read other components but must not add components,
+    // create or destroy entities, or touch anything the step owns.
+    class PhysicsSystem : public System {
+    public:
+        explicit PhysicsSystem(PhysicsWorld* physics);
+        ~PhysicsSystem() override;
+
+        // System interface
+        void Update(World& world, float dt) override;
+
+        // Runs one step of fixedDt on the next Update. Ignored while the system is disabled.
+        void QueueStep(float fixedDt);
+
+        // How far the current time is past the last queued step, as a fraction of a step.
+        // Set once per frame after queuing, before Update.
+        void SetQueuedAlpha(float alpha) { m_QueuedAlpha = alpha; }
+
+        // Waits for the steps in flight and publishes their poses for rendering. Cheap when
+        // nothing is running. While disabled it drops the published poses instead, so bodies
+        // render at their transforms.
+        void Sync();
+
+        void SetAsync(bool async);
+        bool IsAsync() const { return m_Async; }
+        bool IsStepping() const { return m_Stepping; }
+
+        // Alpha for PhysicsWorld::GetInterpolatedMatrix that matches the published poses. In
+        // async mode they are a frame behind the steps just queued, so this is the fixed step
+        // fraction left over when they were queued, and the drawn time stays one frame and one
+        // step behind however many steps each frame queues.
+        float GetInterpolationAlpha() const { return m_InterpolationAlpha; }
+
+        uint32_t GetLastStepCount() const { return m_LastStepCount; }
+        float GetLastStepTime() const { return m_LastStepTime; }  // Milliseconds for all steps of the last update
+
+    private:
+        void ThreadLoop();
+        void RunSteps();
+
+        PhysicsWorld* m_Physics = nullptr;
+        bool m_Async = true;
+        bool m_Stepping = false;  // Main thread view: steps handed out and not synced yet
+
+        std::vector<float> m_QueuedSteps;  // Filled on the main thread
+        std::vector<float> m_ActiveSteps;  // Owned by whichever thread is stepping
+
+        float m_QueuedAlpha = 0.0f;
+        float m_PendingAlpha = 0.0f;  // Set with the steps handed out, taken by Sync
+        float m_InterpolationAlpha = 0.0f;
+
+        uint32_t m_LastStepCount = 0;
+        float m_LastStepTime = 0.0f;
+
+        std::thread m_Thread;
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkReady;
+        std::condition_variable m_WorkDone;
+        bool m_HasWork = false;
+        bool m_Quit = false;
+    };
+
+}
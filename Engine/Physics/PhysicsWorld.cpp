@@ -4,8 +4,11 @@
 #include "../ECS/Components/Collider.h"
 #include "../ECS/Components/RigidBody.h"
 #include "../Core/Log.h"
+#include "../Core/JobSystem.h"
 
 #include <algorithm>
+#include <bit>
+#include <chrono>
 
 namespace Xi {
 
@@ -15,252 +18,943 @@ namespace Xi {
 
     PhysicsWorld::~PhysicsWorld() = default;
 
+    void PhysicsWorld::SetWorld(World* world) {
+        uint32_t clearCount = world ? world->GetClearCount() : 0;
+        if (world == m_World && clearCount == m_WorldClearCount) return;
+
+        m_World = world;
+        m_WorldClearCount = clearCount;
+        m_ContactCache.Clear();
+        ClearPublishedPoses();
+
+        m_Bodies.clear();
+        m_BodyLookup.clear();
+        m_BodyState.Resize(0);
+        m_BodiesSynced = false;
+    }
+
+    using StatClock = std::chrono::high_resolution_clock;
+
+    static float MillisecondsSince(StatClock::time_point start) {
+        return std::chrono::duration<float, std::milli>(StatClock::now() - start).count();
+    }
+
+    template<typename T>
+    static size_t GetCapacityBytes(const std::vector<T>& v) {
+        return v.capacity() * sizeof(T);
+    }
+
     void PhysicsWorld::Step(float dt) {
         if (!m_World) return;
 
-        IntegratePhysics(dt);
+        m_DeltaTime = dt;
+
+        auto stepStart = StatClock::now();
+        GatherBodies(dt);
+        IntegrateVelocities();
+        m_StepStats.integrateMs = MillisecondsSince(stepStart);
+
         DetectCollisions();
-        ResolveCollisions();
+
+        auto solveStart = StatClock::now();
+        BuildIslands();
+        SolveContacts(dt);
+        m_StepStats.solveMs = MillisecondsSince(solveStart);
+
+        auto integrateStart = StatClock::now();
+        IntegratePositions();
+        m_StepStats.integrateMs += MillisecondsSince(integrateStart);
+
+        UpdateSleeping(dt);
+        StorePoses();
+        m_StepCount++;
+
+        m_StepStats.totalMs = MillisecondsSince(stepStart);
+        m_StepStats.bodyCount = static_cast<uint32_t>(m_Bodies.size());
+        m_StepStats.colliderCount = static_cast<uint32_t>(m_Proxies.size());
+        m_StepStats.broadphasePairs = static_cast<uint32_t>(m_Candidates.size());
+        m_StepStats.contactCount = static_cast<uint32_t>(m_Collisions.size());
+        m_StepStats.islandCount = static_cast<uint32_t>(m_Islands.size());
+
+        if (m_ContactEventCallback) {
+            m_ContactEventCallback(m_ContactEvents);
+        }
     }
 
-    void PhysicsWorld::IntegratePhysics(float dt) {
-        auto* transformPool = m_World->GetComponentPool<Transform>();
+    // The body list only changes when rigid bodies or transforms are added or removed, which
+    // is also the only time their components can move in memory
+    void PhysicsWorld::SyncBodies() {
         auto* rigidBodyPool = m_World->GetComponentPool<RigidBody>();
+        auto* transformPool = m_World->GetComponentPool<Transform>();
+        uint32_t rigidBodyVersion = rigidBodyPool ? rigidBodyPool->GetVersion() : 0;
+        uint32_t transformVersion = transformPool ? transformPool->GetVersion() : 0;
+
+        if (m_BodiesSynced && rigidBodyVersion == m_RigidBodyPoolVersion && transformVersion == m_TransformPoolVersion) return;
+
+        m_BodiesSynced = true;
+        m_RigidBodyPoolVersion = rigidBodyVersion;
+        m_TransformPoolVersion = transformVersion;
+        m_RenderLookupCurrent = false;
+
+        // Removed bodies are replaced by the last one, like the component pools do
+        for (uint32_t i = 0; i < m_Bodies.size();) {
+            Entity entity = m_Bodies[i].entity;
+            if (m_World->HasComponent<RigidBody>(entity) && m_World->HasComponent<Transform>(entity)) {
+                m_Bodies[i].rigidBody = &rigidBodyPool->Get(entity);
+                m_Bodies[i].transform = &transformPool->Get(entity);
+                i++;
+                continue;
+            }
 
-        if (!transformPool || !rigidBodyPool) return;
+            uint32_t last = static_cast<uint32_t>(m_Bodies.size()) - 1;
+            m_BodyLookup.erase(entity);
+            if (i != last) {
+                m_Bodies[i] = m_Bodies[last];
+                m_BodyLookup[m_Bodies[i].entity] = i;
+                m_BodyState.Move(last, i);
+            }
+            m_Bodies.pop_back();
+        }
 
-        for (Entity entity : rigidBodyPool->GetEntities()) {
-            if (!m_World->HasComponent<Transform>(entity)) continue;
+        if (rigidBodyPool) {
+            auto& entities = rigidBodyPool->GetEntities();
+            auto& rigidBodies = rigidBodyPool->GetComponents();
 
-            Transform& transform = m_World->GetComponent<Transform>(entity);
-            RigidBody& rb = m_World->GetComponent<RigidBody>(entity);
+            for (size_t i = 0; i < entities.size(); i++) {
+                Entity entity = entities[i];
+                if (m_BodyLookup.count(entity) || !m_World->HasComponent<Transform>(entity)) continue;
 
-            if (rb.type == RigidBodyType::Static) continue;
+                BodyRef body;
+                body.entity = entity;
+                body.rigidBody = &rigidBodies[i];
+                body.transform = &transformPool->Get(entity);
 
-            // Apply gravity
-            if (rb.useGravity && rb.type == RigidBodyType::Dynamic) {
-                rb.force += rb.gravity * rb.mass;
+                m_BodyLookup[entity] = static_cast<uint32_t>(m_Bodies.size());
+                m_Bodies.push_back(body);
             }
+        }
+
+        m_BodyState.Resize(static_cast<uint32_t>(m_Bodies.size()));
+    }
+
+    void PhysicsWorld::GatherBodies(float dt) {
+        m_LODBodyCounts.fill(0);
+        SyncBodies();
+
+        m_PreviousPoses.resize(m_Bodies.size());
+        m_BodyState.ClearPseudoVelocities();
+
+        for (uint32_t i = 0; i < m_Bodies.size(); i++) {
+            RigidBody& rb = *m_Bodies[i].rigidBody;
+            const Transform& transform = *m_Bodies[i].transform;
+
+            if (rb.isSleeping && rb.type != RigidBodyType::Static) {
+                // Sleeping bodies have zero velocity; anything else was applied from outside
+                bool disturbed = rb.force != glm::vec3(0.0f) || rb.torque != glm::vec3(0.0f) ||
+                                 rb.velocity != glm::vec3(0.0f) || rb.angularVelocity != glm::vec3(0.0f);
+                if (disturbed) rb.WakeUp();
+            }
+
+            // Bodies at a reduced rate sit most steps out and take a longer one on their turn
+            float timeStep = dt;
+            if (rb.type == RigidBodyType::Dynamic) {
+                timeStep = UpdateSimulationLOD(m_Bodies[i].entity, rb, transform.position, dt);
+            }
+
+            uint32_t flags = 0;
+            if (rb.type != RigidBodyType::Static && !rb.isSleeping && timeStep > 0.0f) {
+                flags |= BODY_INTEGRATE_POSITION;
+                if (rb.type == RigidBodyType::Dynamic && rb.mass > 0.0f) flags |= BODY_INTEGRATE_VELOCITY;
+            }
+            if (!rb.freezePositionX) flags |= BODY_MOVE_X;
+            if (!rb.freezePositionY) flags |= BODY_MOVE_Y;
+            if (!rb.freezePositionZ) flags |= BODY_MOVE_Z;
+
+            // A contact may still wake a resting body this step, so these are always current
+            m_PreviousPoses[i] = { transform.position, transform.rotation };
+            m_BodyState.SetPosition(i, transform.position);
+            m_BodyState.SetVelocity(i, rb.velocity);
+            m_BodyState.timeStep[i] = timeStep;
+            m_BodyState.flags[i] = flags;
+
+            // The rest only feeds velocity integration, which static and sleeping bodies skip
+            if (rb.type == RigidBodyType::Static || rb.isSleeping) continue;
+
+            m_BodyState.forceX[i] = rb.force.x;
+            m_BodyState.forceY[i] = rb.force.y;
+            m_BodyState.forceZ[i] = rb.force.z;
+            m_BodyState.SetAcceleration(i, rb.useGravity ? rb.gravity : glm::vec3(0.0f));
+            m_BodyState.invMass[i] = rb.mass > 0.0f ? 1.0f / rb.mass : 0.0f;
+            m_BodyState.damping[i] = 1.0f - rb.drag * timeStep;
+        }
+    }
+
+    // Returns how far the body steps this step, 0 if it sits this one out
+    float PhysicsWorld::UpdateSimulationLOD(Entity entity, RigidBody& rb, const glm::vec3& position, float dt) {
+        if (rb.lodPromoted) {
+            rb.lodPromoted = false;
+            rb.lodLevel = 0;
+            rb.lodHoldTimer = m_LODSettings.promotionTime;
+        }
+
+        // Steps missed while waiting for its turn are made up in one
+        float timeStep = dt * static_cast<float>(rb.lodSkippedSteps + 1);
+
+        if (!m_LODSettings.enabled || m_LODViewers.empty() || rb.isSleeping) {
+            rb.lodLevel = 0;
+            rb.lodSkippedSteps = 0;
+            m_LODBodyCounts[0]++;
+            return timeStep;
+        }
+
+        if (rb.lodHoldTimer > 0.0f) {
+            rb.lodHoldTimer -= dt;
+        } else {
+            float distanceSq = std::numeric_limits<float>::max();
+            for (const glm::vec3& viewer : m_LODViewers) {
+                glm::vec3 offset = position - viewer;
+                distanceSq = glm::min(distanceSq, glm::dot(offset, offset));
+            }
+
+            auto beyond = [distanceSq](float distance) { return distanceSq >= distance * distance; };
+            if (beyond(m_LODSettings.freezeDistance)) rb.lodLevel = SIMULATION_LOD_FROZEN;
+            else if (beyond(m_LODSettings.eighthRateDistance)) rb.lodLevel = 3;
+            else if (beyond(m_LODSettings.quarterRateDistance)) rb.lodLevel = 2;
+            else if (beyond(m_LODSettings.halfRateDistance)) rb.lodLevel = 1;
+            else rb.lodLevel = 0;
+        }
+        m_LODBodyCounts[rb.lodLevel]++;
+
+        // Frozen bodies don't bank time, or they would jump when they thaw
+        if (rb.lodLevel == SIMULATION_LOD_FROZEN) {
+            rb.lodSkippedSteps = 0;
+            return 0.0f;
+        }
+
+        // Offsetting by entity spreads bodies of the same level over the steps
+        uint32_t period = 1u << rb.lodLevel;
+        if ((m_StepCount + entity) % period != 0) {
+            rb.lodSkippedSteps++;
+            return 0.0f;
+        }
+
+        rb.lodSkippedSteps = 0;
+        return timeStep;
+    }
+
+    // A moving body at full rate brings a slower body it touches back to full rate, joining
+    // this step if it was sitting it out
+    void PhysicsWorld::PromoteOnContact(uint32_t body, uint32_t other) {
+        if (body == INVALID_BODY || other == INVALID_BODY) return;
+
+        const RigidBody& rb = *m_Bodies[body].rigidBody;
+        RigidBody& otherRb = *m_Bodies[other].rigidBody;
+        if (otherRb.type != RigidBodyType::Dynamic || otherRb.lodLevel == 0) return;
+        if (rb.type == RigidBodyType::Static || rb.isSleeping || rb.lodLevel != 0) return;
+
+        glm::vec3 velocity = m_BodyState.GetVelocity(body);
+        float threshold = m_SleepSettings.linearThreshold;
+        if (glm::dot(velocity, velocity) < threshold * threshold) return;
+
+        otherRb.lodLevel = 0;
+        otherRb.lodHoldTimer = m_LODSettings.promotionTime;
+        if (m_BodyState.timeStep[other] == 0.0f) {
+            otherRb.lodSkippedSteps = 0;
+            m_BodyState.timeStep[other] = m_DeltaTime;
+        }
+    }
+
+    // Approximate: hash map nodes are counted as their value plus two pointers
+    size_t PhysicsWorld::GetMemoryUsage() const {
+        size_t bytes = 0;
+        bytes += GetCapacityBytes(m_Bodies) + GetCapacityBytes(m_Proxies) + GetCapacityBytes(m_BodyProxies);
+        bytes += GetCapacityBytes(m_Candidates) + GetCapacityBytes(m_Collisions) + GetCapacityBytes(m_CollisionPairs);
+        bytes += GetCapacityBytes(m_SolverBodies) + GetCapacityBytes(m_SolverContacts);
+        bytes += GetCapacityBytes(m_PreviousPoses) + GetCapacityBytes(m_CurrentPoses);
+        bytes += GetCapacityBytes(m_RenderPreviousPoses) + GetCapacityBytes(m_RenderCurrentPoses);
+
+        for (const auto& batch : m_CandidateBatches) bytes += GetCapacityBytes(batch);
+        for (const auto& layer : m_LayerProxies) bytes += GetCapacityBytes(layer);
+        for (const Island& island : m_Islands) bytes += GetCapacityBytes(island.bodies) + GetCapacityBytes(island.contacts);
+        bytes += GetCapacityBytes(m_Islands);
+
+        // Every BodyState array has the same padded length
+        bytes += static_cast<size_t>(m_BodyState.capacity) * (18 * sizeof(float) + sizeof(uint32_t));
+
+        size_t nodeOverhead = 2 * sizeof(void*);
+        bytes += m_ContactCache.Size() * (sizeof(std::pair<const uint64_t, ContactPair>) + nodeOverhead);
+        bytes += (m_BodyLookup.size() + m_RenderLookup.size()) * (sizeof(std::pair<const Entity, uint32_t>) + nodeOverhead);
+        return bytes;
+    }
+
+    void PhysicsWorld::StorePoses() {
+        m_CurrentPoses.resize(m_Bodies.size());
+        for (uint32_t i = 0; i < m_Bodies.size(); i++) {
+            m_CurrentPoses[i] = { m_Bodies[i].transform->position, m_Bodies[i].transform->rotation };
+        }
+        m_PosesChanged = true;
+    }
+
+    // The next step refills both back buffers, so swapping is enough
+    void PhysicsWorld::PublishPoses() {
+        if (!m_PosesChanged) return;
+
+        std::swap(m_RenderPreviousPoses, m_PreviousPoses);
+        std::swap(m_RenderCurrentPoses, m_CurrentPoses);
+        if (!m_RenderLookupCurrent) {
+            m_RenderLookup = m_BodyLookup;
+            m_RenderLookupCurrent = true;
+        }
+        m_PosesChanged = false;
+    }
+
+    void PhysicsWorld::PublishNewBodies() {
+        if (!m_World) return;
+
+        auto* rigidBodyPool = m_World->GetComponentPool<RigidBody>();
+        if (!rigidBodyPool) return;
+
+        for (Entity entity : rigidBodyPool->GetEntities()) {
+            if (m_RenderLookup.count(entity) || !m_World->HasComponent<Transform>(entity)) continue;
+
+            const Transform& transform = m_World->GetComponent<Transform>(entity);
+            m_RenderLookupCurrent = false;
+            m_RenderLookup[entity] = static_cast<uint32_t>(m_RenderCurrentPoses.size());
+            m_RenderPreviousPoses.push_back({ transform.position, transform.rotation });
+            m_RenderCurrentPoses.push_back({ transform.position, transform.rotation });
+        }
+    }
 
-            // Integrate velocity
-            if (rb.type == RigidBodyType::Dynamic && rb.mass > 0.0f) {
-                glm::vec3 acceleration = rb.force / rb.mass;
-                rb.velocity += acceleration * dt;
+    void PhysicsWorld::RefreshPublishedPoses() {
+        if (!m_World) {
+            ClearPublishedPoses();
+            return;
+        }
+
+        for (auto it = m_RenderLookup.begin(); it != m_RenderLookup.end();) {
+            Entity entity = it->first;
+            if (!m_World->HasComponent<RigidBody>(entity) || !m_World->HasComponent<Transform>(entity)) {
+                it = m_RenderLookup.erase(it);
+                m_RenderLookupCurrent = false;
+                continue;
+            }
 
-                // Apply drag
-                rb.velocity *= (1.0f - rb.drag * dt);
+            // Published current poses are copies of the transforms, so any difference came from outside
+            const Transform& transform = m_World->GetComponent<Transform>(entity);
+            BodyPose& current = m_RenderCurrentPoses[it->second];
+            if (current.position != transform.position || current.rotation != transform.rotation) {
+                current = { transform.position, transform.rotation };
+                m_RenderPreviousPoses[it->second] = current;
             }
+            ++it;
+        }
+    }
+
+    void PhysicsWorld::ClearPublishedPoses() {
+        m_RenderPreviousPoses.clear();
+        m_RenderCurrentPoses.clear();
+        m_RenderLookup.clear();
+        m_RenderLookupCurrent = false;
+    }
+
+    // Same rotation order as Transform::GetMatrix
+    static glm::quat EulerToQuat(const glm::vec3& degrees) {
+        glm::vec3 r = glm::radians(degrees);
+        return glm::angleAxis(r.x, glm::vec3(1.0f, 0.0f, 0.0f)) *
+               glm::angleAxis(r.y, glm::vec3(0.0f, 1.0f, 0.0f)) *
+               glm::angleAxis(r.z, glm::vec3(0.0f, 0.0f, 1.0f));
+    }
+
+    glm::mat4 PhysicsWorld::GetInterpolatedMatrix(Entity entity, const Transform& transform, float alpha) const {
+        auto it = m_RenderLookup.find(entity);
+        if (it == m_RenderLookup.end()) return transform.GetMatrix();
+
+        const BodyPose& previous = m_RenderPreviousPoses[it->second];
+        const BodyPose& current = m_RenderCurrentPoses[it->second];
+
+        glm::vec3 position = glm::mix(previous.position, current.position, alpha);
+        glm::quat rotation = glm::slerp(EulerToQuat(previous.rotation), EulerToQuat(current.rotation), alpha);
+
+        glm::mat4 matrix = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation);
+        return glm::scale(matrix, transform.scale);
+    }
+
+    uint32_t PhysicsWorld::FindBody(Entity entity) const {
+        auto it = m_BodyLookup.find(entity);
+        return it != m_BodyLookup.end() ? it->second : INVALID_BODY;
+    }
 
-            // Integrate position
-            if (!rb.freezePositionX) transform.position.x += rb.velocity.x * dt;
-            if (!rb.freezePositionY) transform.position.y += rb.velocity.y * dt;
-            if (!rb.freezePositionZ) transform.position.z += rb.velocity.z * dt;
+    void PhysicsWorld::WakeBody(uint32_t body) {
+        if (body != INVALID_BODY) {
+            m_Bodies[body].rigidBody->WakeUp();
+        }
+    }
+
+    void PhysicsWorld::IntegrateVelocities() {
+        m_BodyState.IntegrateVelocities();
+
+        // Angular motion stays on the components, it only matters for a few bodies
+        for (uint32_t i = 0; i < m_Bodies.size(); i++) {
+            if (!(m_BodyState.flags[i] & BODY_INTEGRATE_POSITION)) continue;
+
+            RigidBody& rb = *m_Bodies[i].rigidBody;
 
-            // Integrate angular velocity
             if (rb.type == RigidBodyType::Dynamic) {
+                float dt = m_BodyState.timeStep[i];
                 glm::vec3 angularAcceleration = rb.torque; // Simplified, assumes unit inertia
                 rb.angularVelocity += angularAcceleration * dt;
                 rb.angularVelocity *= (1.0f - rb.angularDrag * dt);
             }
 
+            // Clear forces
+            rb.force = glm::vec3(0.0f);
+            rb.torque = glm::vec3(0.0f);
+        }
+    }
+
+    void PhysicsWorld::IntegratePositions() {
+        m_BodyState.IntegratePositions();
+        SolveContinuousCollisions();
+
+        // Write back only bodies the integrator touched; static and sleeping bodies didn't change
+        for (uint32_t i = 0; i < m_Bodies.size(); i++) {
+            if (!(m_BodyState.flags[i] & BODY_INTEGRATE_POSITION)) continue;
+
+            Transform& transform = *m_Bodies[i].transform;
+            RigidBody& rb = *m_Bodies[i].rigidBody;
+
+            transform.position = m_BodyState.GetPosition(i);
+            rb.velocity = m_BodyState.GetVelocity(i);
+
             // Integrate rotation
+            if (rb.angularVelocity == glm::vec3(0.0f)) continue;
+            float dt = m_BodyState.timeStep[i];
             if (!rb.freezeRotationX) transform.rotation.x += glm::degrees(rb.angularVelocity.x) * dt;
             if (!rb.freezeRotationY) transform.rotation.y += glm::degrees(rb.angularVelocity.y) * dt;
             if (!rb.freezeRotationZ) transform.rotation.z += glm::degrees(rb.angularVelocity.z) * dt;
-
-            // Clear forces
-            rb.force = glm::vec3(0.0f);
-            rb.torque = glm::vec3(0.0f);
         }
     }
 
+    static ColliderSnapshot TakeSnapshot(const Collider& collider) {
+        ColliderSnapshot snapshot;
+        snapshot.type = collider.type;
+        snapshot.center = collider.center;
+        snapshot.size = collider.size;
+        snapshot.radius = collider.radius;
+        snapshot.height = collider.height;
+        snapshot.triangleMesh = collider.triangleMesh.get();
+        snapshot.heightfield = collider.heightfield.get();
+        snapshot.isTrigger = collider.isTrigger;
+        return snapshot;
+    }
+
+    static ContactSnapshot TakeSnapshot(const Transform& a, const Collider& colliderA, const Transform& b, const Collider& colliderB) {
+        ContactSnapshot snapshot;
+        snapshot.positionA = a.position;
+        snapshot.rotationA = a.rotation;
+        snapshot.scaleA = a.scale;
+        snapshot.positionB = b.position;
+        snapshot.rotationB = b.rotation;
+        snapshot.scaleB = b.scale;
+        snapshot.colliderA = TakeSnapshot(colliderA);
+        snapshot.colliderB = TakeSnapshot(colliderB);
+        return snapshot;
+    }
+
+    static bool HasMoved(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale, const Transform& t) {
+        return position != t.position || rotation != t.rotation || scale != t.scale;
+    }
+
+    // Moved, or had its collider edited, since the snapshot of one side of a pair
+    static bool HasChanged(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale,
+                           const ColliderSnapshot& shape, const Transform& t, const Collider& collider) {
+        return HasMoved(position, rotation, scale, t) || !(shape == TakeSnapshot(collider));
+    }
+
     void PhysicsWorld::DetectCollisions() {
         m_Collisions.clear();
+        m_CollisionPairs.clear();
+        m_ContactEvents.Clear();
+        m_ContactCache.BeginStep();
 
-        auto* transformPool = m_World->GetComponentPool<Transform>();
-        auto* colliderPool = m_World->GetComponentPool<Collider>();
+        auto broadphaseStart = StatClock::now();
+        GatherProxies();
+        FindCandidatePairs();
+        m_StepStats.broadphaseMs = MillisecondsSince(broadphaseStart);
 
-        if (!transformPool || !colliderPool) return;
+        auto narrowphaseStart = StatClock::now();
 
-        const auto& entities = colliderPool->GetEntities();
-        size_t count = entities.size();
+        // The cache is a hash map, so pairs are looked up serially. Element pointers stay
+        // valid across rehashing, which lets the narrowphase write to them from any thread.
+        for (PairCandidate& candidate : m_Candidates) {
+            candidate.pair = &m_ContactCache.Acquire(m_Proxies[candidate.proxyA].entity, m_Proxies[candidate.proxyB].entity);
+        }
 
-        // O(n^2) broad phase - could be optimized with spatial partitioning
-        for (size_t i = 0; i < count; i++) {
-            Entity entityA = entities[i];
-            if (!m_World->HasComponent<Transform>(entityA)) continue;
+        ParallelFor(m_JobSystem, static_cast<uint32_t>(m_Candidates.size()), NARROWPHASE_BATCH_SIZE,
+            [this](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    RunNarrowphase(m_Candidates[i]);
+                }
+            });
 
-            const Transform& transformA = m_World->GetComponent<Transform>(entityA);
-            const Collider& colliderA = m_World->GetComponent<Collider>(entityA);
+        // Everything with side effects runs in pair order so the result doesn't depend on threading
+        for (const PairCandidate& candidate : m_Candidates) {
+            if (candidate.wakeA) WakeBody(m_Proxies[candidate.proxyA].body);
+            if (candidate.wakeB) WakeBody(m_Proxies[candidate.proxyB].body);
 
-            AABB aabbA(
-                colliderA.GetAABBMin(transformA.position, transformA.scale),
-                colliderA.GetAABBMax(transformA.position, transformA.scale)
-            );
+            ContactPair& pair = *candidate.pair;
 
-            for (size_t j = i + 1; j < count; j++) {
-                Entity entityB = entities[j];
-                if (!m_World->HasComponent<Transform>(entityB)) continue;
+            // A speculative contact is only for the solver, the shapes aren't touching yet
+            bool touching = candidate.collided && pair.info.penetrationDepth >= 0.0f;
+            m_ContactCache.Report(pair, touching, m_ContactEvents);
+            if (touching) {
+                m_Collisions.push_back(pair.info);
+            }
 
-                const Transform& transformB = m_World->GetComponent<Transform>(entityB);
-                const Collider& colliderB = m_World->GetComponent<Collider>(entityB);
+            if (candidate.collided && !pair.info.isTrigger) {
+                m_CollisionPairs.push_back(&pair);
 
-                // Layer filtering
-                if (!(colliderA.mask & (1 << colliderB.layer)) ||
-                    !(colliderB.mask & (1 << colliderA.layer))) {
-                    continue;
+                if (m_LODSettings.enabled) {
+                    PromoteOnContact(m_Proxies[candidate.proxyA].body, m_Proxies[candidate.proxyB].body);
+                    PromoteOnContact(m_Proxies[candidate.proxyB].body, m_Proxies[candidate.proxyA].body);
                 }
+            }
+        }
 
-                AABB aabbB(
-                    colliderB.GetAABBMin(transformB.position, transformB.scale),
-                    colliderB.GetAABBMax(transformB.position, transformB.scale)
-                );
-
-                CollisionInfo info;
-                info.entityA = entityA;
-                info.entityB = entityB;
-                info.isTrigger = colliderA.isTrigger || colliderB.isTrigger;
-
-                bool collided = false;
-
-                // Test based on collider types
-                if (colliderA.type == ColliderType::Box && colliderB.type == ColliderType::Box) {
-                    collided = TestAABBAABB(aabbA, aabbB, info);
-                } else if (colliderA.type == ColliderType::Sphere && colliderB.type == ColliderType::Sphere) {
-                    BoundingSphere sphereA(transformA.position + colliderA.center,
-                        colliderA.radius * glm::max(transformA.scale.x, glm::max(transformA.scale.y, transformA.scale.z)));
-                    BoundingSphere sphereB(transformB.position + colliderB.center,
-                        colliderB.radius * glm::max(transformB.scale.x, glm::max(transformB.scale.y, transformB.scale.z)));
-                    collided = TestSphereSphere(sphereA, sphereB, info);
-                } else {
-                    // Mixed types - use AABB approximation
-                    collided = TestAABBAABB(aabbA, aabbB, info);
+        m_ContactCache.EndStep(m_ContactEvents);
+        m_ContactEvents.Sort();
+        m_StepStats.narrowphaseMs = MillisecondsSince(narrowphaseStart);
+    }
+
+    void PhysicsWorld::GatherProxies() {
+        m_Proxies.clear();
+        m_BodyProxies.assign(m_Bodies.size(), INVALID_BODY);
+
+        auto* colliderPool = m_World->GetComponentPool<Collider>();
+        if (!colliderPool || !m_World->GetComponentPool<Transform>()) return;
+
+        const auto& entities = colliderPool->GetEntities();
+        const auto& colliders = colliderPool->GetComponents();
+
+        for (size_t i = 0; i < entities.size(); i++) {
+            Entity entity = entities[i];
+            if (!m_World->HasComponent<Transform>(entity)) continue;
+
+            const Collider& collider = colliders[i];
+            uint32_t layer = collider.layer % LayerMatrix::MAX_LAYERS;
+
+            ColliderProxy proxy;
+            proxy.entity = entity;
+            proxy.transform = &m_World->GetComponent<Transform>(entity);
+            proxy.collider = &collider;
+            proxy.body = FindBody(entity);
+            proxy.layerBit = 1u << layer;
+            proxy.collisionMask = collider.mask & m_LayerMatrix.GetMask(layer);
+
+            if (proxy.body != INVALID_BODY) {
+                m_BodyProxies[proxy.body] = static_cast<uint32_t>(m_Proxies.size());
+            }
+            m_Proxies.push_back(proxy);
+        }
+
+        // Resolve shapes and world bounds against the current transforms
+        ParallelFor(m_JobSystem, static_cast<uint32_t>(m_Proxies.size()), PROXY_BATCH_SIZE,
+            [this](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    ColliderProxy& proxy = m_Proxies[i];
+                    proxy.shape = MakeWorldShape(*proxy.collider, *proxy.transform);
                 }
+            });
+    }
 
-                if (collided) {
-                    m_Collisions.push_back(info);
+    void PhysicsWorld::BuildLayerLists() {
+        uint32_t count = static_cast<uint32_t>(m_Proxies.size());
+
+        // Sweep along the axis the proxies are most spread out on
+        glm::vec3 sum(0.0f);
+        glm::vec3 sumSq(0.0f);
+        for (const ColliderProxy& proxy : m_Proxies) {
+            glm::vec3 center = proxy.shape.bounds.GetCenter();
+            sum += center;
+            sumSq += center * center;
+        }
+
+        glm::vec3 variance(0.0f);
+        if (count > 0) {
+            glm::vec3 mean = sum / static_cast<float>(count);
+            variance = sumSq / static_cast<float>(count) - mean * mean;
+        }
 
-                    if (m_CollisionCallback) {
-                        m_CollisionCallback(info);
+        m_SweepAxis = 0;
+        if (variance.y > variance[m_SweepAxis]) m_SweepAxis = 1;
+        if (variance.z > variance[m_SweepAxis]) m_SweepAxis = 2;
+
+        for (std::vector<uint32_t>& list : m_LayerProxies) list.clear();
+        m_LayerCollisionMasks.fill(0);
+        m_LayerMaxExtents.fill(0.0f);
+        m_ActiveLayers = 0;
+
+        for (uint32_t i = 0; i < count; i++) {
+            const ColliderProxy& proxy = m_Proxies[i];
+            if (proxy.collisionMask == 0) continue;  // Collides with nothing
+
+            uint32_t layer = std::countr_zero(proxy.layerBit);
+            float extent = proxy.shape.bounds.max[m_SweepAxis] - proxy.shape.bounds.min[m_SweepAxis];
+            m_LayerProxies[layer].push_back(i);
+            m_LayerCollisionMasks[layer] |= proxy.collisionMask;
+            m_LayerMaxExtents[layer] = glm::max(m_LayerMaxExtents[layer], extent);
+            m_ActiveLayers |= proxy.layerBit;
+        }
+
+        for (std::vector<uint32_t>& list : m_LayerProxies) {
+            std::sort(list.begin(), list.end(), [this](uint32_t a, uint32_t b) { return SweepsBefore(a, b); });
+        }
+    }
+
+    // Ties on the axis are broken by proxy index so the order never depends on the sort
+    bool PhysicsWorld::SweepsBefore(uint32_t a, uint32_t b) const {
+        float minA = m_Proxies[a].shape.bounds.min[m_SweepAxis];
+        float minB = m_Proxies[b].shape.bounds.min[m_SweepAxis];
+        return minA < minB || (minA == minB && a < b);
+    }
+
+    void PhysicsWorld::FindCandidatePairs() {
+        m_Candidates.clear();
+        BuildLayerLists();
+
+        uint32_t count = static_cast<uint32_t>(m_Proxies.size());
+        uint32_t batchCount = (count + PROXY_BATCH_SIZE - 1) / PROXY_BATCH_SIZE;
+
+        // One buffer per batch, merged in batch order, keeps the pair order fixed
+        if (m_CandidateBatches.size() < batchCount) {
+            m_CandidateBatches.resize(batchCount);
+        }
+
+        // Sweep and prune with one sorted list per layer. Each proxy sweeps only the lists of
+        // layers it can collide with, so layer pairs that never interact are never visited
+        // and every pair leaving here has already passed the layer filter.
+        ParallelFor(m_JobSystem, count, PROXY_BATCH_SIZE, [this](uint32_t begin, uint32_t end) {
+            std::vector<PairCandidate>& batch = m_CandidateBatches[begin / PROXY_BATCH_SIZE];
+            batch.clear();
+
+            uint32_t axis = m_SweepAxis;
+            auto sweepOrder = [this](uint32_t a, uint32_t b) { return SweepsBefore(a, b); };
+
+            for (uint32_t i = begin; i < end; i++) {
+                const ColliderProxy& proxyA = m_Proxies[i];
+
+                // Bounds are grown by the contact margin so near contacts keep their cached impulses
+                AABB marginA(proxyA.shape.bounds.min - glm::vec3(m_ContactMargin), proxyA.shape.bounds.max + glm::vec3(m_ContactMargin));
+
+                uint32_t layers = proxyA.collisionMask & m_ActiveLayers;
+                for (uint32_t layer = 0; layer < LayerMatrix::MAX_LAYERS; layer++) {
+                    if (!(layers & (1u << layer))) continue;
+                    if (!(m_LayerCollisionMasks[layer] & proxyA.layerBit)) continue;  // Nothing there accepts A
+
+                    // A pair is found by whichever proxy comes first along the axis
+                    const std::vector<uint32_t>& list = m_LayerProxies[layer];
+                    auto it = std::upper_bound(list.begin(), list.end(), i, sweepOrder);
+
+                    for (; it != list.end(); ++it) {
+                        const ColliderProxy& proxyB = m_Proxies[*it];
+                        if (proxyB.shape.bounds.min[axis] > marginA.max[axis]) break;
+
+                        if (!(proxyB.collisionMask & proxyA.layerBit)) continue;
+                        if (!marginA.Intersects(proxyB.shape.bounds)) continue;
+
+                        PairCandidate candidate;
+                        candidate.proxyA = glm::min(i, *it);
+                        candidate.proxyB = glm::max(i, *it);
+                        batch.push_back(candidate);
                     }
                 }
             }
+        });
+
+        for (uint32_t i = 0; i < batchCount; i++) {
+            m_Candidates.insert(m_Candidates.end(), m_CandidateBatches[i].begin(), m_CandidateBatches[i].end());
         }
     }
 
-    void PhysicsWorld::ResolveCollisions() {
-        for (const CollisionInfo& info : m_Collisions) {
-            if (info.isTrigger) continue;
+    void PhysicsWorld::RunNarrowphase(PairCandidate& candidate) const {
+        const ColliderProxy& proxyA = m_Proxies[candidate.proxyA];
+        const ColliderProxy& proxyB = m_Proxies[candidate.proxyB];
+        const Transform& transformA = *proxyA.transform;
+        const Transform& transformB = *proxyB.transform;
+        const Collider& colliderA = *proxyA.collider;
+        const Collider& colliderB = *proxyB.collider;
+        ContactPair& pair = *candidate.pair;
+
+        // The cached result is stored in its own A/B order, which may differ from the proxy order
+        bool swapped = pair.info.entityA == proxyB.entity;
+        const ColliderProxy& cachedA = swapped ? proxyB : proxyA;
+        const ColliderProxy& cachedB = swapped ? proxyA : proxyB;
+
+        candidate.collided = false;
+        candidate.wakeA = false;
+        candidate.wakeB = false;
+
+        const ContactSnapshot& snapshot = pair.snapshot;
+        bool changedA = !pair.hasSnapshot || HasChanged(snapshot.positionA, snapshot.rotationA, snapshot.scaleA,
+                                                        snapshot.colliderA, *cachedA.transform, *cachedA.collider);
+        bool changedB = !pair.hasSnapshot || HasChanged(snapshot.positionB, snapshot.rotationB, snapshot.scaleB,
+                                                        snapshot.colliderB, *cachedB.transform, *cachedB.collider);
+
+        if (!changedA && !changedB) {
+            // Neither body moved nor had its collider edited since the last narrowphase (always
+            // true for sleeping bodies resting on each other or on static geometry) - reuse the
+            // cached result
+            candidate.collided = pair.manifold.pointCount > 0;
+            return;
+        }
 
-            bool hasRbA = m_World->HasComponent<RigidBody>(info.entityA);
-            bool hasRbB = m_World->HasComponent<RigidBody>(info.entityB);
+        // A sleeping body that was moved or reshaped from outside the simulation must wake up.
+        // Waking writes to the rigid body, so it's deferred until the pairs are merged.
+        if (pair.hasSnapshot) {
+            bool wakeA = changedA && cachedA.body != INVALID_BODY && m_Bodies[cachedA.body].rigidBody->isSleeping;
+            bool wakeB = changedB && cachedB.body != INVALID_BODY && m_Bodies[cachedB.body].rigidBody->isSleeping;
+            candidate.wakeA = swapped ? wakeB : wakeA;
+            candidate.wakeB = swapped ? wakeA : wakeB;
+        }
 
-            if (!hasRbA && !hasRbB) continue;
+        CollisionInfo info;
+        info.entityA = proxyA.entity;
+        info.entityB = proxyB.entity;
+        info.isTrigger = colliderA.isTrigger || colliderB.isTrigger;
 
-            Transform* transformA = hasRbA ? &m_World->GetComponent<Transform>(info.entityA) : nullptr;
-            Transform* transformB = hasRbB ? &m_World->GetComponent<Transform>(info.entityB) : nullptr;
-            RigidBody* rbA = hasRbA ? &m_World->GetComponent<RigidBody>(info.entityA) : nullptr;
-            RigidBody* rbB = hasRbB ? &m_World->GetComponent<RigidBody>(info.entityB) : nullptr;
+        ContactManifold manifold;
+        bool collided = Collide(proxyA.shape, proxyB.shape, m_ContactMargin, manifold);
 
-            // Calculate masses
-            float massA = (rbA && rbA->type == RigidBodyType::Dynamic) ? rbA->mass : 0.0f;
-            float massB = (rbB && rbB->type == RigidBodyType::Dynamic) ? rbB->mass : 0.0f;
-            float totalMass = massA + massB;
+        if (collided) {
+            info.contactNormal = manifold.normal;
+            info.contactPoint = manifold.GetCenter();
+            info.penetrationDepth = manifold.GetMaxDepth();
+        }
 
-            if (totalMass <= 0.0f) continue;
+        // Cached friction is stored relative to A, so flip it if A and B swapped
+        if (swapped) {
+            pair.frictionImpulse = -pair.frictionImpulse;
+        }
 
-            // Position correction
-            float ratioA = (massA > 0.0f) ? massB / totalMass : 0.0f;
-            float ratioB = (massB > 0.0f) ? massA / totalMass : 0.0f;
+        // Speculative contacts inside the margin only matter to the solver, not to triggers
+        if (collided && info.isTrigger && info.penetrationDepth < 0.0f) {
+            collided = false;
+        }
 
-            if (transformA && rbA && rbA->type == RigidBodyType::Dynamic) {
-                transformA->position += info.contactNormal * info.penetrationDepth * ratioA;
-            }
-            if (transformB && rbB && rbB->type == RigidBodyType::Dynamic) {
-                transformB->position -= info.contactNormal * info.penetrationDepth * ratioB;
-            }
+        // Warm starting resumes only while the solver keeps seeing the pair, speculative
+        // contacts included
+        if (!collided) {
+            pair.normalImpulse = 0.0f;
+            pair.frictionImpulse = glm::vec3(0.0f);
+        }
 
-            // Velocity response
-            if (rbA && rbB) {
-                glm::vec3 relativeVel = rbA->velocity - rbB->velocity;
-                float velAlongNormal = glm::dot(relativeVel, info.contactNormal);
+        pair.info = info;
+        pair.manifold = collided ? manifold : ContactManifold();
+        pair.snapshot = TakeSnapshot(transformA, colliderA, transformB, colliderB);
+        pair.hasSnapshot = true;
+        candidate.collided = collided;
+    }
 
-                if (velAlongNormal > 0) continue; // Objects moving apart
+    void PhysicsWorld::BuildIslands() {
+        m_IslandBuilder.Reset(static_cast<uint32_t>(m_Bodies.size()));
 
-                float restitution = glm::min(rbA->bounciness, rbB->bounciness);
-                float j = -(1.0f + restitution) * velAlongNormal;
-                j /= (1.0f / massA + 1.0f / massB);
+        // Bodies sitting this step out for their LOD are held still, so they link like static ones
+        auto dynamicBody = [this](Entity entity) {
+            uint32_t body = FindBody(entity);
+            if (body != INVALID_BODY && (m_Bodies[body].rigidBody->type != RigidBodyType::Dynamic ||
+                                         m_BodyState.timeStep[body] == 0.0f)) {
+                return INVALID_BODY;
+            }
+            return body;
+        };
+
+        for (size_t i = 0; i < m_CollisionPairs.size(); i++) {
+            const CollisionInfo& info = m_CollisionPairs[i]->info;
+            m_IslandBuilder.AddContact(static_cast<uint32_t>(i), dynamicBody(info.entityA), dynamicBody(info.entityB));
+        }
 
-                glm::vec3 impulse = j * info.contactNormal;
+        m_IslandBuilder.Build(m_Islands);
 
-                if (rbA->type == RigidBodyType::Dynamic) {
-                    rbA->velocity += impulse / massA;
+        // An island is only asleep if every body in it is. Any awake body (a new contact
+        // from a moving body, an applied force, ...) wakes the whole island.
+        for (Island& island : m_Islands) {
+            bool anyAwake = false;
+            for (uint32_t body : island.bodies) {
+                if (!m_Bodies[body].rigidBody->isSleeping) {
+                    anyAwake = true;
+                    break;
                 }
-                if (rbB->type == RigidBodyType::Dynamic) {
-                    rbB->velocity -= impulse / massB;
+            }
+
+            if (anyAwake) {
+                for (uint32_t body : island.bodies) {
+                    if (m_Bodies[body].rigidBody->isSleeping) WakeBody(body);
                 }
             }
+            island.sleeping = !anyAwake;
         }
     }
 
-    bool PhysicsWorld::TestAABBAABB(const AABB& a, const AABB& b, CollisionInfo& info) {
-        if (!a.Intersects(b)) return false;
+    void PhysicsWorld::SolveContacts(float dt) {
+        m_SolverBodies.resize(m_Bodies.size());
+
+        for (size_t i = 0; i < m_Bodies.size(); i++) {
+            const RigidBody& rb = *m_Bodies[i].rigidBody;
+            SolverBody& body = m_SolverBodies[i];
+
+            // Bodies sitting this step out for their LOD hold still, like sleeping ones
+            bool idle = m_BodyState.timeStep[i] == 0.0f;
+            bool dynamic = rb.type == RigidBodyType::Dynamic && rb.mass > 0.0f && !rb.isSleeping && !idle;
+
+            // Kinematic bodies keep their velocity so moving platforms push and carry bodies
+            body.velocity = (rb.type == RigidBodyType::Static || idle) ? glm::vec3(0.0f) : m_BodyState.GetVelocity(i);
+            body.pseudoVelocity = glm::vec3(0.0f);
+            body.invMass = dynamic ? 1.0f / rb.mass : 0.0f;
+            body.linearFactor = glm::vec3(
+                rb.freezePositionX ? 0.0f : 1.0f,
+                rb.freezePositionY ? 0.0f : 1.0f,
+                rb.freezePositionZ ? 0.0f : 1.0f);
+        }
 
-        // Calculate penetration
-        glm::vec3 overlap;
-        overlap.x = glm::min(a.max.x, b.max.x) - glm::max(a.min.x, b.min.x);
-        overlap.y = glm::min(a.max.y, b.max.y) - glm::max(a.min.y, b.min.y);
-        overlap.z = glm::min(a.max.z, b.max.z) - glm::max(a.min.z, b.min.z);
+        m_SolverContacts.resize(m_CollisionPairs.size());
 
-        // Find minimum penetration axis
-        if (overlap.x < overlap.y && overlap.x < overlap.z) {
-            info.penetrationDepth = overlap.x;
-            info.contactNormal = (a.GetCenter().x < b.GetCenter().x) ? glm::vec3(-1, 0, 0) : glm::vec3(1, 0, 0);
-        } else if (overlap.y < overlap.z) {
-            info.penetrationDepth = overlap.y;
-            info.contactNormal = (a.GetCenter().y < b.GetCenter().y) ? glm::vec3(0, -1, 0) : glm::vec3(0, 1, 0);
-        } else {
-            info.penetrationDepth = overlap.z;
-            info.contactNormal = (a.GetCenter().z < b.GetCenter().z) ? glm::vec3(0, 0, -1) : glm::vec3(0, 0, 1);
+        for (size_t i = 0; i < m_CollisionPairs.size(); i++) {
+            const CollisionInfo& info = m_CollisionPairs[i]->info;
+
+            SolverContact& contact = m_SolverContacts[i];
+            contact.bodyA = FindBody(info.entityA);
+            contact.bodyB = FindBody(info.entityB);
+            contact.normal = info.contactNormal;
+            contact.penetration = info.penetrationDepth;
+            contact.pair = m_CollisionPairs[i];
+
+            // Colliders without a rigid body take the material of the body they touch
+            const RigidBody* rbA = contact.bodyA != INVALID_BODY ? m_Bodies[contact.bodyA].rigidBody : nullptr;
+            const RigidBody* rbB = contact.bodyB != INVALID_BODY ? m_Bodies[contact.bodyB].rigidBody : nullptr;
+            if (rbA && rbB) {
+                contact.friction = std::sqrt(rbA->friction * rbB->friction);
+                contact.restitution = glm::max(rbA->bounciness, rbB->bounciness);
+            } else {
+                const RigidBody* rb = rbA ? rbA : rbB;
+                contact.friction = rb ? rb->friction : 0.0f;
+                contact.restitution = rb ? rb->bounciness : 0.0f;
+            }
         }
 
-        info.contactPoint = (a.GetCenter() + b.GetCenter()) * 0.5f;
-        return true;
+        m_AwakeIslands.clear();
+        for (uint32_t i = 0; i < m_Islands.size(); i++) {
+            if (!m_Islands[i].sleeping && !m_Islands[i].contacts.empty()) m_AwakeIslands.push_back(i);
+        }
+
+        // Islands share no dynamic bodies or contacts, so each one can be solved on its own thread.
+        // Static and kinematic bodies are shared but the solver only reads them.
+        ParallelFor(m_JobSystem, static_cast<uint32_t>(m_AwakeIslands.size()), 1,
+            [this, dt](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    const Island& island = m_Islands[m_AwakeIslands[i]];
+                    m_Solver.SolveIsland(m_SolverBodies, m_SolverContacts, island.contacts, dt);
+                }
+            });
+
+        for (uint32_t i = 0; i < m_Bodies.size(); i++) {
+            if (m_SolverBodies[i].invMass > 0.0f) {
+                // Bodies woken by a contact this step weren't flagged when gathered
+                m_BodyState.flags[i] |= BODY_INTEGRATE_POSITION;
+                m_BodyState.SetVelocity(i, m_SolverBodies[i].velocity);
+
+                // The correction is a distance for this step; a body taking a longer step
+                // must not apply it more than once
+                m_BodyState.SetPseudoVelocity(i, m_SolverBodies[i].pseudoVelocity * (dt / m_BodyState.timeStep[i]));
+            }
+        }
     }
 
-    bool PhysicsWorld::TestSphereSphere(const BoundingSphere& a, const BoundingSphere& b, CollisionInfo& info) {
-        glm::vec3 diff = b.center - a.center;
-        float distance = glm::length(diff);
-        float sumRadii = a.radius + b.radius;
+    void PhysicsWorld::UpdateSleeping(float dt) {
+        m_SleepingBodyCount = 0;
 
-        if (distance > sumRadii) return false;
+        float linearSq = m_SleepSettings.linearThreshold * m_SleepSettings.linearThreshold;
+        float angularSq = m_SleepSettings.angularThreshold * m_SleepSettings.angularThreshold;
+        bool fellAsleep = false;
 
-        info.penetrationDepth = sumRadii - distance;
-        info.contactNormal = (distance > 0.0001f) ? diff / distance : glm::vec3(0, 1, 0);
-        info.contactPoint = a.center + info.contactNormal * a.radius;
+        for (Island& island : m_Islands) {
+            // Static and kinematic bodies are never linked, so they form single-body islands
+            if (m_Bodies[island.bodies[0]].rigidBody->type != RigidBodyType::Dynamic) continue;
 
-        return true;
-    }
+            if (island.sleeping) {
+                m_SleepingBodyCount += static_cast<uint32_t>(island.bodies.size());
+                continue;
+            }
+
+            float minSleepTimer = std::numeric_limits<float>::max();
 
-    bool PhysicsWorld::TestSphereAABB(const BoundingSphere& sphere, const AABB& aabb, CollisionInfo& info) {
-        glm::vec3 closest;
-        closest.x = glm::clamp(sphere.center.x, aabb.min.x, aabb.max.x);
-        closest.y = glm::clamp(sphere.center.y, aabb.min.y, aabb.max.y);
-        closest.z = glm::clamp(sphere.center.z, aabb.min.z, aabb.max.z);
+            for (uint32_t body : island.bodies) {
+                RigidBody& rb = *m_Bodies[body].rigidBody;
 
-        glm::vec3 diff = sphere.center - closest;
-        float distanceSquared = glm::dot(diff, diff);
+                bool resting = rb.canSleep &&
+                               glm::dot(rb.velocity, rb.velocity) < linearSq &&
+                               glm::dot(rb.angularVelocity, rb.angularVelocity) < angularSq;
 
-        if (distanceSquared > sphere.radius * sphere.radius) return false;
+                rb.sleepTimer = resting ? rb.sleepTimer + dt : 0.0f;
+                minSleepTimer = glm::min(minSleepTimer, rb.sleepTimer);
+            }
 
-        float distance = std::sqrt(distanceSquared);
-        info.penetrationDepth = sphere.radius - distance;
-        info.contactNormal = (distance > 0.0001f) ? diff / distance : glm::vec3(0, 1, 0);
-        info.contactPoint = closest;
+            if (!m_SleepSettings.enabled || minSleepTimer < m_SleepSettings.timeToSleep) continue;
 
+            for (uint32_t body : island.bodies) {
+                RigidBody& rb = *m_Bodies[body].rigidBody;
+                rb.isSleeping = true;
+                rb.velocity = glm::vec3(0.0f);
+                rb.angularVelocity = glm::vec3(0.0f);
+            }
+            island.sleeping = true;
+            m_SleepingBodyCount += static_cast<uint32_t>(island.bodies.size());
+            fellAsleep = true;
+        }
+
+        // Snapshots were taken before this step's integration moved the bodies. Refresh them
+        // for pairs touching a sleeping body so the next step doesn't mistake that for an
+        // external move and wake the island straight back up.
+        if (!fellAsleep) return;
+
+        for (auto& [key, pair] : m_ContactCache.GetPairs()) {
+            if (!pair.hasSnapshot) continue;
+
+            uint32_t bodyA = FindBody(pair.info.entityA);
+            uint32_t bodyB = FindBody(pair.info.entityB);
+            bool sleepingA = bodyA != INVALID_BODY && m_Bodies[bodyA].rigidBody->isSleeping;
+            bool sleepingB = bodyB != INVALID_BODY && m_Bodies[bodyB].rigidBody->isSleeping;
+            if (!sleepingA && !sleepingB) continue;
+
+            pair.snapshot = TakeSnapshot(m_World->GetComponent<Transform>(pair.info.entityA), m_World->GetComponent<Collider>(pair.info.entityA),
+                                         m_World->GetComponent<Transform>(pair.info.entityB), m_World->GetComponent<Collider>(pair.info.entityB));
+        }
+    }
+
+    static bool IsTriangleGeometry(ColliderType type) {
+        return type == ColliderType::Mesh || type == ColliderType::Heightfield;
+    }
+
+    // Mesh and heightfield bounds can cover a whole level, so queries test their triangles
+    static bool RaycastGeometry(const Collider& collider, const Transform& transform, const Ray& ray,
+                                float maxDistance, RaycastHit& hit) {
+        WorldShape shape = MakeWorldShape(collider, transform);
+
+        float distance;
+        glm::vec3 normal;
+        if (!shape.geometry.Raycast(ray, maxDistance, distance, normal)) return false;
+
+        hit.hit = true;
+        hit.distance = distance;
+        hit.point = ray.GetPoint(distance);
+        hit.normal = normal;
         return true;
     }
 
+    static bool OverlapsGeometry(const WorldShape& query, const Collider& collider, const Transform& transform) {
+        ContactManifold manifold;
+        return Collide(query, MakeWorldShape(collider, transform), 0.0f, manifold);
+    }
+
     RaycastHit PhysicsWorld::Raycast(const Ray& ray, float maxDistance, uint32_t layerMask) {
         RaycastHit closestHit;
         closestHit.distance = maxDistance;
@@ -278,6 +972,15 @@ namespace Xi {
 
             if (!(layerMask & (1 << collider.layer))) continue;
 
+            if (IsTriangleGeometry(collider.type)) {
+                RaycastHit hit;
+                if (RaycastGeometry(collider, transform, ray, closestHit.distance, hit)) {
+                    closestHit = hit;
+                    closestHit.entity = entity;
+                }
+                continue;
+            }
+
             AABB aabb(
                 collider.GetAABBMin(transform.position, transform.scale),
                 collider.GetAABBMax(transform.position, transform.scale)
@@ -324,6 +1027,15 @@ namespace Xi {
 
             if (!(layerMask & (1 << collider.layer))) continue;
 
+            if (IsTriangleGeometry(collider.type)) {
+                RaycastHit hit;
+                if (RaycastGeometry(collider, transform, ray, maxDistance, hit)) {
+                    hit.entity = entity;
+                    hits.push_back(hit);
+                }
+                continue;
+            }
+
             AABB aabb(
                 collider.GetAABBMin(transform.position, transform.scale),
                 collider.GetAABBMax(transform.position, transform.scale)
@@ -347,10 +1059,196 @@ namespace Xi {
         return hits;
     }
 
+    static WorldShape Translated(const WorldShape& shape, const glm::vec3& offset) {
+        WorldShape moved = shape;
+        moved.box.center += offset;
+        moved.sphere.center += offset;
+        moved.capsule.a += offset;
+        moved.capsule.b += offset;
+        moved.bounds = AABB(shape.bounds.min + offset, shape.bounds.max + offset);
+        return moved;
+    }
+
+    // Conservative advancement: the closest-feature normal gives a separating plane, and the
+    // moving shape can't touch the target before it reaches that plane. Targets overlapping
+    // at the start are not reported.
+    static bool SweepShape(const WorldShape& shape, const glm::vec3& dir, float maxDistance,
+                           const WorldShape& target, float& distance, ContactManifold& manifold) {
+        constexpr int MAX_ITERATIONS = 32;
+        constexpr float TOLERANCE = 0.001f;
+
+        // The plane of the closest triangle says nothing about the rest of a mesh, so
+        // against triangle geometry only the distance itself is a safe step
+        bool convex = !IsTriangleGeometry(target.type);
+        int maxIterations = convex ? MAX_ITERATIONS : MAX_ITERATIONS * 2;
+
+        distance = 0.0f;
+
+        for (int iteration = 0; iteration < maxIterations; iteration++) {
+            if (!Collide(Translated(shape, dir * distance), target, maxDistance - distance, manifold)) return false;
+
+            float separation = -manifold.GetMaxDepth();
+            if (separation <= TOLERANCE) {
+                return iteration > 0 || separation > 0.0f;
+            }
+
+            float approachSpeed = convex ? -glm::dot(dir, manifold.normal) : 1.0f;
+            if (approachSpeed <= 1e-6f) return false;
+
+            distance += separation / approachSpeed;
+            if (distance >= maxDistance) return false;
+        }
+
+        return false;
+    }
+
+    // Largest sphere centered in the shape, used as the swept proxy for CCD
+    static BoundingSphere GetInnerSphere(const WorldShape& shape) {
+        switch (shape.type) {
+            case ColliderType::Box: {
+                const glm::vec3& h = shape.box.halfExtents;
+                return BoundingSphere(shape.box.center, glm::min(h.x, glm::min(h.y, h.z)));
+            }
+            case ColliderType::Sphere:
+                return shape.sphere;
+            case ColliderType::Capsule:
+                return BoundingSphere((shape.capsule.a + shape.capsule.b) * 0.5f, shape.capsule.radius);
+            default:
+                return BoundingSphere(shape.bounds.GetCenter(), 0.0f);
+        }
+    }
+
+    void PhysicsWorld::SolveContinuousCollisions() {
+        for (uint32_t i = 0; i < m_Bodies.size(); i++) {
+            if (!(m_BodyState.flags[i] & BODY_INTEGRATE_POSITION)) continue;
+
+            const RigidBody& rb = *m_Bodies[i].rigidBody;
+            if (!rb.isBullet || rb.type != RigidBodyType::Dynamic) continue;
+
+            uint32_t proxyIndex = m_BodyProxies[i];
+            if (proxyIndex == INVALID_BODY) continue;
+
+            const ColliderProxy& proxy = m_Proxies[proxyIndex];
+            if (proxy.collider->isTrigger || IsTriangleGeometry(proxy.shape.type)) continue;
+
+            // Transforms still hold the start of the step, the body state holds the end
+            glm::vec3 start = m_Bodies[i].transform->position;
+            glm::vec3 motion = m_BodyState.GetPosition(i) - start;
+            float distance = glm::length(motion);
+
+            // A body moving less than its own inner radius can't skip past anything
+            BoundingSphere inner = GetInnerSphere(proxy.shape);
+            if (distance <= inner.radius) continue;
+
+            glm::vec3 dir = motion / distance;
+
+            WorldShape sphere;
+            sphere.type = ColliderType::Sphere;
+            sphere.sphere = inner;
+            sphere.bounds = AABB(inner.center - glm::vec3(inner.radius), inner.center + glm::vec3(inner.radius));
+
+            AABB sweptBounds = sphere.bounds;
+            sweptBounds.Expand(AABB(sphere.bounds.min + motion, sphere.bounds.max + motion));
+
+            float timeOfImpact = distance;
+
+            // Search the broadphase's sorted layer lists like a pair sweep, starting far enough
+            // back to catch the longest proxy of the layer that could still reach the swept bounds
+            uint32_t axis = m_SweepAxis;
+            uint32_t layers = proxy.collisionMask & m_ActiveLayers;
+            for (uint32_t layer = 0; layer < LayerMatrix::MAX_LAYERS; layer++) {
+                if (!(layers & (1u << layer))) continue;
+                if (!(m_LayerCollisionMasks[layer] & proxy.layerBit)) continue;
+
+                const std::vector<uint32_t>& list = m_LayerProxies[layer];
+                float searchMin = sweptBounds.min[axis] - m_LayerMaxExtents[layer];
+                auto it = std::lower_bound(list.begin(), list.end(), searchMin, [this, axis](uint32_t p, float value) {
+                    return m_Proxies[p].shape.bounds.min[axis] < value;
+                });
+
+                for (; it != list.end(); ++it) {
+                    const ColliderProxy& other = m_Proxies[*it];
+                    if (other.shape.bounds.min[axis] > sweptBounds.max[axis]) break;
+
+                    if (*it == proxyIndex || other.collider->isTrigger) continue;
+                    if (!(other.collisionMask & proxy.layerBit)) continue;
+                    if (!sweptBounds.Intersects(other.shape.bounds)) continue;
+
+                    ContactManifold manifold;
+                    float hitDistance = 0.0f;
+                    if (SweepShape(sphere, dir, timeOfImpact, other.shape, hitDistance, manifold)) {
+                        timeOfImpact = hitDistance;
+                    }
+                }
+            }
+
+            // Stop at the first impact and keep the velocity; next step's contact handles the response
+            if (timeOfImpact < distance) {
+                m_BodyState.SetPosition(i, start + dir * timeOfImpact);
+            }
+        }
+    }
+
+    RaycastHit PhysicsWorld::CapsuleCast(const glm::vec3& point1, const glm::vec3& point2, float radius,
+                                         const glm::vec3& direction, float maxDistance, uint32_t layerMask) {
+        RaycastHit closestHit;
+        closestHit.distance = maxDistance;
+
+        auto* transformPool = m_World->GetComponentPool<Transform>();
+        auto* colliderPool = m_World->GetComponentPool<Collider>();
+
+        if (!transformPool || !colliderPool) return closestHit;
+        if (glm::dot(direction, direction) < 1e-12f) return closestHit;
+
+        glm::vec3 dir = glm::normalize(direction);
+
+        WorldShape capsule;
+        capsule.type = ColliderType::Capsule;
+        capsule.capsule.a = point1;
+        capsule.capsule.b = point2;
+        capsule.capsule.radius = radius;
+        capsule.bounds = capsule.capsule.GetAABB();
+
+        // Bounds of the whole sweep for early rejection
+        AABB sweptBounds = capsule.bounds;
+        sweptBounds.Expand(AABB(capsule.bounds.min + dir * maxDistance, capsule.bounds.max + dir * maxDistance));
+
+        const auto& entities = colliderPool->GetEntities();
+        const auto& colliders = colliderPool->GetComponents();
+
+        for (size_t i = 0; i < entities.size(); i++) {
+            Entity entity = entities[i];
+            const Collider& collider = colliders[i];
+
+            if (!(layerMask & (1 << collider.layer)) || collider.isTrigger) continue;
+            if (!m_World->HasComponent<Transform>(entity)) continue;
+
+            WorldShape target = MakeWorldShape(collider, m_World->GetComponent<Transform>(entity));
+            if (!sweptBounds.Intersects(target.bounds)) continue;
+
+            ContactManifold manifold;
+            float travelled = 0.0f;
+            if (SweepShape(capsule, dir, closestHit.distance, target, travelled, manifold)) {
+                closestHit.hit = true;
+                closestHit.entity = entity;
+                closestHit.distance = travelled;
+                closestHit.point = manifold.GetDeepestPoint();
+                closestHit.normal = manifold.normal;
+            }
+        }
+
+        return closestHit;
+    }
+
     std::vector<Entity> PhysicsWorld::OverlapSphere(const glm::vec3& center, float radius, uint32_t layerMask) {
         std::vector<Entity> result;
         BoundingSphere sphere(center, radius);
 
+        WorldShape query;
+        query.type = ColliderType::Sphere;
+        query.sphere = sphere;
+        query.bounds = AABB(center - glm::vec3(radius), center + glm::vec3(radius));
+
         auto* transformPool = m_World->GetComponentPool<Transform>();
         auto* colliderPool = m_World->GetComponentPool<Collider>();
 
@@ -364,6 +1262,11 @@ namespace Xi {
 
             if (!(layerMask & (1 << collider.layer))) continue;
 
+            if (IsTriangleGeometry(collider.type)) {
+                if (OverlapsGeometry(query, collider, transform)) result.push_back(entity);
+                continue;
+            }
+
             AABB aabb(
                 collider.GetAABBMin(transform.position, transform.scale),
                 collider.GetAABBMax(transform.position, transform.scale)
@@ -381,6 +1284,12 @@ namespace Xi {
         std::vector<Entity> result;
         AABB queryBox(center - halfExtents, center + halfExtents);
 
+        WorldShape query;
+        query.type = ColliderType::Box;
+        query.box.center = center;
+        query.box.halfExtents = halfExtents;
+        query.bounds = queryBox;
+
         auto* transformPool = m_World->GetComponentPool<Transform>();
         auto* colliderPool = m_World->GetComponentPool<Collider>();
 
@@ -394,6 +1303,11 @@ namespace Xi {
 
             if (!(layerMask & (1 << collider.layer))) continue;
 
+            if (IsTriangleGeometry(collider.type)) {
+                if (OverlapsGeometry(query, collider, transform)) result.push_back(entity);
+                continue;
+            }
+
             AABB aabb(
                 collider.GetAABBMin(transform.position, transform.scale),
                 collider.GetAABBMax(transform.position, transform.scale)
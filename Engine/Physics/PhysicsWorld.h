@@ -2,22 +2,76 @@
 
 #include "Collision.h"
 #include "Collider.h"
+#include "ContactCache.h"
+#include "Island.h"
+#include "ContactSolver.h"
+#include "BodyState.h"
+#include "LayerMatrix.h"
 #include "../ECS/Entity.h"
+#include <array>
 #include <vector>
+#include <unordered_map>
 #include <functional>
+#include <span>
 
 namespace Xi {
 
     class World;
+    class JobSystem;
+    struct Transform;
+    struct RigidBody;
+    struct Collider;
 
-    using CollisionCallback = std::function<void(const CollisionInfo&)>;
+    // Called once at the end of every step with all of that step's events
+    using ContactEventCallback = std::function<void(const ContactEvents&)>;
+
+    struct SleepSettings {
+        bool enabled = true;
+        float linearThreshold = 0.05f;   // Units per second
+        float angularThreshold = 0.05f;  // Radians per second
+        float timeToSleep = 0.5f;        // Seconds an island must stay below the thresholds
+    };
+
+    // Distant dynamic bodies step at a reduced rate with proportionally longer steps. Distance
+    // is to the nearest viewer. Contact with a full-rate body in motion, or anything that wakes
+    // the body, brings it back to full rate for promotionTime.
+    struct SimulationLODSettings {
+        bool enabled = false;
+        float halfRateDistance = 50.0f;
+        float quarterRateDistance = 100.0f;
+        float eighthRateDistance = 200.0f;
+        float freezeDistance = 400.0f;  // Beyond this bodies don't step at all
+        float promotionTime = 1.0f;
+    };
+
+    // Timings and counts of the most recent step
+    struct PhysicsStepStats {
+        float integrateMs = 0.0f;    // Gathering bodies, both integrations and CCD
+        float broadphaseMs = 0.0f;
+        float narrowphaseMs = 0.0f;  // Including the contact cache and events
+        float solveMs = 0.0f;        // Islands and the contact solver
+        float totalMs = 0.0f;
+        uint32_t bodyCount = 0;
+        uint32_t colliderCount = 0;
+        uint32_t broadphasePairs = 0;
+        uint32_t contactCount = 0;
+        uint32_t islandCount = 0;
+    };
+
+    static constexpr uint32_t SIMULATION_LOD_FROZEN = 4;  // RigidBody::lodLevel of frozen bodies
+    static constexpr uint32_t SIMULATION_LOD_COUNT = 5;
 
     class PhysicsWorld {
     public:
         PhysicsWorld();
         ~PhysicsWorld();
 
-        void SetWorld(World* world) { m_World = world; }
+        // Contacts and published poses are kept per entity, so they are dropped when the world
+        // changes or has been cleared since the last call
+        void SetWorld(World* world);
+
+        // Spreads the step across worker threads. Results are identical with or without one.
+        void SetJobSystem(JobSystem* jobSystem) { m_JobSystem = jobSystem; }
 
         void Step(float dt);
 
@@ -25,36 +79,199 @@ namespace Xi {
         RaycastHit Raycast(const Ray& ray, float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF);
         std::vector<RaycastHit> RaycastAll(const Ray& ray, float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF);
 
+        // Sweeps a capsule (segment point1-point2 plus radius) along direction. Colliders the
+        // capsule already overlaps at the start are ignored, so a character can sweep its own shape.
+        RaycastHit CapsuleCast(const glm::vec3& point1, const glm::vec3& point2, float radius,
+                               const glm::vec3& direction, float maxDistance = 1000.0f, uint32_t layerMask = 0xFFFFFFFF);
+
         // Overlap tests
         std::vector<Entity> OverlapSphere(const glm::vec3& center, float radius, uint32_t layerMask = 0xFFFFFFFF);
         std::vector<Entity> OverlapBox(const glm::vec3& center, const glm::vec3& halfExtents, uint32_t layerMask = 0xFFFFFFFF);
 
-        // Collision callbacks
-        void SetCollisionCallback(CollisionCallback callback) { m_CollisionCallback = callback; }
+        // Contact events are batched: the callback runs once per step, after the step finished,
+        // on whichever thread stepped the world
+        void SetContactEventCallback(ContactEventCallback callback) { m_ContactEventCallback = callback; }
+
+        // Begin/persist/end events for collisions and triggers, rebuilt every step
+        const ContactEvents& GetContactEvents() const { return m_ContactEvents; }
 
         // Settings
         void SetGravity(const glm::vec3& gravity) { m_Gravity = gravity; }
         glm::vec3 GetGravity() const { return m_Gravity; }
 
+        void SetSolverSettings(const SolverSettings& settings) { m_Solver.SetSettings(settings); }
+        const SolverSettings& GetSolverSettings() const { return m_Solver.GetSettings(); }
+
+        // Pairs closer than this generate speculative contacts with negative penetration
+        void SetContactMargin(float margin) { m_ContactMargin = margin; }
+        float GetContactMargin() const { return m_ContactMargin; }
+
+        void SetSleepSettings(const SleepSettings& settings) { m_SleepSettings = settings; }
+        const SleepSettings& GetSleepSettings() const { return m_SleepSettings; }
+
+        void SetSimulationLODSettings(const SimulationLODSettings& settings) { m_LODSettings = settings; }
+        const SimulationLODSettings& GetSimulationLODSettings() const { return m_LODSettings; }
+
+        // Positions LOD distances are measured from, such as the camera and the audio listener
+        void SetLODViewers(std::span<const glm::vec3> positions) { m_LODViewers.assign(positions.begin(), positions.end()); }
+
+        // Layer pairs turned off here never reach the narrowphase, whatever the collider masks say
+        void SetLayerMatrix(const LayerMatrix& matrix) { m_LayerMatrix = matrix; }
+        const LayerMatrix& GetLayerMatrix() const { return m_LayerMatrix; }
+        void SetLayerCollision(uint32_t layerA, uint32_t layerB, bool collide) { m_LayerMatrix.SetCollision(layerA, layerB, collide); }
+
+        // Body poses are double buffered: steps write the back buffer and this makes it the one
+        // rendering reads. Does nothing if no step ran since the last call.
+        void PublishPoses();
+
+        // Publishes bodies that no step has seen yet at their current pose, so rendering never
+        // reads a transform that a step on another thread is writing
+        void PublishNewBodies();
+
+        // For updates that run no step: bodies moved from outside the simulation since the last
+        // step are published at their transform and entities that are no longer bodies are
+        // dropped. Must not be called while a step runs.
+        void RefreshPublishedPoses();
+
+        // Rendering uses the transforms until the next step publishes again
+        void ClearPublishedPoses();
+
+        // Matrix for rendering between steps: alpha blends from a body's pose before the last
+        // published step to its pose after it. Only the scale is read from the transform of a
+        // body, so this is safe while a step runs on another thread. Anything that isn't a body
+        // keeps its transform.
+        glm::mat4 GetInterpolatedMatrix(Entity entity, const Transform& transform, float alpha) const;
+
+        // Profiling
+        const PhysicsStepStats& GetStepStats() const { return m_StepStats; }
+        size_t GetMemoryUsage() const;  // Bytes held by the step's buffers and the contact cache
+
         // Debug
         const std::vector<CollisionInfo>& GetCollisions() const { return m_Collisions; }
+        size_t GetContactPairCount() const { return m_ContactCache.Size(); }
+        size_t GetBroadphasePairCount() const { return m_Candidates.size(); }
+        const std::vector<Island>& GetIslands() const { return m_Islands; }
+        uint32_t GetSleepingBodyCount() const { return m_SleepingBodyCount; }
+        uint32_t GetLODBodyCount(uint32_t level) const { return level < SIMULATION_LOD_COUNT ? m_LODBodyCounts[level] : 0; }
 
     private:
-        void IntegratePhysics(float dt);
+        // Rigid body with a transform. It keeps its slot for as long as it exists.
+        struct BodyRef {
+            Entity entity = INVALID_ENTITY;
+            RigidBody* rigidBody = nullptr;
+            Transform* transform = nullptr;
+        };
+
+        // Rotation as Euler angles in degrees, like Transform
+        struct BodyPose {
+            glm::vec3 position = glm::vec3(0.0f);
+            glm::vec3 rotation = glm::vec3(0.0f);
+        };
+
+        // Collider gathered for the broadphase, with its world shape and bounds
+        struct ColliderProxy {
+            Entity entity = INVALID_ENTITY;
+            const Transform* transform = nullptr;
+            const Collider* collider = nullptr;
+            uint32_t body = INVALID_BODY;
+            uint32_t layerBit = 0;       // Bit of the collider's layer
+            uint32_t collisionMask = 0;  // Layers it collides with: the collider mask and the layer matrix combined
+            WorldShape shape;
+        };
+
+        // Broadphase pair and its narrowphase result
+        struct PairCandidate {
+            uint32_t proxyA = 0;
+            uint32_t proxyB = 0;
+            ContactPair* pair = nullptr;
+            bool collided = false;
+            bool wakeA = false;  // Deferred wake-ups for sleeping bodies moved from outside
+            bool wakeB = false;
+        };
+
+        static constexpr uint32_t PROXY_BATCH_SIZE = 64;
+        static constexpr uint32_t NARROWPHASE_BATCH_SIZE = 64;
+
+        void SyncBodies();
+        void GatherBodies(float dt);
+        float UpdateSimulationLOD(Entity entity, RigidBody& rb, const glm::vec3& position, float dt);
+        void PromoteOnContact(uint32_t body, uint32_t other);
+        uint32_t FindBody(Entity entity) const;
+        void WakeBody(uint32_t body);
+
+        void IntegrateVelocities();
         void DetectCollisions();
-        void ResolveCollisions();
+        void GatherProxies();
+        void FindCandidatePairs();
+        void BuildLayerLists();
+        bool SweepsBefore(uint32_t proxyA, uint32_t proxyB) const;
+        void RunNarrowphase(PairCandidate& candidate) const;
+        void BuildIslands();
+        void SolveContacts(float dt);
+        void IntegratePositions();
+        void SolveContinuousCollisions();
+        void UpdateSleeping(float dt);
+        void StorePoses();
 
-        bool TestAABBAABB(const AABB& a, const AABB& b, CollisionInfo& info);
-        bool TestSphereSphere(const BoundingSphere& a, const BoundingSphere& b, CollisionInfo& info);
-        bool TestSphereAABB(const BoundingSphere& sphere, const AABB& aabb, CollisionInfo& info);
         bool TestRayAABB(const Ray& ray, const AABB& aabb, float& tMin, float& tMax);
         bool TestRaySphere(const Ray& ray, const BoundingSphere& sphere, float& t);
 
         World* m_World = nullptr;
+        uint32_t m_WorldClearCount = 0;
+        JobSystem* m_JobSystem = nullptr;
         glm::vec3 m_Gravity = glm::vec3(0.0f, -9.81f, 0.0f);
+        float m_ContactMargin = 0.02f;
+
+        std::vector<CollisionInfo> m_Collisions;     // Touching pairs, triggers included
+        std::vector<ContactPair*> m_CollisionPairs;  // Cache entry of each solid contact the solver sees, speculative ones included
+        ContactEventCallback m_ContactEventCallback;
+
+        ContactCache m_ContactCache;
+        ContactEvents m_ContactEvents;
+
+        std::vector<BodyRef> m_Bodies;
+        std::unordered_map<Entity, uint32_t> m_BodyLookup;
+        BodyState m_BodyState;
+        bool m_BodiesSynced = false;       // The body list matches the pool versions below
+        uint32_t m_RigidBodyPoolVersion = 0;
+        uint32_t m_TransformPoolVersion = 0;
+        std::vector<BodyPose> m_PreviousPoses;  // Per body, from before the last step
+        std::vector<BodyPose> m_CurrentPoses;   // Per body, from after the last step
+        bool m_PosesChanged = false;
+
+        // Published copy of the poses and body lookup, read by rendering
+        std::vector<BodyPose> m_RenderPreviousPoses;
+        std::vector<BodyPose> m_RenderCurrentPoses;
+        std::unordered_map<Entity, uint32_t> m_RenderLookup;
+        bool m_RenderLookupCurrent = false;  // Same as the body lookup, so publishing needn't copy it
+
+        std::vector<ColliderProxy> m_Proxies;
+        std::vector<uint32_t> m_BodyProxies;  // Proxy index of each body, if it has a collider
+        LayerMatrix m_LayerMatrix;
+        std::array<std::vector<uint32_t>, LayerMatrix::MAX_LAYERS> m_LayerProxies;  // Proxies of each layer, sorted along the sweep axis
+        std::array<uint32_t, LayerMatrix::MAX_LAYERS> m_LayerCollisionMasks = {};  // Union of the masks of each layer's proxies
+        std::array<float, LayerMatrix::MAX_LAYERS> m_LayerMaxExtents = {};         // Longest proxy of each layer along the sweep axis
+        uint32_t m_ActiveLayers = 0;
+        uint32_t m_SweepAxis = 0;
+        std::vector<PairCandidate> m_Candidates;
+        std::vector<std::vector<PairCandidate>> m_CandidateBatches;
+
+        ContactSolver m_Solver;
+        std::vector<SolverBody> m_SolverBodies;
+        std::vector<SolverContact> m_SolverContacts;
+
+        IslandBuilder m_IslandBuilder;
+        std::vector<Island> m_Islands;
+        std::vector<uint32_t> m_AwakeIslands;
+        SleepSettings m_SleepSettings;
+        uint32_t m_SleepingBodyCount = 0;
 
-        std::vector<CollisionInfo> m_Collisions;
-        CollisionCallback m_CollisionCallback;
+        SimulationLODSettings m_LODSettings;
+        std::vector<glm::vec3> m_LODViewers;
+        std::array<uint32_t, SIMULATION_LOD_COUNT> m_LODBodyCounts = {};
+        uint64_t m_StepCount = 0;
+        PhysicsStepStats m_StepStats;
+        float m_DeltaTime = 0.0f;  // Of the current step
     };
 
 }
@@ -0,0 +1,239 @@
+#include "Shapes.h"
+#include "../ECS/Components/Transform.h"
+
+namespace Xi {
+
+    glm::vec3 OrientedBox::Support(const glm::vec3& direction) const {
+        glm::vec3 result = center;
+        for (int i = 0; i < 3; i++) {
+            float sign = glm::dot(axes[i], direction) >= 0.0f ? 1.0f : -1.0f;
+            result += axes[i] * (halfExtents[i] * sign);
+        }
+        return result;
+    }
+
+    AABB OrientedBox::GetAABB() const {
+        glm::vec3 extents;
+        for (int i = 0; i < 3; i++) {
+            // Row i of the rotation, projected onto the half extents
+            extents[i] = glm::abs(axes[0][i]) * halfExtents.x +
+                         glm::abs(axes[1][i]) * halfExtents.y +
+                         glm::abs(axes[2][i]) * halfExtents.z;
+        }
+        return AABB(center - extents, center + extents);
+    }
+
+    AABB CapsuleShape::GetAABB() const {
+        return AABB(glm::min(a, b) - glm::vec3(radius), glm::max(a, b) + glm::vec3(radius));
+    }
+
+    AABB TriangleGeometry::ToLocal(const AABB& bounds) const {
+        glm::mat3 toLocal = glm::transpose(axes);
+        glm::vec3 center = ToLocal(bounds.GetCenter());
+        glm::vec3 extents = bounds.GetExtents();
+
+        glm::vec3 localExtents;
+        for (int i = 0; i < 3; i++) {
+            localExtents[i] = (glm::abs(toLocal[0][i]) * extents.x +
+                               glm::abs(toLocal[1][i]) * extents.y +
+                               glm::abs(toLocal[2][i]) * extents.z) / glm::abs(scale[i]);
+        }
+        return AABB(center - localExtents, center + localExtents);
+    }
+
+    AABB TriangleGeometry::ToWorld(const AABB& bounds) const {
+        glm::vec3 center = ToWorld(bounds.GetCenter());
+        glm::vec3 extents = bounds.GetExtents() * glm::abs(scale);
+
+        glm::vec3 worldExtents;
+        for (int i = 0; i < 3; i++) {
+            worldExtents[i] = glm::abs(axes[0][i]) * extents.x +
+                              glm::abs(axes[1][i]) * extents.y +
+                              glm::abs(axes[2][i]) * extents.z;
+        }
+        return AABB(center - worldExtents, center + worldExtents);
+    }
+
+    bool TriangleGeometry::Raycast(const Ray& ray, float maxDistance, float& distance, glm::vec3& normal) const {
+        // The direction isn't renormalized in local space, so t stays a world distance
+        glm::vec3 origin = ToLocal(ray.origin);
+        glm::vec3 direction = (glm::transpose(axes) * ray.direction) / scale;
+
+        glm::vec3 localNormal;
+        bool hit = false;
+        if (mesh) {
+            hit = mesh->Raycast(origin, direction, maxDistance, distance, localNormal);
+        } else if (heightfield) {
+            hit = heightfield->Raycast(origin, direction, maxDistance, distance, localNormal);
+        }
+        if (!hit) return false;
+
+        // Normals transform by the inverse transpose
+        normal = glm::normalize(axes * (localNormal / scale));
+        return true;
+    }
+
+    glm::mat3 GetRotationMatrix(const Transform& transform) {
+        if (transform.rotation == glm::vec3(0.0f)) return glm::mat3(1.0f);
+
+        // Same order as Transform::GetMatrix
+        glm::mat4 mat = glm::mat4(1.0f);
+        mat = glm::rotate(mat, glm::radians(transform.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        mat = glm::rotate(mat, glm::radians(transform.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        mat = glm::rotate(mat, glm::radians(transform.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        return glm::mat3(mat);
+    }
+
+    WorldShape MakeWorldShape(const Collider& collider, const Transform& transform) {
+        WorldShape shape;
+        shape.type = collider.type;
+
+        glm::mat3 rotation = GetRotationMatrix(transform);
+        glm::vec3 worldCenter = transform.position + rotation * collider.center;
+        const glm::vec3& scale = transform.scale;
+
+        switch (collider.type) {
+            case ColliderType::Box:
+                shape.box.center = worldCenter;
+                shape.box.axes = rotation;
+                shape.box.halfExtents = glm::abs(collider.size * scale) * 0.5f;
+                shape.bounds = shape.box.GetAABB();
+                break;
+
+            case ColliderType::Sphere:
+                shape.sphere = BoundingSphere(worldCenter, collider.radius * glm::max(scale.x, glm::max(scale.y, scale.z)));
+                shape.bounds = AABB(worldCenter - glm::vec3(shape.sphere.radius), worldCenter + glm::vec3(shape.sphere.radius));
+                break;
+
+            case ColliderType::Capsule: {
+                // Capsules stand along the body's local Y axis; height is the length of the inner segment
+                glm::vec3 halfSegment = rotation[1] * (collider.height * scale.y * 0.5f);
+                shape.capsule.a = worldCenter - halfSegment;
+                shape.capsule.b = worldCenter + halfSegment;
+                shape.capsule.radius = collider.radius * glm::max(scale.x, scale.z);
+                shape.bounds = shape.capsule.GetAABB();
+                break;
+            }
+
+            case ColliderType::Mesh:
+            case ColliderType::Heightfield: {
+                TriangleGeometry& geometry = shape.geometry;
+                geometry.origin = worldCenter;
+                geometry.axes = rotation;
+                geometry.scale = scale;
+
+                AABB localBounds(glm::vec3(0.0f), glm::vec3(0.0f));
+                if (collider.type == ColliderType::Mesh && collider.triangleMesh) {
+                    geometry.mesh = collider.triangleMesh.get();
+                    localBounds = geometry.mesh->GetBounds();
+                } else if (collider.type == ColliderType::Heightfield && collider.heightfield) {
+                    geometry.heightfield = collider.heightfield.get();
+                    localBounds = geometry.heightfield->GetBounds();
+                }
+                shape.bounds = geometry.ToWorld(localBounds);
+                break;
+            }
+        }
+
+        return shape;
+    }
+
+    glm::vec3 ClosestPointOnSegment(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b) {
+        glm::vec3 ab = b - a;
+        float lengthSq = glm::dot(ab, ab);
+        if (lengthSq < 1e-12f) return a;
+
+        float t = glm::clamp(glm::dot(point - a, ab) / lengthSq, 0.0f, 1.0f);
+        return a + ab * t;
+    }
+
+    // Ericson, Real-Time Collision Detection 5.1.5: find the Voronoi region of the point
+    glm::vec3 ClosestPointOnTriangle(const glm::vec3& point, const Triangle& triangle) {
+        const glm::vec3& a = triangle.a;
+        const glm::vec3& b = triangle.b;
+        const glm::vec3& c = triangle.c;
+
+        glm::vec3 ab = b - a;
+        glm::vec3 ac = c - a;
+        glm::vec3 ap = point - a;
+        float d1 = glm::dot(ab, ap);
+        float d2 = glm::dot(ac, ap);
+        if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+        glm::vec3 bp = point - b;
+        float d3 = glm::dot(ab, bp);
+        float d4 = glm::dot(ac, bp);
+        if (d3 >= 0.0f && d4 <= d3) return b;
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+            return a + ab * (d1 / (d1 - d3));
+        }
+
+        glm::vec3 cp = point - c;
+        float d5 = glm::dot(ab, cp);
+        float d6 = glm::dot(ac, cp);
+        if (d6 >= 0.0f && d5 <= d6) return c;
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+            return a + ac * (d2 / (d2 - d6));
+        }
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+            return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        }
+
+        float denom = 1.0f / (va + vb + vc);
+        return a + ab * (vb * denom) + ac * (vc * denom);
+    }
+
+    void ClosestPointsSegmentSegment(const glm::vec3& p1, const glm::vec3& q1,
+                                     const glm::vec3& p2, const glm::vec3& q2,
+                                     glm::vec3& c1, glm::vec3& c2) {
+        constexpr float EPSILON = 1e-12f;
+
+        glm::vec3 d1 = q1 - p1;
+        glm::vec3 d2 = q2 - p2;
+        glm::vec3 r = p1 - p2;
+        float a = glm::dot(d1, d1);
+        float e = glm::dot(d2, d2);
+        float f = glm::dot(d2, r);
+
+        float s = 0.0f;
+        float t = 0.0f;
+
+        if (a <= EPSILON && e <= EPSILON) {
+            // Both segments are points
+        } else if (a <= EPSILON) {
+            t = glm::clamp(f / e, 0.0f, 1.0f);
+        } else {
+            float c = glm::dot(d1, r);
+            if (e <= EPSILON) {
+                s = glm::clamp(-c / a, 0.0f, 1.0f);
+            } else {
+                float b = glm::dot(d1, d2);
+                float denom = a * e - b * b;
+
+                // Parallel segments pick s = 0 and let the clamp below find t
+                if (denom > EPSILON) {
+                    s = glm::clamp((b * f - c * e) / denom, 0.0f, 1.0f);
+                }
+
+                t = (b * s + f) / e;
+                if (t < 0.0f) {
+                    t = 0.0f;
+                    s = glm::clamp(-c / a, 0.0f, 1.0f);
+                } else if (t > 1.0f) {
+                    t = 1.0f;
+                    s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+                }
+            }
+        }
+
+        c1 = p1 + d1 * s;
+        c2 = p2 + d2 * t;
+    }
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Collider.h"
+#include "TriangleMesh.h"
+#include "Heightfield.h"
+#include "../ECS/Components/Collider.h"
+#include <glm/glm.hpp>
+
+namespace Xi {
+
+    struct Transform;
+
+    // Box with arbitrary orientation. Columns of axes are the box's local X/Y/Z in world space.
+    struct OrientedBox {
+        glm::vec3 center = glm::vec3(0.0f);
+        glm::mat3 axes = glm::mat3(1.0f);
+        glm::vec3 halfExtents = glm::vec3(0.5f);
+
+        glm::vec3 ToLocal(const glm::vec3& point) const { return glm::transpose(axes) * (point - center); }
+        glm::vec3 ToWorld(const glm::vec3& local) const { return center + axes * local; }
+
+        // Furthest corner along a direction
+        glm::vec3 Support(const glm::vec3& direction) const;
+
+        AABB GetAABB() const;
+    };
+
+    // Sphere swept along the segment [a, b]
+    struct CapsuleShape {
+        glm::vec3 a = glm::vec3(0.0f);
+        glm::vec3 b = glm::vec3(0.0f);
+        float radius = 0.5f;
+
+        AABB GetAABB() const;
+    };
+
+    // Static triangle geometry placed in the world. Queries run in the geometry's local
+    // space and hand back world-space triangles, so any rotation and scale work.
+    struct TriangleGeometry {
+        const TriangleMesh* mesh = nullptr;        // Set for ColliderType::Mesh
+        const Heightfield* heightfield = nullptr;  // Set for ColliderType::Heightfield
+        glm::vec3 origin = glm::vec3(0.0f);
+        glm::mat3 axes = glm::mat3(1.0f);
+        glm::vec3 scale = glm::vec3(1.0f);
+
+        glm::vec3 ToLocal(const glm::vec3& point) const { return (glm::transpose(axes) * (point - origin)) / scale; }
+        glm::vec3 ToWorld(const glm::vec3& local) const { return origin + axes * (local * scale); }
+
+        // Bounds of a box after moving it between spaces
+        AABB ToLocal(const AABB& bounds) const;
+        AABB ToWorld(const AABB& bounds) const;
+
+        // Heightfields only push shapes out through their top surface
+        bool IsOneSided() const { return heightfield != nullptr; }
+
+        // Calls func(triangle) with every world-space triangle that may overlap the world-space box
+        template<typename Func>
+        void QueryTriangles(const AABB& bounds, Func&& func) const;
+
+        bool Raycast(const Ray& ray, float maxDistance, float& distance, glm::vec3& normal) const;
+    };
+
+    // A collider resolved against its transform, ready for the narrowphase
+    struct WorldShape {
+        ColliderType type = ColliderType::Box;
+        OrientedBox box;
+        BoundingSphere sphere;
+        CapsuleShape capsule;
+        TriangleGeometry geometry;
+        AABB bounds;
+    };
+
+    glm::mat3 GetRotationMatrix(const Transform& transform);
+
+    // The collider's center offset rotates with the body but is not scaled, as in Collider::GetAABBMin
+    WorldShape MakeWorldShape(const Collider& collider, const Transform& transform);
+
+    // Closest points between segments [p1, q1] and [p2, q2]
+    void ClosestPointsSegmentSegment(const glm::vec3& p1, const glm::vec3& q1,
+                                     const glm::vec3& p2, const glm::vec3& q2,
+                                     glm::vec3& c1, glm::vec3& c2);
+
+    glm::vec3 ClosestPointOnSegment(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b);
+
+    glm::vec3 ClosestPointOnTriangle(const glm::vec3& point, const Triangle& triangle);
+
+    template<typename Func>
+    void TriangleGeometry::QueryTriangles(const AABB& bounds, Func&& func) const {
+        AABB local = ToLocal(bounds);
+
+        // A mirroring scale flips the winding, so swap two corners to keep the front face
+        bool mirrored = scale.x * scale.y * scale.z < 0.0f;
+
+        auto emit = [&](const Triangle& triangle) {
+            Triangle world;
+            world.a = ToWorld(triangle.a);
+            world.b = ToWorld(mirrored ? triangle.c : triangle.b);
+            world.c = ToWorld(mirrored ? triangle.b : triangle.c);
+            func(world);
+        };
+
+        if (mesh) {
+            mesh->QueryTriangles(local, [&](uint32_t index) { emit(mesh->GetTriangle(index)); });
+        } else if (heightfield) {
+            heightfield->QueryTriangles(local, emit);
+        }
+    }
+
+}
@@ -0,0 +1,233 @@
+#include "TriangleMesh.h"
+#include "../Renderer/Mesh.h"
+#include "../Core/Log.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace Xi {
+
+    glm::vec3 Triangle::GetNormal() const {
+        glm::vec3 n = glm::cross(b - a, c - a);
+        float length = glm::length(n);
+        return length > 1e-12f ? n / length : glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+
+    // Moller-Trumbore
+    bool Triangle::Raycast(const glm::vec3& origin, const glm::vec3& direction, float& t) const {
+        glm::vec3 e1 = b - a;
+        glm::vec3 e2 = c - a;
+        glm::vec3 p = glm::cross(direction, e2);
+        float det = glm::dot(e1, p);
+        if (std::abs(det) < 1e-12f) return false;
+
+        float invDet = 1.0f / det;
+        glm::vec3 s = origin - a;
+        float u = glm::dot(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f) return false;
+
+        glm::vec3 q = glm::cross(s, e1);
+        float v = glm::dot(direction, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return false;
+
+        t = glm::dot(e2, q) * invDet;
+        return t >= 0.0f;
+    }
+
+    TriangleMesh::TriangleMesh(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices) {
+        Build(vertices, indices);
+    }
+
+    TriangleMesh::TriangleMesh(const Mesh& mesh) {
+        std::vector<glm::vec3> positions;
+        positions.reserve(mesh.GetVertexCount());
+        for (const Vertex& vertex : mesh.GetVertices()) {
+            positions.push_back(vertex.position);
+        }
+        Build(positions, mesh.GetIndices());
+    }
+
+    void TriangleMesh::Build(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices) {
+        m_Vertices = vertices;
+        m_Indices.clear();
+        m_Nodes.clear();
+
+        // Drop degenerate and out-of-range triangles up front so queries never see them
+        std::vector<uint32_t> triangles;
+        triangles.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            uint32_t i0 = indices[i], i1 = indices[i + 1], i2 = indices[i + 2];
+            if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size()) continue;
+
+            glm::vec3 n = glm::cross(vertices[i1] - vertices[i0], vertices[i2] - vertices[i0]);
+            if (glm::dot(n, n) < 1e-20f) continue;
+
+            triangles.insert(triangles.end(), { i0, i1, i2 });
+        }
+
+        uint32_t triangleCount = static_cast<uint32_t>(triangles.size() / 3);
+        if (triangleCount == 0) {
+            XI_LOG_WARN("Triangle mesh collider has no valid triangles");
+            return;
+        }
+
+        std::vector<uint32_t> order(triangleCount);
+        std::vector<AABB> triangleBounds(triangleCount);
+        std::vector<glm::vec3> centroids(triangleCount);
+
+        m_Bounds = AABB(glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX));
+        for (uint32_t i = 0; i < triangleCount; i++) {
+            const glm::vec3& a = vertices[triangles[i * 3]];
+            const glm::vec3& b = vertices[triangles[i * 3 + 1]];
+            const glm::vec3& c = vertices[triangles[i * 3 + 2]];
+
+            order[i] = i;
+            triangleBounds[i] = AABB(glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)));
+            centroids[i] = (a + b + c) / 3.0f;
+            m_Bounds.Expand(triangleBounds[i]);
+        }
+
+        glm::vec3 extent = glm::max(m_Bounds.GetSize(), glm::vec3(1e-6f));
+        m_QuantizeScale = glm::vec3(65535.0f) / extent;
+
+        m_Nodes.reserve(2 * triangleCount / MAX_LEAF_TRIANGLES + 1);
+        BuildNode(order, triangleBounds, centroids, 0, triangleCount);
+
+        // Store the triangles in leaf order so each leaf is a contiguous range
+        m_Indices.resize(triangleCount * 3);
+        for (uint32_t i = 0; i < triangleCount; i++) {
+            for (uint32_t k = 0; k < 3; k++) {
+                m_Indices[i * 3 + k] = triangles[order[i] * 3 + k];
+            }
+        }
+
+        XI_LOG_INFO("Triangle mesh collider built: " + std::to_string(triangleCount) + " triangles, " +
+                    std::to_string(m_Nodes.size()) + " nodes, " + std::to_string(GetMemoryUsage() / 1024) + " KB");
+    }
+
+    // Top-down build splitting at the centroid median of the longest axis. Nodes are
+    // emitted depth-first, so a node's left child is always the next node.
+    uint32_t TriangleMesh::BuildNode(std::vector<uint32_t>& order, std::vector<AABB>& triangleBounds,
+                                     std::vector<glm::vec3>& centroids, uint32_t begin, uint32_t end) {
+        uint32_t index = static_cast<uint32_t>(m_Nodes.size());
+        m_Nodes.emplace_back();
+
+        AABB bounds(glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX));
+        AABB centroidBounds(glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX));
+        for (uint32_t i = begin; i < end; i++) {
+            bounds.Expand(triangleBounds[order[i]]);
+            centroidBounds.Expand(centroids[order[i]]);
+        }
+
+        Node node;
+        Quantize(bounds, node.min, node.max);
+
+        uint32_t count = end - begin;
+        if (count <= MAX_LEAF_TRIANGLES) {
+            node.data = LEAF_FLAG | (begin << LEAF_COUNT_BITS) | count;
+            m_Nodes[index] = node;
+            return index;
+        }
+
+        glm::vec3 size = centroidBounds.GetSize();
+        int axis = 0;
+        if (size.y > size[axis]) axis = 1;
+        if (size.z > size[axis]) axis = 2;
+
+        // Ties broken by triangle index keep the build deterministic
+        uint32_t mid = begin + count / 2;
+        std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+            [&centroids, axis](uint32_t a, uint32_t b) {
+                if (centroids[a][axis] != centroids[b][axis]) return centroids[a][axis] < centroids[b][axis];
+                return a < b;
+            });
+
+        BuildNode(order, triangleBounds, centroids, begin, mid);
+        node.data = BuildNode(order, triangleBounds, centroids, mid, end);
+        m_Nodes[index] = node;
+        return index;
+    }
+
+    // Rounds outwards so the quantized box always contains the real one
+    void TriangleMesh::Quantize(const AABB& bounds, uint16_t* outMin, uint16_t* outMax) const {
+        glm::vec3 lo = glm::floor((bounds.min - m_Bounds.min) * m_QuantizeScale);
+        glm::vec3 hi = glm::ceil((bounds.max - m_Bounds.min) * m_QuantizeScale);
+        lo = glm::clamp(lo, glm::vec3(0.0f), glm::vec3(65535.0f));
+        hi = glm::clamp(hi, glm::vec3(0.0f), glm::vec3(65535.0f));
+
+        for (int i = 0; i < 3; i++) {
+            outMin[i] = static_cast<uint16_t>(lo[i]);
+            outMax[i] = static_cast<uint16_t>(hi[i]);
+        }
+    }
+
+    AABB TriangleMesh::Dequantize(const Node& node) const {
+        glm::vec3 lo(node.min[0], node.min[1], node.min[2]);
+        glm::vec3 hi(node.max[0], node.max[1], node.max[2]);
+        return AABB(m_Bounds.min + lo / m_QuantizeScale, m_Bounds.min + hi / m_QuantizeScale);
+    }
+
+    Triangle TriangleMesh::GetTriangle(uint32_t index) const {
+        Triangle triangle;
+        triangle.a = m_Vertices[m_Indices[index * 3]];
+        triangle.b = m_Vertices[m_Indices[index * 3 + 1]];
+        triangle.c = m_Vertices[m_Indices[index * 3 + 2]];
+        return triangle;
+    }
+
+    // Slab test against a box, clipped to [0, maxT]
+    static bool RayIntersectsBox(const glm::vec3& origin, const glm::vec3& invDirection, const AABB& box, float maxT) {
+        glm::vec3 t1 = (box.min - origin) * invDirection;
+        glm::vec3 t2 = (box.max - origin) * invDirection;
+        glm::vec3 tNear = glm::min(t1, t2);
+        glm::vec3 tFar = glm::max(t1, t2);
+
+        float enter = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+        float exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxT));
+        return enter <= exit;
+    }
+
+    bool TriangleMesh::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxT,
+                               float& t, glm::vec3& normal) const {
+        if (m_Nodes.empty()) return false;
+
+        // Division by zero gives infinities, which the slab test handles
+        glm::vec3 invDirection = 1.0f / direction;
+        bool hit = false;
+        t = maxT;
+
+        uint32_t stack[64];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0) {
+            uint32_t index = stack[--stackSize];
+            const Node& node = m_Nodes[index];
+            if (!RayIntersectsBox(origin, invDirection, Dequantize(node), t)) continue;
+
+            if (node.data & LEAF_FLAG) {
+                uint32_t first = (node.data & ~LEAF_FLAG) >> LEAF_COUNT_BITS;
+                uint32_t count = node.data & ((1u << LEAF_COUNT_BITS) - 1);
+                for (uint32_t i = first; i < first + count; i++) {
+                    Triangle triangle = GetTriangle(i);
+                    float hitT;
+                    if (triangle.Raycast(origin, direction, hitT) && hitT < t) {
+                        t = hitT;
+                        normal = triangle.GetNormal();
+                        hit = true;
+                    }
+                }
+            } else {
+                stack[stackSize++] = node.data;
+                stack[stackSize++] = index + 1;
+            }
+        }
+
+        return hit;
+    }
+
+    size_t TriangleMesh::GetMemoryUsage() const {
+        return m_Vertices.size() * sizeof(glm::vec3) + m_Indices.size() * sizeof(uint32_t) + m_Nodes.size() * sizeof(Node);
+    }
+
+}
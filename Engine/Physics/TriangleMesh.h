@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Collider.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace Xi {
+
+    class Mesh;
+
+    struct Triangle {
+        glm::vec3 a = glm::vec3(0.0f);
+        glm::vec3 b = glm::vec3(0.0f);
+        glm::vec3 c = glm::vec3(0.0f);
+
+        glm::vec3 GetNormal() const;  // Counter-clockwise winding faces the viewer
+
+        // Hits either side; t is in units of direction
+        bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float& t) const;
+    };
+
+    // Static triangle soup with a bounding volume hierarchy over it, for level geometry.
+    // Node bounds are quantized to 16 bits per axis against the mesh bounds, so a node
+    // takes 16 bytes and overlap queries compare integers.
+    class TriangleMesh {
+    public:
+        TriangleMesh(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+        explicit TriangleMesh(const Mesh& mesh);
+
+        // Calls func(triangleIndex) for every triangle whose node bounds overlap the
+        // local-space box. The same triangle is never reported twice.
+        template<typename Func>
+        void QueryTriangles(const AABB& bounds, Func&& func) const;
+
+        // Closest hit along origin + direction * t for t in [0, maxT], in local space
+        bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxT, float& t, glm::vec3& normal) const;
+
+        Triangle GetTriangle(uint32_t index) const;
+
+        const AABB& GetBounds() const { return m_Bounds; }
+
+        // Source triangles in leaf order, enough to build an identical mesh from
+        const std::vector<glm::vec3>& GetVertices() const { return m_Vertices; }
+        const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
+
+        uint32_t GetTriangleCount() const { return static_cast<uint32_t>(m_Indices.size() / 3); }
+        uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_Nodes.size()); }
+        size_t GetMemoryUsage() const;
+
+    private:
+        struct Node {
+            uint16_t min[3];
+            uint16_t max[3];
+            // Internal: index of the right child, the left child follows this node.
+            // Leaf: LEAF_FLAG | first triangle << LEAF_COUNT_BITS | triangle count.
+            uint32_t data;
+        };
+
+        static constexpr uint32_t LEAF_FLAG = 0x80000000u;
+        static constexpr uint32_t LEAF_COUNT_BITS = 3;
+        static constexpr uint32_t MAX_LEAF_TRIANGLES = 4;
+
+        void Build(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+        uint32_t BuildNode(std::vector<uint32_t>& order, std::vector<AABB>& triangleBounds,
+                           std::vector<glm::vec3>& centroids, uint32_t begin, uint32_t end);
+
+        void Quantize(const AABB& bounds, uint16_t* outMin, uint16_t* outMax) const;
+        AABB Dequantize(const Node& node) const;
+
+        std::vector<glm::vec3> m_Vertices;
+        std::vector<uint32_t> m_Indices;  // Three per triangle, in leaf order
+        std::vector<Node> m_Nodes;        // Depth-first, root first
+        AABB m_Bounds;
+        glm::vec3 m_QuantizeScale = glm::vec3(0.0f);
+    };
+
+    template<typename Func>
+    void TriangleMesh::QueryTriangles(const AABB& bounds, Func&& func) const {
+        if (m_Nodes.empty() || !m_Bounds.Intersects(bounds)) return;
+
+        uint16_t queryMin[3], queryMax[3];
+        Quantize(bounds, queryMin, queryMax);
+
+        uint32_t stack[64];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0) {
+            const Node& node = m_Nodes[stack[--stackSize]];
+
+            if (node.min[0] > queryMax[0] || node.max[0] < queryMin[0] ||
+                node.min[1] > queryMax[1] || node.max[1] < queryMin[1] ||
+                node.min[2] > queryMax[2] || node.max[2] < queryMin[2]) {
+                continue;
+            }
+
+            if (node.data & LEAF_FLAG) {
+                uint32_t first = (node.data & ~LEAF_FLAG) >> LEAF_COUNT_BITS;
+                uint32_t count = node.data & ((1u << LEAF_COUNT_BITS) - 1);
+                for (uint32_t i = 0; i < count; i++) {
+                    func(first + i);
+                }
+            } else {
+                uint32_t index = static_cast<uint32_t>(&node - m_Nodes.data());
+                stack[stackSize++] = node.data;
+                stack[stackSize++] = index + 1;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Mesh.h"
+#include "Material.h"
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Xi {
+
+    struct LightData {
+        enum class Type { Directional, Point, Spot };
+
+        Type type = Type::Directional;
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::vec3 direction = glm::vec3(0.0f, -1.0f, 0.0f);
+        glm::vec3 color = glm::vec3(1.0f);
+        float intensity = 1.0f;
+        float range = 10.0f;           // Point and spot lights fade to nothing here
+        float attenuation = 1.0f;      // Inverse-square falloff: intensity / (1 + attenuation * distance^2)
+        float spotAngle = 45.0f;       // Degrees from the axis to the cone's edge
+        float innerSpotAngle = 30.0f;  // Full intensity inside this, fading out to spotAngle
+    };
+
+    // One frame as the render side sees it: built by Renderer::EndFrame on the game thread,
+    // drawn by Renderer::ExecutePacket, possibly on the render thread while the game moves
+    // on. It holds copies rather than pointers to game objects, meshes as their draw info and
+    // materials by value, so the game can change or destroy them while the packet waits. The
+    // render thread defers deleting a mesh's vertex array until the packets using it are drawn.
+    struct FramePacket {
+        // A run of sorted commands sharing mesh and material
+        struct Draw {
+            MeshDrawInfo mesh;
+            uint32_t material = 0;        // Into materials
+            uint32_t firstTransform = 0;  // Into instanceData if instanced, otherwise transforms
+            uint32_t count = 0;
+            bool instanced = false;
+            bool transparent = false;
+        };
+
+        // What drawing the packet took, written by ExecutePacket
+        struct SubmitStats {
+            uint32_t drawCalls = 0;
+            uint32_t triangles = 0;
+            uint32_t instancedDrawCalls = 0;
+            uint32_t instancedObjects = 0;
+            uint32_t materialBinds = 0;
+            uint32_t stateChanges = 0;
+            uint32_t stateChangesAvoided = 0;
+            float submitTimeMs = 0.0f;
+        };
+
+        glm::mat4 view = glm::mat4(1.0f);
+        glm::mat4 projection = glm::mat4(1.0f);
+        glm::vec3 cameraPosition = glm::vec3(0.0f);
+
+        // Directional lights first; they light everything. The point and spot lights after them
+        // are binned into clusters, each an offset and count into clusterLightIndices, which
+        // index lights. See LightClusters for the grid.
+        std::vector<LightData> lights;
+        uint32_t directionalLightCount = 0;
+        std::vector<glm::uvec2> clusters;
+        std::vector<uint32_t> clusterLightIndices;
+        float clusterSliceScale = 0.0f;
+        float clusterSliceBias = 0.0f;
+
+        std::vector<Material> materials;       // Each material the draws use, once
+        std::vector<Draw> draws;               // In draw order
+        std::vector<glm::mat4> instanceData;   // Uploaded in one piece for the instanced draws
+        std::vector<glm::mat4> transforms;     // Model matrices of the other draws
+
+        // The window area the render thread clears and draws to; 0 leaves the viewport alone
+        uint32_t targetWidth = 0;
+        uint32_t targetHeight = 0;
+        glm::vec4 clearColor = glm::vec4(0.1f, 0.1f, 0.1f, 1.0f);
+
+        SubmitStats stats;
+
+        // Keeps the storage for the next frame
+        void Clear() {
+            lights.clear();
+            clusters.clear();
+            clusterLightIndices.clear();
+            materials.clear();
+            draws.clear();
+            instanceData.clear();
+            transforms.clear();
+        }
+    };
+
+}
@@ -1,8 +1,7 @@
 #include "Framebuffer.h"
+#include "RenderDevice.h"
 #include "../Core/Log.h"
 
-#include <GL/glew.h>
-
 namespace Xi {
 
     Framebuffer::Framebuffer(const FramebufferSpec& spec)
@@ -12,53 +11,47 @@ namespace Xi {
     }
 
     Framebuffer::~Framebuffer() {
-        if (m_FramebufferID) {
-            glDeleteFramebuffers(1, &m_FramebufferID);
-            glDeleteTextures(1, &m_ColorAttachment);
-            glDeleteTextures(1, &m_DepthAttachment);
-        }
+        Release();
     }
 
-    void Framebuffer::Invalidate() {
+    void Framebuffer::Release() {
         if (m_FramebufferID) {
-            glDeleteFramebuffers(1, &m_FramebufferID);
-            glDeleteTextures(1, &m_ColorAttachment);
-            glDeleteTextures(1, &m_DepthAttachment);
+            RenderDevice& device = RenderDevice::Get();
+            device.DeleteFramebuffer(m_FramebufferID);
+            device.DeleteTexture(m_ColorAttachment);
+            device.DeleteTexture(m_DepthAttachment);
+            m_FramebufferID = m_ColorAttachment = m_DepthAttachment = 0;
         }
+    }
 
-        glGenFramebuffers(1, &m_FramebufferID);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferID);
+    void Framebuffer::Invalidate() {
+        Release();
 
-        // Color attachment
-        glGenTextures(1, &m_ColorAttachment);
-        glBindTexture(GL_TEXTURE_2D, m_ColorAttachment);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Spec.width, m_Spec.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorAttachment, 0);
+        RenderDevice& device = RenderDevice::Get();
 
-        // Depth attachment
-        glGenTextures(1, &m_DepthAttachment);
-        glBindTexture(GL_TEXTURE_2D, m_DepthAttachment);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, m_Spec.width, m_Spec.height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_DepthAttachment, 0);
+        TextureDesc color;
+        color.width = m_Spec.width;
+        color.height = m_Spec.height;
+        color.format = TextureFormat::RGBA8;
+        color.wrapS = TextureWrap::ClampToEdge;
+        color.wrapT = TextureWrap::ClampToEdge;
+        m_ColorAttachment = device.CreateTexture(color, nullptr);
 
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-            XI_LOG_ERROR("Framebuffer is not complete!");
-        }
+        TextureDesc depth = color;
+        depth.format = TextureFormat::Depth24Stencil8;
+        depth.minFilter = TextureFilter::Nearest;
+        depth.magFilter = TextureFilter::Nearest;
+        m_DepthAttachment = device.CreateTexture(depth, nullptr);
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        m_FramebufferID = device.CreateFramebuffer(m_ColorAttachment, m_DepthAttachment);
     }
 
     void Framebuffer::Bind() {
-        glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferID);
-        glViewport(0, 0, m_Spec.width, m_Spec.height);
+        RenderDevice::Get().BindFramebuffer(m_FramebufferID, m_Spec.width, m_Spec.height);
     }
 
     void Framebuffer::Unbind() {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        RenderDevice::Get().BindFramebuffer(0, m_Spec.width, m_Spec.height);
     }
 
     void Framebuffer::Resize(uint32_t width, uint32_t height) {
@@ -30,6 +30,7 @@ namespace Xi {
 
     private:
         void Invalidate();
+        void Release();
 
         uint32_t m_FramebufferID = 0;
         uint32_t m_ColorAttachment = 0;
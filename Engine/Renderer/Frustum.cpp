@@ -0,0 +1,187 @@
+#include "Frustum.h"
+#include "../Core/Simd.h"
+#include <cmath>
+
+namespace Xi {
+
+    Frustum::Frustum(const glm::mat4& viewProjection) {
+        // Gribb-Hartmann: each plane is the last row of the matrix plus or minus another row
+        auto row = [&viewProjection](int i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+
+        m_Planes[Left] = row(3) + row(0);
+        m_Planes[Right] = row(3) - row(0);
+        m_Planes[Bottom] = row(3) + row(1);
+        m_Planes[Top] = row(3) - row(1);
+        m_Planes[Near] = row(3) + row(2);
+        m_Planes[Far] = row(3) - row(2);
+
+        for (auto& plane : m_Planes) {
+            float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f) plane /= length;
+        }
+    }
+
+    bool Frustum::IntersectsBox(const glm::vec3& center, const glm::vec3& extents) const {
+        for (const auto& plane : m_Planes) {
+            glm::vec3 normal(plane);
+            float distance = glm::dot(normal, center) + plane.w;
+            float radius = glm::dot(glm::abs(normal), extents);
+            if (distance + radius < 0.0f) return false;
+        }
+        return true;
+    }
+
+    bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const {
+        for (const auto& plane : m_Planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+
+    void CullingBuffer::Clear() {
+        m_CenterX.clear();
+        m_CenterY.clear();
+        m_CenterZ.clear();
+        m_ExtentX.clear();
+        m_ExtentY.clear();
+        m_ExtentZ.clear();
+        m_Count = 0;
+    }
+
+    uint32_t CullingBuffer::Add(const glm::vec3& center, const glm::vec3& extents) {
+        uint32_t index = m_Count++;
+
+        if (index == m_CenterX.size()) {
+            uint32_t padded = Simd::PadToLanes(m_Count);
+            m_CenterX.resize(padded, 0.0f);
+            m_CenterY.resize(padded, 0.0f);
+            m_CenterZ.resize(padded, 0.0f);
+            m_ExtentX.resize(padded, 0.0f);
+            m_ExtentY.resize(padded, 0.0f);
+            m_ExtentZ.resize(padded, 0.0f);
+        }
+
+        m_CenterX[index] = center.x;
+        m_CenterY[index] = center.y;
+        m_CenterZ[index] = center.z;
+        m_ExtentX[index] = extents.x;
+        m_ExtentY[index] = extents.y;
+        m_ExtentZ[index] = extents.z;
+        return index;
+    }
+
+    struct CullingLanes {
+        const float* cx;
+        const float* cy;
+        const float* cz;
+        const float* ex;
+        const float* ey;
+        const float* ez;
+        uint32_t count;
+        uint32_t padded;
+    };
+
+    static void AppendVisible(uint32_t first, uint32_t width, int mask, uint32_t count, std::vector<uint32_t>& visible) {
+        for (uint32_t lane = 0; lane < width && first + lane < count; lane++) {
+            if (mask & (1 << lane)) visible.push_back(first + lane);
+        }
+    }
+
+    // Baseline x64 path, four boxes per iteration
+    static void CullSSE(const Frustum& frustum, const CullingLanes& lanes, std::vector<uint32_t>& visible) {
+        __m128 nx[Frustum::SideCount], ny[Frustum::SideCount], nz[Frustum::SideCount], w[Frustum::SideCount];
+        __m128 ax[Frustum::SideCount], ay[Frustum::SideCount], az[Frustum::SideCount];
+        for (int p = 0; p < Frustum::SideCount; p++) {
+            const glm::vec4& plane = frustum.GetPlane(static_cast<Frustum::Side>(p));
+            nx[p] = _mm_set1_ps(plane.x);
+            ny[p] = _mm_set1_ps(plane.y);
+            nz[p] = _mm_set1_ps(plane.z);
+            w[p] = _mm_set1_ps(plane.w);
+            ax[p] = _mm_set1_ps(std::abs(plane.x));
+            ay[p] = _mm_set1_ps(std::abs(plane.y));
+            az[p] = _mm_set1_ps(std::abs(plane.z));
+        }
+
+        const __m128 zero = _mm_setzero_ps();
+        for (uint32_t i = 0; i < lanes.padded; i += 4) {
+            __m128 cx = _mm_loadu_ps(lanes.cx + i);
+            __m128 cy = _mm_loadu_ps(lanes.cy + i);
+            __m128 cz = _mm_loadu_ps(lanes.cz + i);
+            __m128 ex = _mm_loadu_ps(lanes.ex + i);
+            __m128 ey = _mm_loadu_ps(lanes.ey + i);
+            __m128 ez = _mm_loadu_ps(lanes.ez + i);
+
+            __m128 inside = _mm_cmpeq_ps(zero, zero);
+            for (int p = 0; p < Frustum::SideCount; p++) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+                                             _mm_add_ps(_mm_mul_ps(nz[p], cz), w[p]));
+                __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)), _mm_mul_ps(az[p], ez));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+            }
+
+            AppendVisible(i, 4, _mm_movemask_ps(inside), lanes.count, visible);
+        }
+    }
+
+    XI_TARGET_AVX2
+    static void CullAVX2(const Frustum& frustum, const CullingLanes& lanes, std::vector<uint32_t>& visible) {
+        __m256 nx[Frustum::SideCount], ny[Frustum::SideCount], nz[Frustum::SideCount], w[Frustum::SideCount];
+        __m256 ax[Frustum::SideCount], ay[Frustum::SideCount], az[Frustum::SideCount];
+        for (int p = 0; p < Frustum::SideCount; p++) {
+            const glm::vec4& plane = frustum.GetPlane(static_cast<Frustum::Side>(p));
+            nx[p] = _mm256_set1_ps(plane.x);
+            ny[p] = _mm256_set1_ps(plane.y);
+            nz[p] = _mm256_set1_ps(plane.z);
+            w[p] = _mm256_set1_ps(plane.w);
+            ax[p] = _mm256_set1_ps(std::abs(plane.x));
+            ay[p] = _mm256_set1_ps(std::abs(plane.y));
+            az[p] = _mm256_set1_ps(std::abs(plane.z));
+        }
+
+        const __m256 zero = _mm256_setzero_ps();
+        for (uint32_t i = 0; i < lanes.padded; i += Simd::LANES) {
+            __m256 cx = _mm256_loadu_ps(lanes.cx + i);
+            __m256 cy = _mm256_loadu_ps(lanes.cy + i);
+            __m256 cz = _mm256_loadu_ps(lanes.cz + i);
+            __m256 ex = _mm256_loadu_ps(lanes.ex + i);
+            __m256 ey = _mm256_loadu_ps(lanes.ey + i);
+            __m256 ez = _mm256_loadu_ps(lanes.ez + i);
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int p = 0; p < Frustum::SideCount; p++) {
+                __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)),
+                                                _mm256_add_ps(_mm256_mul_ps(nz[p], cz), w[p]));
+                __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax[p], ex), _mm256_mul_ps(ay[p], ey)), _mm256_mul_ps(az[p], ez));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+            }
+
+            AppendVisible(i, Simd::LANES, _mm256_movemask_ps(inside), lanes.count, visible);
+        }
+    }
+
+    void CullingBuffer::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+        visible.clear();
+        if (m_Count == 0) return;
+
+        CullingLanes lanes = { m_CenterX.data(), m_CenterY.data(), m_CenterZ.data(),
+                               m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data(),
+                               m_Count, static_cast<uint32_t>(m_CenterX.size()) };
+
+        if (Simd::HasAVX2()) {
+            CullAVX2(frustum, lanes, visible);
+        } else {
+            CullSSE(frustum, lanes, visible);
+        }
+    }
+
+    void TransformBounds(const glm::mat4& transform, const glm::vec3& localCenter, const glm::vec3& localExtents,
+                         glm::vec3& outCenter, glm::vec3& outExtents) {
+        outCenter = glm::vec3(transform * glm::vec4(localCenter, 1.0f));
+        outExtents = glm::abs(glm::vec3(transform[0])) * localExtents.x +
+                     glm::abs(glm::vec3(transform[1])) * localExtents.y +
+                     glm::abs(glm::vec3(transform[2])) * localExtents.z;
+    }
+
+}
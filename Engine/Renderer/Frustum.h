@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Xi {
+
+    // The six planes of a view-projection matrix, normals pointing inwards
+    class Frustum {
+    public:
+        enum Side { Left, Right, Bottom, Top, Near, Far, SideCount };
+
+        Frustum() = default;
+        explicit Frustum(const glm::mat4& viewProjection);
+
+        // xyz is the unit normal, w the distance: dot(normal, p) + w >= 0 inside
+        const glm::vec4& GetPlane(Side side) const { return m_Planes[side]; }
+
+        bool IntersectsBox(const glm::vec3& center, const glm::vec3& extents) const;
+        bool IntersectsSphere(const glm::vec3& center, float radius) const;
+
+    private:
+        std::array<glm::vec4, SideCount> m_Planes = {};
+    };
+
+    // World-space boxes of everything submitted for drawing this frame, kept as a structure
+    // of arrays so the frustum test runs on a full SIMD register of boxes at a time
+    class CullingBuffer {
+    public:
+        void Clear();
+
+        // Returns the box's index, in submission order
+        uint32_t Add(const glm::vec3& center, const glm::vec3& extents);
+
+        // Replaces visible with the indices of the boxes touching the frustum, in order
+        void Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+        uint32_t GetCount() const { return m_Count; }
+
+    private:
+        // Padded to the SIMD width with empty boxes that are never reported
+        std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+        std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+        uint32_t m_Count = 0;
+    };
+
+    // World box around a local box moved by transform
+    void TransformBounds(const glm::mat4& transform, const glm::vec3& localCenter, const glm::vec3& localExtents,
+                         glm::vec3& outCenter, glm::vec3& outExtents);
+
+}
@@ -0,0 +1,355 @@
+#include "GLRenderDevice.h"
+#include "../Core/Log.h"
+
+#include <GL/glew.h>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace Xi {
+
+    static GLenum GetGLTarget(BufferTarget target) {
+        switch (target) {
+            case BufferTarget::Vertex:  return GL_ARRAY_BUFFER;
+            case BufferTarget::Index:   return GL_ELEMENT_ARRAY_BUFFER;
+            case BufferTarget::Uniform: return GL_UNIFORM_BUFFER;
+            case BufferTarget::Storage: return GL_SHADER_STORAGE_BUFFER;
+        }
+        return GL_ARRAY_BUFFER;
+    }
+
+    static GLenum GetGLUsage(BufferUsage usage) {
+        switch (usage) {
+            case BufferUsage::Static:  return GL_STATIC_DRAW;
+            case BufferUsage::Dynamic: return GL_DYNAMIC_DRAW;
+            case BufferUsage::Stream:  return GL_STREAM_DRAW;
+        }
+        return GL_STATIC_DRAW;
+    }
+
+    static GLenum GetGLFilter(TextureFilter filter) {
+        switch (filter) {
+            case TextureFilter::Nearest: return GL_NEAREST;
+            case TextureFilter::Linear:  return GL_LINEAR;
+        }
+        return GL_LINEAR;
+    }
+
+    static GLenum GetGLWrap(TextureWrap wrap) {
+        switch (wrap) {
+            case TextureWrap::Repeat:         return GL_REPEAT;
+            case TextureWrap::ClampToEdge:    return GL_CLAMP_TO_EDGE;
+            case TextureWrap::MirroredRepeat: return GL_MIRRORED_REPEAT;
+        }
+        return GL_REPEAT;
+    }
+
+    uint32_t GLRenderDevice::CreateBuffer(BufferTarget target, size_t size, const void* data, BufferUsage usage) {
+        GLenum glTarget = GetGLTarget(target);
+        uint32_t buffer = 0;
+        glGenBuffers(1, &buffer);
+        if (target == BufferTarget::Index) {
+            // Element buffer bindings belong to the vertex array; don't attach this one to
+            // whichever happens to be bound
+            glBindVertexArray(0);
+        }
+        glBindBuffer(glTarget, buffer);
+        glBufferData(glTarget, static_cast<GLsizeiptr>(size), data, GetGLUsage(usage));
+        glBindBuffer(glTarget, 0);
+        return buffer;
+    }
+
+    void GLRenderDevice::DeleteBuffer(uint32_t buffer) {
+        glDeleteBuffers(1, &buffer);
+    }
+
+    void GLRenderDevice::ReallocateBuffer(BufferTarget target, uint32_t buffer, size_t size, BufferUsage usage) {
+        GLenum glTarget = GetGLTarget(target);
+        glBindBuffer(glTarget, buffer);
+        glBufferData(glTarget, static_cast<GLsizeiptr>(size), nullptr, GetGLUsage(usage));
+        glBindBuffer(glTarget, 0);
+    }
+
+    void GLRenderDevice::UpdateBuffer(BufferTarget target, uint32_t buffer, size_t offset, size_t size, const void* data) {
+        GLenum glTarget = GetGLTarget(target);
+        glBindBuffer(glTarget, buffer);
+        glBufferSubData(glTarget, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+        glBindBuffer(glTarget, 0);
+    }
+
+    void GLRenderDevice::BindBufferBase(BufferTarget target, uint32_t binding, uint32_t buffer) {
+        glBindBufferBase(GetGLTarget(target), binding, buffer);
+    }
+
+    uint32_t GLRenderDevice::CreateVertexArray(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t stride,
+                                               const VertexAttribute* attributes, uint32_t attributeCount,
+                                               uint32_t instanceLocation) {
+        uint32_t vertexArray = 0;
+        glGenVertexArrays(1, &vertexArray);
+        glBindVertexArray(vertexArray);
+
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        if (indexBuffer) {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        }
+
+        for (uint32_t i = 0; i < attributeCount; i++) {
+            const VertexAttribute& attribute = attributes[i];
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribPointer(attribute.location, static_cast<GLint>(attribute.components), GL_FLOAT, GL_FALSE,
+                                  static_cast<GLsizei>(stride), reinterpret_cast<const void*>(static_cast<uintptr_t>(attribute.offset)));
+        }
+
+        // Instance matrix, one column per location, on a binding of its own. The regular
+        // attributes use bindings equal to their locations, so the instance location is free.
+        for (uint32_t column = 0; column < 4; column++) {
+            glVertexAttribFormat(instanceLocation + column, 4, GL_FLOAT, GL_FALSE, column * sizeof(glm::vec4));
+            glVertexAttribBinding(instanceLocation + column, instanceLocation);
+        }
+        glVertexBindingDivisor(instanceLocation, 1);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return vertexArray;
+    }
+
+    void GLRenderDevice::DeleteVertexArray(uint32_t vertexArray) {
+        glDeleteVertexArrays(1, &vertexArray);
+    }
+
+    uint32_t GLRenderDevice::CompileShader(uint32_t type, const std::string& source) {
+        uint32_t shader = glCreateShader(type);
+        const char* src = source.c_str();
+        glShaderSource(shader, 1, &src, nullptr);
+        glCompileShader(shader);
+
+        int success;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+            std::string shaderType = (type == GL_VERTEX_SHADER) ? "Vertex" : "Fragment";
+            XI_LOG_ERROR(shaderType + " shader compile error: " + std::string(infoLog));
+            glDeleteShader(shader);
+            return 0;
+        }
+
+        return shader;
+    }
+
+    uint32_t GLRenderDevice::CreateProgram(const std::string& vertexSource, const std::string& fragmentSource) {
+        uint32_t vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+        uint32_t fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+        if (!vertexShader || !fragmentShader) {
+            if (vertexShader) glDeleteShader(vertexShader);
+            if (fragmentShader) glDeleteShader(fragmentShader);
+            return 0;
+        }
+
+        uint32_t program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        glLinkProgram(program);
+
+        int success;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetProgramInfoLog(program, 512, nullptr, infoLog);
+            XI_LOG_ERROR("Shader link error: " + std::string(infoLog));
+            glDeleteProgram(program);
+            program = 0;
+        }
+
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        return program;
+    }
+
+    void GLRenderDevice::DeleteProgram(uint32_t program) {
+        glDeleteProgram(program);
+    }
+
+    int GLRenderDevice::GetUniformLocation(uint32_t program, const char* name) {
+        return glGetUniformLocation(program, name);
+    }
+
+    void GLRenderDevice::SetUniform(int location, int value) {
+        glUniform1i(location, value);
+    }
+
+    void GLRenderDevice::SetUniform(int location, float value) {
+        glUniform1f(location, value);
+    }
+
+    void GLRenderDevice::SetUniform(int location, const glm::vec2& value) {
+        glUniform2fv(location, 1, glm::value_ptr(value));
+    }
+
+    void GLRenderDevice::SetUniform(int location, const glm::vec3& value) {
+        glUniform3fv(location, 1, glm::value_ptr(value));
+    }
+
+    void GLRenderDevice::SetUniform(int location, const glm::vec4& value) {
+        glUniform4fv(location, 1, glm::value_ptr(value));
+    }
+
+    void GLRenderDevice::SetUniform(int location, const glm::mat3& value) {
+        glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value));
+    }
+
+    void GLRenderDevice::SetUniform(int location, const glm::mat4& value) {
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+    }
+
+    uint32_t GLRenderDevice::CreateTexture(const TextureDesc& desc, const void* data) {
+        GLenum internalFormat = GL_RGBA8;
+        GLenum dataFormat = GL_RGBA;
+        GLenum dataType = GL_UNSIGNED_BYTE;
+
+        switch (desc.format) {
+            case TextureFormat::R8:
+                internalFormat = GL_R8;
+                dataFormat = GL_RED;
+                break;
+            case TextureFormat::RGB8:
+                internalFormat = GL_RGB8;
+                dataFormat = GL_RGB;
+                break;
+            case TextureFormat::RGBA8:
+                break;
+            case TextureFormat::Depth24Stencil8:
+                internalFormat = GL_DEPTH24_STENCIL8;
+                dataFormat = GL_DEPTH_STENCIL;
+                dataType = GL_UNSIGNED_INT_24_8;
+                break;
+        }
+
+        uint32_t texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+
+        GLenum minFilter = GetGLFilter(desc.minFilter);
+        if (desc.generateMipmaps && desc.minFilter == TextureFilter::Linear) {
+            minFilter = GL_LINEAR_MIPMAP_LINEAR;
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GetGLFilter(desc.magFilter));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GetGLWrap(desc.wrapS));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GetGLWrap(desc.wrapT));
+
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, static_cast<GLsizei>(desc.width), static_cast<GLsizei>(desc.height),
+                     0, dataFormat, dataType, data);
+
+        if (desc.generateMipmaps) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        return texture;
+    }
+
+    void GLRenderDevice::DeleteTexture(uint32_t texture) {
+        glDeleteTextures(1, &texture);
+    }
+
+    uint32_t GLRenderDevice::CreateFramebuffer(uint32_t colorTexture, uint32_t depthStencilTexture) {
+        uint32_t framebuffer = 0;
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+        if (colorTexture) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        }
+        if (depthStencilTexture) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthStencilTexture, 0);
+        }
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            XI_LOG_ERROR("Framebuffer is not complete!");
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return framebuffer;
+    }
+
+    void GLRenderDevice::DeleteFramebuffer(uint32_t framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+
+    void GLRenderDevice::BindFramebuffer(uint32_t framebuffer, uint32_t width, uint32_t height) {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+    }
+
+    void GLRenderDevice::Clear(const glm::vec4& color) {
+        glClearColor(color.r, color.g, color.b, color.a);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    }
+
+    void GLRenderDevice::UseProgram(uint32_t program) {
+        glUseProgram(program);
+    }
+
+    void GLRenderDevice::BindVertexArray(uint32_t vertexArray) {
+        glBindVertexArray(vertexArray);
+    }
+
+    void GLRenderDevice::BindTexture(uint32_t unit, uint32_t texture) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+
+    void GLRenderDevice::SetDepthTest(bool enabled) {
+        if (enabled) glEnable(GL_DEPTH_TEST);
+        else glDisable(GL_DEPTH_TEST);
+    }
+
+    void GLRenderDevice::SetDepthWrite(bool enabled) {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    }
+
+    void GLRenderDevice::SetBlend(bool enabled) {
+        if (enabled) {
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        } else {
+            glDisable(GL_BLEND);
+        }
+    }
+
+    void GLRenderDevice::SetCullFace(bool enabled) {
+        // Back faces with counter-clockwise fronts, GL's defaults
+        if (enabled) glEnable(GL_CULL_FACE);
+        else glDisable(GL_CULL_FACE);
+    }
+
+    void GLRenderDevice::Draw(uint32_t count, bool indexed) {
+        if (indexed) {
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, 0);
+        } else {
+            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(count));
+        }
+    }
+
+    void GLRenderDevice::DrawInstanced(uint32_t count, bool indexed, uint32_t instanceCount,
+                                       uint32_t instanceBuffer, size_t offset, uint32_t instanceLocation) {
+        glBindVertexBuffer(instanceLocation, instanceBuffer, static_cast<GLintptr>(offset), sizeof(glm::mat4));
+        for (uint32_t column = 0; column < 4; column++) {
+            glEnableVertexAttribArray(instanceLocation + column);
+        }
+
+        if (indexed) {
+            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(count), GL_UNSIGNED_INT, 0,
+                                    static_cast<GLsizei>(instanceCount));
+        } else {
+            glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<GLsizei>(count), static_cast<GLsizei>(instanceCount));
+        }
+
+        // Plain draws of this vertex array have no buffer on the instance binding
+        for (uint32_t column = 0; column < 4; column++) {
+            glDisableVertexAttribArray(instanceLocation + column);
+        }
+    }
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "RenderDevice.h"
+
+namespace Xi {
+
+    // OpenGL 4.5. Needs a current context with GLEW initialized before the first call.
+    class GLRenderDevice : public RenderDevice {
+    public:
+        const char* GetName() const override { return "OpenGL"; }
+
+        uint32_t CreateBuffer(BufferTarget target, size_t size, const void* data, BufferUsage usage) override;
+        void DeleteBuffer(uint32_t buffer) override;
+        void ReallocateBuffer(BufferTarget target, uint32_t buffer, size_t size, BufferUsage usage) override;
+        void UpdateBuffer(BufferTarget target, uint32_t buffer, size_t offset, size_t size, const void* data) override;
+        void BindBufferBase(BufferTarget target, uint32_t binding, uint32_t buffer) override;
+
+        uint32_t CreateVertexArray(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t stride,
+                                   const VertexAttribute* attributes, uint32_t attributeCount,
+                                   uint32_t instanceLocation) override;
+        void DeleteVertexArray(uint32_t vertexArray) override;
+
+        uint32_t CreateProgram(const std::string& vertexSource, const std::string& fragmentSource) override;
+        void DeleteProgram(uint32_t program) override;
+        int GetUniformLocation(uint32_t program, const char* name) override;
+
+        void SetUniform(int location, int value) override;
+        void SetUniform(int location, float value) override;
+        void SetUniform(int location, const glm::vec2& value) override;
+        void SetUniform(int location, const glm::vec3& value) override;
+        void SetUniform(int location, const glm::vec4& value) override;
+        void SetUniform(int location, const glm::mat3& value) override;
+        void SetUniform(int location, const glm::mat4& value) override;
+
+        uint32_t CreateTexture(const TextureDesc& desc, const void* data) override;
+        void DeleteTexture(uint32_t texture) override;
+
+        uint32_t CreateFramebuffer(uint32_t colorTexture, uint32_t depthStencilTexture) override;
+        void DeleteFramebuffer(uint32_t framebuffer) override;
+        void BindFramebuffer(uint32_t framebuffer, uint32_t width, uint32_t height) override;
+        void Clear(const glm::vec4& color) override;
+
+        void UseProgram(uint32_t program) override;
+        void BindVertexArray(uint32_t vertexArray) override;
+        void BindTexture(uint32_t unit, uint32_t texture) override;
+        void SetDepthTest(bool enabled) override;
+        void SetDepthWrite(bool enabled) override;
+        void SetBlend(bool enabled) override;
+        void SetCullFace(bool enabled) override;
+
+        void Draw(uint32_t count, bool indexed) override;
+        void DrawInstanced(uint32_t count, bool indexed, uint32_t instanceCount,
+                           uint32_t instanceBuffer, size_t offset, uint32_t instanceLocation) override;
+
+    private:
+        uint32_t CompileShader(uint32_t type, const std::string& source);
+    };
+
+}
@@ -0,0 +1,307 @@
+#include "LightClusters.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Xi {
+
+    void LightClusters::SetProjection(const glm::mat4& projection, float nearClip, float farClip) {
+        if (!m_Bounds.empty() && projection == m_Projection && nearClip == m_NearClip && farClip == m_FarClip) return;
+
+        m_Projection = projection;
+        m_NearClip = glm::max(nearClip, 1e-4f);
+        m_FarClip = glm::max(farClip, m_NearClip * 1.001f);
+
+        float logDepthRange = std::log(m_FarClip / m_NearClip);
+        m_SliceScale = GRID_Z / logDepthRange;
+        m_SliceBias = GRID_Z * std::log(m_NearClip) / logDepthRange;
+
+        // The view-space line under each tile corner, from the near plane to the far. Points on
+        // it at a given depth bound the tiles around it, for perspective and orthographic alike.
+        glm::mat4 inverse = glm::inverse(projection);
+        auto unproject = [&inverse](float x, float y, float z) {
+            glm::vec4 point = inverse * glm::vec4(x, y, z, 1.0f);
+            return glm::vec3(point) / point.w;
+        };
+
+        std::vector<glm::vec3> nearCorners((GRID_X + 1) * (GRID_Y + 1));
+        std::vector<glm::vec3> farCorners(nearCorners.size());
+        for (uint32_t y = 0; y <= GRID_Y; y++) {
+            for (uint32_t x = 0; x <= GRID_X; x++) {
+                float ndcX = -1.0f + 2.0f * x / GRID_X;
+                float ndcY = -1.0f + 2.0f * y / GRID_Y;
+                nearCorners[x + y * (GRID_X + 1)] = unproject(ndcX, ndcY, -1.0f);
+                farCorners[x + y * (GRID_X + 1)] = unproject(ndcX, ndcY, 1.0f);
+            }
+        }
+
+        auto cornerAtDepth = [&](uint32_t corner, float depth) {
+            const glm::vec3& a = nearCorners[corner];
+            const glm::vec3& b = farCorners[corner];
+            float t = (-depth - a.z) / (b.z - a.z);
+            return a + (b - a) * t;
+        };
+
+        m_Bounds.resize(CLUSTER_COUNT);
+        for (uint32_t z = 0; z < GRID_Z; z++) {
+            float sliceNear = m_NearClip * std::pow(m_FarClip / m_NearClip, static_cast<float>(z) / GRID_Z);
+            float sliceFar = m_NearClip * std::pow(m_FarClip / m_NearClip, static_cast<float>(z + 1) / GRID_Z);
+
+            for (uint32_t y = 0; y < GRID_Y; y++) {
+                for (uint32_t x = 0; x < GRID_X; x++) {
+                    const uint32_t corners[4] = {
+                        x + y * (GRID_X + 1), x + 1 + y * (GRID_X + 1),
+                        x + (y + 1) * (GRID_X + 1), x + 1 + (y + 1) * (GRID_X + 1)
+                    };
+
+                    glm::vec3 min(std::numeric_limits<float>::max());
+                    glm::vec3 max(-std::numeric_limits<float>::max());
+                    for (uint32_t corner : corners) {
+                        for (float depth : { sliceNear, sliceFar }) {
+                            glm::vec3 point = cornerAtDepth(corner, depth);
+                            min = glm::min(min, point);
+                            max = glm::max(max, point);
+                        }
+                    }
+
+                    ClusterBounds& bounds = m_Bounds[x + y * GRID_X + z * SLICE_CLUSTERS];
+                    bounds.min = min;
+                    bounds.max = max;
+                    bounds.sphereCenter = (min + max) * 0.5f;
+                    bounds.sphereRadius = glm::length(max - min) * 0.5f;
+                }
+            }
+        }
+    }
+
+    uint32_t LightClusters::GetSlice(float viewDepth) const {
+        float slice = std::floor(std::log(glm::max(viewDepth, 1e-4f)) * m_SliceScale - m_SliceBias);
+        return static_cast<uint32_t>(glm::clamp(slice, 0.0f, static_cast<float>(GRID_Z - 1)));
+    }
+
+    void LightClusters::Build(const glm::mat4& view, const std::vector<LightData>& lights, JobSystem* jobs,
+                              std::vector<glm::uvec2>& clusters, std::vector<uint32_t>& lightIndices) {
+        clusters.assign(CLUSTER_COUNT, glm::uvec2(0));
+        lightIndices.clear();
+        m_ViewLights.clear();
+        if (m_Bounds.empty()) return;
+
+        glm::mat3 rotation(view);
+        for (uint32_t i = 0; i < lights.size(); i++) {
+            const LightData& light = lights[i];
+            if (light.type == LightData::Type::Directional || light.range <= 0.0f) continue;
+
+            ViewLight viewLight;
+            viewLight.position = glm::vec3(view * glm::vec4(light.position, 1.0f));
+            viewLight.range = light.range;
+
+            float depth = -viewLight.position.z;
+            if (depth + light.range < m_NearClip || depth - light.range > m_FarClip) continue;
+
+            // Cones of 90 degrees or more are tested as spheres; the cone test assumes a narrower one
+            float angle = glm::radians(light.spotAngle);
+            if (light.type == LightData::Type::Spot && angle < glm::radians(90.0f)) {
+                viewLight.axis = glm::normalize(rotation * light.direction);
+                viewLight.cosAngle = std::cos(angle);
+                viewLight.sinAngle = std::sin(angle);
+            } else {
+                viewLight.axis = glm::vec3(0.0f);
+                viewLight.cosAngle = -1.0f;
+                viewLight.sinAngle = 0.0f;
+            }
+
+            viewLight.index = i;
+            viewLight.firstSlice = GetSlice(depth - light.range);
+            viewLight.lastSlice = GetSlice(depth + light.range);
+            m_ViewLights.push_back(viewLight);
+        }
+        if (m_ViewLights.empty()) return;
+
+        m_Slices.resize(GRID_Z);
+        ParallelFor(jobs, GRID_Z, 1, [this](uint32_t begin, uint32_t end) {
+            for (uint32_t slice = begin; slice < end; slice++) {
+                BinSlice(slice);
+            }
+        });
+
+        // Slices are consecutive runs of clusters, so appending them in order keeps the layout
+        for (uint32_t slice = 0; slice < GRID_Z; slice++) {
+            const Slice& results = m_Slices[slice];
+            uint32_t offset = static_cast<uint32_t>(lightIndices.size());
+            for (uint32_t i = 0; i < SLICE_CLUSTERS; i++) {
+                clusters[slice * SLICE_CLUSTERS + i] = glm::uvec2(offset, results.counts[i]);
+                offset += results.counts[i];
+            }
+            lightIndices.insert(lightIndices.end(), results.lightIndices.begin(), results.lightIndices.end());
+        }
+    }
+
+    struct SliceLanes {
+        const float* x;
+        const float* y;
+        const float* z;
+        const float* range;
+        const float* rangeSq;
+        const float* axisX;
+        const float* axisY;
+        const float* axisZ;
+        const float* cosAngle;
+        const float* sinAngle;
+        const uint32_t* index;
+        uint32_t padded;
+    };
+
+    struct ClusterLanes {
+        float minX, minY, minZ;
+        float maxX, maxY, maxZ;
+        float centerX, centerY, centerZ;
+        float radius;
+    };
+
+    static void AppendLights(uint32_t first, uint32_t width, int mask, const uint32_t* index, std::vector<uint32_t>& out) {
+        for (uint32_t lane = 0; lane < width; lane++) {
+            if (mask & (1 << lane)) out.push_back(index[first + lane]);
+        }
+    }
+
+    // Baseline x64 path, four lights per iteration. A light reaches a cluster when its sphere
+    // touches the box and, for spots, its cone touches the box's bounding sphere.
+    static uint32_t BinClusterSSE(const ClusterLanes& cluster, const SliceLanes& lights, std::vector<uint32_t>& out) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 minX = _mm_set1_ps(cluster.minX), minY = _mm_set1_ps(cluster.minY), minZ = _mm_set1_ps(cluster.minZ);
+        const __m128 maxX = _mm_set1_ps(cluster.maxX), maxY = _mm_set1_ps(cluster.maxY), maxZ = _mm_set1_ps(cluster.maxZ);
+        const __m128 cx = _mm_set1_ps(cluster.centerX), cy = _mm_set1_ps(cluster.centerY), cz = _mm_set1_ps(cluster.centerZ);
+        const __m128 radius = _mm_set1_ps(cluster.radius);
+        const __m128 negRadius = _mm_set1_ps(-cluster.radius);
+
+        size_t before = out.size();
+        for (uint32_t i = 0; i < lights.padded; i += 4) {
+            __m128 lx = _mm_loadu_ps(lights.x + i);
+            __m128 ly = _mm_loadu_ps(lights.y + i);
+            __m128 lz = _mm_loadu_ps(lights.z + i);
+
+            // Squared distance from the light to the box
+            __m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minX, lx), zero), _mm_max_ps(_mm_sub_ps(lx, maxX), zero));
+            __m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minY, ly), zero), _mm_max_ps(_mm_sub_ps(ly, maxY), zero));
+            __m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minZ, lz), zero), _mm_max_ps(_mm_sub_ps(lz, maxZ), zero));
+            __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            __m128 hit = _mm_cmple_ps(distanceSq, _mm_loadu_ps(lights.rangeSq + i));
+
+            // Cone against the bounding sphere: outside the side, past the end or behind the apex
+            __m128 vx = _mm_sub_ps(cx, lx), vy = _mm_sub_ps(cy, ly), vz = _mm_sub_ps(cz, lz);
+            __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+            __m128 along = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_loadu_ps(lights.axisX + i)),
+                                                 _mm_mul_ps(vy, _mm_loadu_ps(lights.axisY + i))),
+                                      _mm_mul_ps(vz, _mm_loadu_ps(lights.axisZ + i)));
+            __m128 across = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(lengthSq, _mm_mul_ps(along, along)), zero));
+            __m128 sideDistance = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(lights.cosAngle + i), across),
+                                             _mm_mul_ps(along, _mm_loadu_ps(lights.sinAngle + i)));
+            __m128 outside = _mm_or_ps(_mm_cmpgt_ps(sideDistance, radius),
+                                       _mm_or_ps(_mm_cmpgt_ps(along, _mm_add_ps(radius, _mm_loadu_ps(lights.range + i))),
+                                                 _mm_cmplt_ps(along, negRadius)));
+            hit = _mm_andnot_ps(outside, hit);
+
+            AppendLights(i, 4, _mm_movemask_ps(hit), lights.index, out);
+        }
+        return static_cast<uint32_t>(out.size() - before);
+    }
+
+    XI_TARGET_AVX2
+    static uint32_t BinClusterAVX2(const ClusterLanes& cluster, const SliceLanes& lights, std::vector<uint32_t>& out) {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 minX = _mm256_set1_ps(cluster.minX), minY = _mm256_set1_ps(cluster.minY), minZ = _mm256_set1_ps(cluster.minZ);
+        const __m256 maxX = _mm256_set1_ps(cluster.maxX), maxY = _mm256_set1_ps(cluster.maxY), maxZ = _mm256_set1_ps(cluster.maxZ);
+        const __m256 cx = _mm256_set1_ps(cluster.centerX), cy = _mm256_set1_ps(cluster.centerY), cz = _mm256_set1_ps(cluster.centerZ);
+        const __m256 radius = _mm256_set1_ps(cluster.radius);
+        const __m256 negRadius = _mm256_set1_ps(-cluster.radius);
+
+        size_t before = out.size();
+        for (uint32_t i = 0; i < lights.padded; i += Simd::LANES) {
+            __m256 lx = _mm256_loadu_ps(lights.x + i);
+            __m256 ly = _mm256_loadu_ps(lights.y + i);
+            __m256 lz = _mm256_loadu_ps(lights.z + i);
+
+            __m256 dx = _mm256_add_ps(_mm256_max_ps(_mm256_sub_ps(minX, lx), zero), _mm256_max_ps(_mm256_sub_ps(lx, maxX), zero));
+            __m256 dy = _mm256_add_ps(_mm256_max_ps(_mm256_sub_ps(minY, ly), zero), _mm256_max_ps(_mm256_sub_ps(ly, maxY), zero));
+            __m256 dz = _mm256_add_ps(_mm256_max_ps(_mm256_sub_ps(minZ, lz), zero), _mm256_max_ps(_mm256_sub_ps(lz, maxZ), zero));
+            __m256 distanceSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+            __m256 hit = _mm256_cmp_ps(distanceSq, _mm256_loadu_ps(lights.rangeSq + i), _CMP_LE_OQ);
+
+            __m256 vx = _mm256_sub_ps(cx, lx), vy = _mm256_sub_ps(cy, ly), vz = _mm256_sub_ps(cz, lz);
+            __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+            __m256 along = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, _mm256_loadu_ps(lights.axisX + i)),
+                                                       _mm256_mul_ps(vy, _mm256_loadu_ps(lights.axisY + i))),
+                                         _mm256_mul_ps(vz, _mm256_loadu_ps(lights.axisZ + i)));
+            __m256 across = _mm256_sqrt_ps(_mm256_max_ps(_mm256_sub_ps(lengthSq, _mm256_mul_ps(along, along)), zero));
+            __m256 sideDistance = _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(lights.cosAngle + i), across),
+                                                _mm256_mul_ps(along, _mm256_loadu_ps(lights.sinAngle + i)));
+            __m256 outside = _mm256_or_ps(_mm256_cmp_ps(sideDistance, radius, _CMP_GT_OQ),
+                                          _mm256_or_ps(_mm256_cmp_ps(along, _mm256_add_ps(radius, _mm256_loadu_ps(lights.range + i)), _CMP_GT_OQ),
+                                                       _mm256_cmp_ps(along, negRadius, _CMP_LT_OQ)));
+            hit = _mm256_andnot_ps(outside, hit);
+
+            AppendLights(i, Simd::LANES, _mm256_movemask_ps(hit), lights.index, out);
+        }
+        return static_cast<uint32_t>(out.size() - before);
+    }
+
+    void LightClusters::BinSlice(uint32_t sliceIndex) {
+        Slice& slice = m_Slices[sliceIndex];
+        slice.lightIndices.clear();
+
+        // Gather the lights whose depth range overlaps the slice. Padding lanes have a negative
+        // squared range, which no distance passes.
+        slice.lightCount = 0;
+        for (const ViewLight& light : m_ViewLights) {
+            if (sliceIndex >= light.firstSlice && sliceIndex <= light.lastSlice) slice.lightCount++;
+        }
+        if (slice.lightCount == 0) {
+            std::fill(std::begin(slice.counts), std::end(slice.counts), 0u);
+            return;
+        }
+
+        uint32_t padded = Simd::PadToLanes(slice.lightCount);
+        for (auto* lanes : { &slice.x, &slice.y, &slice.z, &slice.range, &slice.axisX, &slice.axisY,
+                             &slice.axisZ, &slice.cosAngle, &slice.sinAngle }) {
+            lanes->assign(padded, 0.0f);
+        }
+        slice.rangeSq.assign(padded, -1.0f);
+        slice.index.assign(padded, 0u);
+
+        uint32_t lane = 0;
+        for (const ViewLight& light : m_ViewLights) {
+            if (sliceIndex < light.firstSlice || sliceIndex > light.lastSlice) continue;
+            slice.x[lane] = light.position.x;
+            slice.y[lane] = light.position.y;
+            slice.z[lane] = light.position.z;
+            slice.range[lane] = light.range;
+            slice.rangeSq[lane] = light.range * light.range;
+            slice.axisX[lane] = light.axis.x;
+            slice.axisY[lane] = light.axis.y;
+            slice.axisZ[lane] = light.axis.z;
+            slice.cosAngle[lane] = light.cosAngle;
+            slice.sinAngle[lane] = light.sinAngle;
+            slice.index[lane] = light.index;
+            lane++;
+        }
+
+        SliceLanes lanes = { slice.x.data(), slice.y.data(), slice.z.data(), slice.range.data(), slice.rangeSq.data(),
+                             slice.axisX.data(), slice.axisY.data(), slice.axisZ.data(),
+                             slice.cosAngle.data(), slice.sinAngle.data(), slice.index.data(), padded };
+
+        bool avx2 = Simd::HasAVX2();
+        for (uint32_t i = 0; i < SLICE_CLUSTERS; i++) {
+            const ClusterBounds& bounds = m_Bounds[sliceIndex * SLICE_CLUSTERS + i];
+            ClusterLanes cluster = { bounds.min.x, bounds.min.y, bounds.min.z,
+                                     bounds.max.x, bounds.max.y, bounds.max.z,
+                                     bounds.sphereCenter.x, bounds.sphereCenter.y, bounds.sphereCenter.z,
+                                     bounds.sphereRadius };
+
+            slice.counts[i] = avx2 ? BinClusterAVX2(cluster, lanes, slice.lightIndices)
+                                   : BinClusterSSE(cluster, lanes, slice.lightIndices);
+        }
+    }
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "FramePacket.h"
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Xi {
+
+    class JobSystem;
+
+    // Froxel grid for clustered forward lighting: the view frustum cut into screen tiles and
+    // exponentially spaced depth slices. Build bins each point and spot light into the
+    // clusters it reaches, testing eight lights at a time against a cluster's bounds, so the
+    // fragment shader only evaluates the lights of its own cluster. Directional lights reach
+    // every cluster and are left out.
+    class LightClusters {
+    public:
+        static constexpr uint32_t GRID_X = 16;
+        static constexpr uint32_t GRID_Y = 9;
+        static constexpr uint32_t GRID_Z = 24;
+        static constexpr uint32_t SLICE_CLUSTERS = GRID_X * GRID_Y;
+        static constexpr uint32_t CLUSTER_COUNT = SLICE_CLUSTERS * GRID_Z;
+
+        // Cluster bounds are in view space, so they only change with the projection
+        void SetProjection(const glm::mat4& projection, float nearClip, float farClip);
+
+        // One job per depth slice. Cluster x + y * GRID_X + slice * SLICE_CLUSTERS, tiles
+        // counted from the bottom left, gets an offset and count into lightIndices, which
+        // index lights. Each cluster's lights keep their order in lights.
+        void Build(const glm::mat4& view, const std::vector<LightData>& lights, JobSystem* jobs,
+                   std::vector<glm::uvec2>& clusters, std::vector<uint32_t>& lightIndices);
+
+        // The shader finds a fragment's slice as floor(log(viewDepth) * scale - bias)
+        float GetSliceScale() const { return m_SliceScale; }
+        float GetSliceBias() const { return m_SliceBias; }
+        uint32_t GetSlice(float viewDepth) const;
+
+        // Point and spot lights inside the view at the last Build
+        uint32_t GetBinnedLightCount() const { return static_cast<uint32_t>(m_ViewLights.size()); }
+
+    private:
+        struct ClusterBounds {
+            glm::vec3 min;
+            glm::vec3 max;
+            glm::vec3 sphereCenter;  // Around the box, for the cone test
+            float sphereRadius;
+        };
+
+        // A light in view space. Point lights have a zero axis, cosine -1 and sine 0, which
+        // no cone test rejects.
+        struct ViewLight {
+            glm::vec3 position;
+            float range;
+            glm::vec3 axis;
+            float cosAngle;
+            float sinAngle;
+            uint32_t index;  // Into Build's lights
+            uint32_t firstSlice;
+            uint32_t lastSlice;
+        };
+
+        // Lights overlapping one slice, in SIMD lanes, and the slice's results
+        struct Slice {
+            std::vector<float> x, y, z, range, rangeSq;
+            std::vector<float> axisX, axisY, axisZ, cosAngle, sinAngle;
+            std::vector<uint32_t> index;
+            uint32_t lightCount = 0;
+
+            std::vector<uint32_t> lightIndices;
+            uint32_t counts[SLICE_CLUSTERS] = {};
+        };
+
+        void BinSlice(uint32_t slice);
+
+        std::vector<ClusterBounds> m_Bounds;
+        std::vector<ViewLight> m_ViewLights;
+        std::vector<Slice> m_Slices;
+
+        glm::mat4 m_Projection = glm::mat4(0.0f);
+        float m_NearClip = 0.0f;
+        float m_FarClip = 0.0f;
+        float m_SliceScale = 0.0f;
+        float m_SliceBias = 0.0f;
+    };
+
+}
@@ -1,12 +1,13 @@
 #include "Material.h"
 #include "Shader.h"
 #include "Texture.h"
-
-#include <GL/glew.h>
+#include "RenderQueue.h"
+#include "RenderStateCache.h"
+#include "RenderDevice.h"
 
 namespace Xi {
 
-    Material::Material() = default;
+    Material::Material() : m_SortID(NextRenderSortID()) {}
     Material::~Material() = default;
 
     void Material::SetShader(std::shared_ptr<Shader> shader) {
@@ -15,52 +16,77 @@ namespace Xi {
 
     void Material::Bind() const {
         if (m_Shader) {
-            m_Shader->Bind();
-
-            m_Shader->SetVec4("u_AlbedoColor", albedoColor);
-            m_Shader->SetFloat("u_Metallic", metallic);
-            m_Shader->SetFloat("u_Roughness", roughness);
-            m_Shader->SetFloat("u_AO", ao);
-            m_Shader->SetVec3("u_Emissive", emissive);
-
-            int textureSlot = 0;
-
-            if (m_AlbedoTexture) {
-                m_AlbedoTexture->Bind(textureSlot);
-                m_Shader->SetInt("u_AlbedoMap", textureSlot);
-                m_Shader->SetInt("u_HasAlbedoMap", 1);
-                textureSlot++;
-            } else {
-                m_Shader->SetInt("u_HasAlbedoMap", 0);
-            }
-
-            if (m_NormalTexture) {
-                m_NormalTexture->Bind(textureSlot);
-                m_Shader->SetInt("u_NormalMap", textureSlot);
-                m_Shader->SetInt("u_HasNormalMap", 1);
-                textureSlot++;
-            } else {
-                m_Shader->SetInt("u_HasNormalMap", 0);
-            }
+            Bind(*m_Shader);
+        } else {
+            ApplyRenderState();
+        }
+    }
+
+    void Material::Bind(Shader& shader) const {
+        shader.Bind();
+        SetUniforms(shader);
+
+        // Same slots as SetUniforms assigns
+        uint32_t textureSlot = 0;
+        if (m_AlbedoTexture) m_AlbedoTexture->Bind(textureSlot++);
+        if (m_NormalTexture) m_NormalTexture->Bind(textureSlot++);
+
+        ApplyRenderState();
+    }
+
+    void Material::Bind(Shader& shader, RenderStateCache& state) const {
+        state.UseProgram(shader.GetProgram());
+        SetUniforms(shader);
+
+        uint32_t textureSlot = 0;
+        if (m_AlbedoTexture) state.BindTexture(textureSlot++, m_AlbedoTexture->GetID());
+        if (m_NormalTexture) state.BindTexture(textureSlot++, m_NormalTexture->GetID());
+
+        state.SetCullFace(!doubleSided);
+        state.SetBlend(transparent);
+    }
+
+    void Material::SetUniforms(Shader& shader) const {
+        shader.SetVec4(ShaderUniform::AlbedoColor, albedoColor);
+        shader.SetFloat(ShaderUniform::Metallic, metallic);
+        shader.SetFloat(ShaderUniform::Roughness, roughness);
+        shader.SetFloat(ShaderUniform::AO, ao);
+        shader.SetVec3(ShaderUniform::Emissive, emissive);
+
+        int textureSlot = 0;
+
+        if (m_AlbedoTexture) {
+            shader.SetInt(ShaderUniform::AlbedoMap, textureSlot);
+            shader.SetInt(ShaderUniform::HasAlbedoMap, 1);
+            textureSlot++;
+        } else {
+            shader.SetInt(ShaderUniform::HasAlbedoMap, 0);
         }
 
-        if (doubleSided) {
-            glDisable(GL_CULL_FACE);
+        if (m_NormalTexture) {
+            shader.SetInt(ShaderUniform::NormalMap, textureSlot);
+            shader.SetInt(ShaderUniform::HasNormalMap, 1);
+            textureSlot++;
         } else {
-            glEnable(GL_CULL_FACE);
+            shader.SetInt(ShaderUniform::HasNormalMap, 0);
         }
+    }
+
+    void Material::ApplyRenderState() const {
+        RenderDevice& device = RenderDevice::Get();
+        device.SetCullFace(!doubleSided);
 
         if (transparent) {
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            device.SetBlend(true);
         }
     }
 
     void Material::Unbind() const {
+        RenderDevice& device = RenderDevice::Get();
         if (transparent) {
-            glDisable(GL_BLEND);
+            device.SetBlend(false);
         }
-        glEnable(GL_CULL_FACE);
+        device.SetCullFace(true);
 
         if (m_Shader) {
             m_Shader->Unbind();
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <memory>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace Xi {
 
     class Shader;
     class Texture;
+    class RenderStateCache;
 
     class Material {
     public:
@@ -14,7 +16,7 @@ namespace Xi {
         ~Material();
 
         void SetShader(std::shared_ptr<Shader> shader);
-        std::shared_ptr<Shader> GetShader() const { return m_Shader; }
+        const std::shared_ptr<Shader>& GetShader() const { return m_Shader; }
 
         void SetAlbedoTexture(std::shared_ptr<Texture> texture) { m_AlbedoTexture = texture; }
         void SetNormalTexture(std::shared_ptr<Texture> texture) { m_NormalTexture = texture; }
@@ -36,10 +38,22 @@ namespace Xi {
         void Bind() const;
         void Unbind() const;
 
+        // Binds another shader, such as a default or an instanced variant, with this material's values
+        void Bind(Shader& shader) const;
+
+        // Same, through the renderer's state cache. Needs no Unbind; the next material sets what it needs.
+        void Bind(Shader& shader, RenderStateCache& state) const;
+
+        uint32_t GetSortID() const { return m_SortID; }
+
     private:
+        void SetUniforms(Shader& shader) const;
+        void ApplyRenderState() const;
+
         std::shared_ptr<Shader> m_Shader;
         std::shared_ptr<Texture> m_AlbedoTexture;
         std::shared_ptr<Texture> m_NormalTexture;
+        uint32_t m_SortID = 0;
     };
 
 }
@@ -1,14 +1,16 @@
 #include "Mesh.h"
-#include <GL/glew.h>
+#include "RenderQueue.h"
+#include "RenderStateCache.h"
+#include "RenderDevice.h"
+#include <cstddef>
+#include <cmath>
 
 namespace Xi {
 
-    Mesh::Mesh() = default;
+    Mesh::Mesh() : m_SortID(NextRenderSortID()) {}
 
     Mesh::~Mesh() {
-        if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
-        if (m_VBO) glDeleteBuffers(1, &m_VBO);
-        if (m_EBO) glDeleteBuffers(1, &m_EBO);
+        Release();
     }
 
     void Mesh::SetVertices(const std::vector<Vertex>& vertices) {
@@ -23,61 +25,66 @@ namespace Xi {
         if (m_Vertices.empty()) return;
 
         CalculateTangents();
+        CalculateBounds();
 
         // Clean up existing buffers
-        if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
-        if (m_VBO) glDeleteBuffers(1, &m_VBO);
-        if (m_EBO) glDeleteBuffers(1, &m_EBO);
-
-        glGenVertexArrays(1, &m_VAO);
-        glGenBuffers(1, &m_VBO);
-
-        glBindVertexArray(m_VAO);
-
-        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-        glBufferData(GL_ARRAY_BUFFER, m_Vertices.size() * sizeof(Vertex), m_Vertices.data(), GL_STATIC_DRAW);
+        Release();
 
+        RenderDevice& device = RenderDevice::Get();
+        m_VBO = device.CreateBuffer(BufferTarget::Vertex, m_Vertices.size() * sizeof(Vertex), m_Vertices.data(), BufferUsage::Static);
         if (!m_Indices.empty()) {
-            glGenBuffers(1, &m_EBO);
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size() * sizeof(uint32_t), m_Indices.data(), GL_STATIC_DRAW);
+            m_EBO = device.CreateBuffer(BufferTarget::Index, m_Indices.size() * sizeof(uint32_t), m_Indices.data(), BufferUsage::Static);
         }
 
-        // Position attribute
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-
-        // Normal attribute
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-
-        // TexCoord attribute
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
-
-        // Tangent attribute
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
+        // Position, normal, texture coordinate, tangent
+        const VertexAttribute attributes[] = {
+            { 0, 3, static_cast<uint32_t>(offsetof(Vertex, position)) },
+            { 1, 3, static_cast<uint32_t>(offsetof(Vertex, normal)) },
+            { 2, 2, static_cast<uint32_t>(offsetof(Vertex, texCoord)) },
+            { 3, 3, static_cast<uint32_t>(offsetof(Vertex, tangent)) },
+        };
+        m_VAO = device.CreateVertexArray(m_VBO, m_EBO, sizeof(Vertex), attributes, 4, INSTANCE_LOCATION);
+    }
 
-        glBindVertexArray(0);
+    void Mesh::Release() {
+        RenderDevice& device = RenderDevice::Get();
+        if (m_VAO) device.DeleteVertexArray(m_VAO);
+        if (m_VBO) device.DeleteBuffer(m_VBO);
+        if (m_EBO) device.DeleteBuffer(m_EBO);
+        m_VAO = m_VBO = m_EBO = 0;
     }
 
     void Mesh::Bind() const {
-        glBindVertexArray(m_VAO);
+        RenderDevice::Get().BindVertexArray(m_VAO);
     }
 
     void Mesh::Unbind() const {
-        glBindVertexArray(0);
+        RenderDevice::Get().BindVertexArray(0);
     }
 
     void Mesh::Draw() const {
-        glBindVertexArray(m_VAO);
-        if (!m_Indices.empty()) {
-            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_Indices.size()), GL_UNSIGNED_INT, 0);
-        } else {
-            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_Vertices.size()));
-        }
-        glBindVertexArray(0);
+        RenderDevice& device = RenderDevice::Get();
+        device.BindVertexArray(m_VAO);
+        device.Draw(GetElementCount(), !m_Indices.empty());
+        device.BindVertexArray(0);
+    }
+
+    void Mesh::Draw(RenderStateCache& state) const {
+        GetDrawInfo().Draw(state);
+    }
+
+    void Mesh::DrawInstanced(RenderStateCache& state, uint32_t instanceBuffer, size_t offset, uint32_t instanceCount) const {
+        GetDrawInfo().DrawInstanced(state, instanceBuffer, offset, instanceCount);
+    }
+
+    void MeshDrawInfo::Draw(RenderStateCache& state) const {
+        state.BindVertexArray(vertexArray);
+        RenderDevice::Get().Draw(elementCount, indexed);
+    }
+
+    void MeshDrawInfo::DrawInstanced(RenderStateCache& state, uint32_t instanceBuffer, size_t offset, uint32_t instanceCount) const {
+        state.BindVertexArray(vertexArray);
+        RenderDevice::Get().DrawInstanced(elementCount, indexed, instanceCount, instanceBuffer, offset, Mesh::INSTANCE_LOCATION);
     }
 
     void Mesh::CalculateTangents() {
@@ -125,4 +132,23 @@ namespace Xi {
         }
     }
 
+    void Mesh::CalculateBounds() {
+        m_Bounds = MeshBounds();
+        if (m_Vertices.empty()) return;
+
+        m_Bounds.min = m_Bounds.max = m_Vertices[0].position;
+        for (const auto& v : m_Vertices) {
+            m_Bounds.min = glm::min(m_Bounds.min, v.position);
+            m_Bounds.max = glm::max(m_Bounds.max, v.position);
+        }
+
+        m_Bounds.sphereCenter = m_Bounds.GetCenter();
+        float radiusSquared = 0.0f;
+        for (const auto& v : m_Vertices) {
+            glm::vec3 offset = v.position - m_Bounds.sphereCenter;
+            radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+        }
+        m_Bounds.sphereRadius = std::sqrt(radiusSquared);
+    }
+
 }
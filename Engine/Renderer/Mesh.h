@@ -1,11 +1,14 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <glm/glm.hpp>
 
 namespace Xi {
 
+    class RenderStateCache;
+
     struct Vertex {
         glm::vec3 position;
         glm::vec3 normal;
@@ -18,6 +21,29 @@ namespace Xi {
             : position(pos), normal(norm), texCoord(uv), tangent(1.0f, 0.0f, 0.0f) {}
     };
 
+    // Local-space bounds of a mesh's vertices
+    struct MeshBounds {
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+
+        // Centered on the box; the radius reaches the farthest vertex
+        glm::vec3 sphereCenter = glm::vec3(0.0f);
+        float sphereRadius = 0.0f;
+
+        glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+        glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+    };
+
+    // What drawing a built mesh takes, copied out so a frame packet can draw it without the Mesh
+    struct MeshDrawInfo {
+        uint32_t vertexArray = 0;
+        uint32_t elementCount = 0;  // Indices if indexed, otherwise vertices
+        bool indexed = false;
+
+        void Draw(RenderStateCache& state) const;
+        void DrawInstanced(RenderStateCache& state, uint32_t instanceBuffer, size_t offset, uint32_t instanceCount) const;
+    };
+
     class Mesh {
     public:
         Mesh();
@@ -31,22 +57,44 @@ namespace Xi {
         void Unbind() const;
         void Draw() const;
 
+        // Renderer paths: bind the vertex array through the state cache and leave it bound
+        void Draw(RenderStateCache& state) const;
+
+        // Draws instanceCount copies, reading one model matrix per instance from instanceBuffer
+        // starting at offset bytes
+        void DrawInstanced(RenderStateCache& state, uint32_t instanceBuffer, size_t offset, uint32_t instanceCount) const;
+
+        // Per-instance model matrix columns occupy locations 4-7
+        static constexpr uint32_t INSTANCE_LOCATION = 4;
+
         uint32_t GetVertexCount() const { return static_cast<uint32_t>(m_Vertices.size()); }
         uint32_t GetIndexCount() const { return static_cast<uint32_t>(m_Indices.size()); }
         bool IsValid() const { return m_VAO != 0; }
+        MeshDrawInfo GetDrawInfo() const { return { m_VAO, GetElementCount(), !m_Indices.empty() }; }
 
         const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
         const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
 
+        // Computed by Build
+        const MeshBounds& GetBounds() const { return m_Bounds; }
+
+        uint32_t GetSortID() const { return m_SortID; }
+
     private:
+        // Indices if there are any, otherwise vertices
+        uint32_t GetElementCount() const { return m_Indices.empty() ? GetVertexCount() : GetIndexCount(); }
+        void Release();
         void CalculateTangents();
+        void CalculateBounds();
 
         std::vector<Vertex> m_Vertices;
         std::vector<uint32_t> m_Indices;
+        MeshBounds m_Bounds;
 
         uint32_t m_VAO = 0;
         uint32_t m_VBO = 0;
         uint32_t m_EBO = 0;
+        uint32_t m_SortID = 0;
     };
 
 }
@@ -0,0 +1,233 @@
+#include "NullRenderDevice.h"
+#include "../Core/Log.h"
+
+namespace Xi {
+
+    const char* GetDeviceCallName(DeviceCall call) {
+        static const char* const s_Names[] = {
+            "CreateBuffer",
+            "DeleteBuffer",
+            "ReallocateBuffer",
+            "UpdateBuffer",
+            "BindBufferBase",
+            "CreateVertexArray",
+            "DeleteVertexArray",
+            "CreateProgram",
+            "DeleteProgram",
+            "GetUniformLocation",
+            "SetUniform",
+            "CreateTexture",
+            "DeleteTexture",
+            "CreateFramebuffer",
+            "DeleteFramebuffer",
+            "BindFramebuffer",
+            "Clear",
+            "UseProgram",
+            "BindVertexArray",
+            "BindTexture",
+            "SetDepthTest",
+            "SetDepthWrite",
+            "SetBlend",
+            "SetCullFace",
+            "Draw",
+            "DrawInstanced",
+        };
+        static_assert(sizeof(s_Names) / sizeof(s_Names[0]) == static_cast<size_t>(DeviceCall::Count),
+                      "Every DeviceCall needs a name");
+        return s_Names[static_cast<size_t>(call)];
+    }
+
+    uint64_t NullRenderDevice::Counters::GetTotal() const {
+        uint64_t total = 0;
+        for (uint64_t count : calls) total += count;
+        return total;
+    }
+
+    void NullRenderDevice::Record(DeviceCall call, uint64_t first, uint64_t second) {
+        m_Counters.calls[static_cast<size_t>(call)]++;
+        if (m_Logging) {
+            XI_LOG_TRACE(std::string(GetDeviceCallName(call)) + " " + std::to_string(first) + " " + std::to_string(second));
+        }
+    }
+
+    uint32_t NullRenderDevice::CreateBuffer(BufferTarget target, size_t size, const void* data, BufferUsage usage) {
+        (void)target;
+        (void)usage;
+        uint32_t buffer = NextHandle();
+        Record(DeviceCall::CreateBuffer, buffer, size);
+        if (data) m_Counters.bytesUploaded += size;
+        return buffer;
+    }
+
+    void NullRenderDevice::DeleteBuffer(uint32_t buffer) {
+        Record(DeviceCall::DeleteBuffer, buffer);
+    }
+
+    void NullRenderDevice::ReallocateBuffer(BufferTarget target, uint32_t buffer, size_t size, BufferUsage usage) {
+        (void)target;
+        (void)usage;
+        Record(DeviceCall::ReallocateBuffer, buffer, size);
+    }
+
+    void NullRenderDevice::UpdateBuffer(BufferTarget target, uint32_t buffer, size_t offset, size_t size, const void* data) {
+        (void)target;
+        (void)offset;
+        (void)data;
+        Record(DeviceCall::UpdateBuffer, buffer, size);
+        m_Counters.bytesUploaded += size;
+    }
+
+    void NullRenderDevice::BindBufferBase(BufferTarget target, uint32_t binding, uint32_t buffer) {
+        (void)target;
+        Record(DeviceCall::BindBufferBase, binding, buffer);
+    }
+
+    uint32_t NullRenderDevice::CreateVertexArray(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t stride,
+                                                 const VertexAttribute* attributes, uint32_t attributeCount,
+                                                 uint32_t instanceLocation) {
+        (void)indexBuffer;
+        (void)stride;
+        (void)attributes;
+        (void)attributeCount;
+        (void)instanceLocation;
+        uint32_t vertexArray = NextHandle();
+        Record(DeviceCall::CreateVertexArray, vertexArray, vertexBuffer);
+        return vertexArray;
+    }
+
+    void NullRenderDevice::DeleteVertexArray(uint32_t vertexArray) {
+        Record(DeviceCall::DeleteVertexArray, vertexArray);
+    }
+
+    uint32_t NullRenderDevice::CreateProgram(const std::string& vertexSource, const std::string& fragmentSource) {
+        uint32_t program = NextHandle();
+        Record(DeviceCall::CreateProgram, program, vertexSource.size() + fragmentSource.size());
+        return program;
+    }
+
+    void NullRenderDevice::DeleteProgram(uint32_t program) {
+        Record(DeviceCall::DeleteProgram, program);
+    }
+
+    int NullRenderDevice::GetUniformLocation(uint32_t program, const char* name) {
+        (void)name;
+        Record(DeviceCall::GetUniformLocation, program);
+        return 0;
+    }
+
+    void NullRenderDevice::SetUniform(int location, int value) {
+        (void)value;
+        Record(DeviceCall::SetUniform, static_cast<uint64_t>(location));
+    }
+
+    void NullRenderDevice::SetUniform(int location, float value) {
+        (void)value;
+        Record(DeviceCall::SetUniform, static_cast<uint64_t>(location));
+    }
+
+    void NullRenderDevice::SetUniform(int location, const glm::vec2& value) {
+        (void)value;
+        Record(DeviceCall::SetUniform, static_cast<uint64_t>(location));
+    }
+
+    void NullRenderDevice::SetUniform(int location, const glm::vec3& value) {
+        (void)value;
+        Record(DeviceCall::SetUniform, static_cast<uint64_t>(location));
+    }
+
+    void NullRenderDevice::SetUniform(int location, const glm::vec4& value) {
+        (void)value;
+        Record(DeviceCall::SetUniform, static_cast<uint64_t>(location));
+    }
+
+    void NullRenderDevice::SetUniform(int location, const glm::mat3& value) {
+        (void)value;
+        Record(DeviceCall::SetUniform, static_cast<uint64_t>(location));
+    }
+
+    void NullRenderDevice::SetUniform(int location, const glm::mat4& value) {
+        (void)value;
+        Record(DeviceCall::SetUniform, static_cast<uint64_t>(location));
+    }
+
+    uint32_t NullRenderDevice::CreateTexture(const TextureDesc& desc, const void* data) {
+        uint32_t texture = NextHandle();
+        Record(DeviceCall::CreateTexture, desc.width, desc.height);
+        if (data) {
+            uint64_t bytesPerPixel = desc.format == TextureFormat::R8 ? 1 : desc.format == TextureFormat::RGB8 ? 3 : 4;
+            m_Counters.bytesUploaded += static_cast<uint64_t>(desc.width) * desc.height * bytesPerPixel;
+        }
+        return texture;
+    }
+
+    void NullRenderDevice::DeleteTexture(uint32_t texture) {
+        Record(DeviceCall::DeleteTexture, texture);
+    }
+
+    uint32_t NullRenderDevice::CreateFramebuffer(uint32_t colorTexture, uint32_t depthStencilTexture) {
+        uint32_t framebuffer = NextHandle();
+        Record(DeviceCall::CreateFramebuffer, colorTexture, depthStencilTexture);
+        return framebuffer;
+    }
+
+    void NullRenderDevice::DeleteFramebuffer(uint32_t framebuffer) {
+        Record(DeviceCall::DeleteFramebuffer, framebuffer);
+    }
+
+    void NullRenderDevice::BindFramebuffer(uint32_t framebuffer, uint32_t width, uint32_t height) {
+        (void)height;
+        Record(DeviceCall::BindFramebuffer, framebuffer, width);
+    }
+
+    void NullRenderDevice::Clear(const glm::vec4& color) {
+        (void)color;
+        Record(DeviceCall::Clear);
+    }
+
+    void NullRenderDevice::UseProgram(uint32_t program) {
+        Record(DeviceCall::UseProgram, program);
+    }
+
+    void NullRenderDevice::BindVertexArray(uint32_t vertexArray) {
+        Record(DeviceCall::BindVertexArray, vertexArray);
+    }
+
+    void NullRenderDevice::BindTexture(uint32_t unit, uint32_t texture) {
+        Record(DeviceCall::BindTexture, unit, texture);
+    }
+
+    void NullRenderDevice::SetDepthTest(bool enabled) {
+        Record(DeviceCall::SetDepthTest, enabled);
+    }
+
+    void NullRenderDevice::SetDepthWrite(bool enabled) {
+        Record(DeviceCall::SetDepthWrite, enabled);
+    }
+
+    void NullRenderDevice::SetBlend(bool enabled) {
+        Record(DeviceCall::SetBlend, enabled);
+    }
+
+    void NullRenderDevice::SetCullFace(bool enabled) {
+        Record(DeviceCall::SetCullFace, enabled);
+    }
+
+    void NullRenderDevice::Draw(uint32_t count, bool indexed) {
+        (void)indexed;
+        Record(DeviceCall::Draw, count);
+        m_Counters.instancesDrawn++;
+        m_Counters.elementsDrawn += count;
+    }
+
+    void NullRenderDevice::DrawInstanced(uint32_t count, bool indexed, uint32_t instanceCount,
+                                         uint32_t instanceBuffer, size_t offset, uint32_t instanceLocation) {
+        (void)indexed;
+        (void)instanceBuffer;
+        (void)offset;
+        (void)instanceLocation;
+        Record(DeviceCall::DrawInstanced, count, instanceCount);
+        m_Counters.instancesDrawn += instanceCount;
+        m_Counters.elementsDrawn += static_cast<uint64_t>(count) * instanceCount;
+    }
+
+}
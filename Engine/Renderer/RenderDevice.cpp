@@ -0,0 +1,20 @@
+#include "RenderDevice.h"
+#include "GLRenderDevice.h"
+
+namespace Xi {
+
+    static std::unique_ptr<RenderDevice> s_Device;
+
+    RenderDevice& RenderDevice::Get() {
+        if (!s_Device) {
+            s_Device = std::make_unique<GLRenderDevice>();
+        }
+        return *s_Device;
+    }
+
+    std::unique_ptr<RenderDevice> RenderDevice::SetCurrent(std::unique_ptr<RenderDevice> device) {
+        std::swap(s_Device, device);
+        return device;
+    }
+
+}
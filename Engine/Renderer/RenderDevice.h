@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Texture.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <glm/glm.hpp>
+
+namespace Xi {
+
+    enum class BufferTarget {
+        Vertex,
+        Index,
+        Uniform,
+        Storage   // Shader storage, read by shaders as std430 arrays
+    };
+
+    enum class BufferUsage {
+        Static,   // Written once
+        Dynamic,  // Rewritten now and then
+        Stream    // Rewritten every frame
+    };
+
+    enum class TextureFormat {
+        R8,
+        RGB8,
+        RGBA8,
+        Depth24Stencil8
+    };
+
+    struct TextureDesc {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        TextureFormat format = TextureFormat::RGBA8;
+        TextureFilter minFilter = TextureFilter::Linear;
+        TextureFilter magFilter = TextureFilter::Linear;
+        TextureWrap wrapS = TextureWrap::Repeat;
+        TextureWrap wrapT = TextureWrap::Repeat;
+        bool generateMipmaps = false;  // Linear min filtering then blends between levels
+    };
+
+    // One float vector attribute read from the vertex buffer
+    struct VertexAttribute {
+        uint32_t location;
+        uint32_t components;
+        uint32_t offset;
+    };
+
+    // The graphics calls the renderer and its resources make. Handles are plain IDs with 0
+    // meaning none, as in GL, so classes that held GL names keep holding the same integers.
+    // The GL device is the default; the null device records calls instead of making them, so
+    // the CPU side of rendering runs without a GPU or a context.
+    class RenderDevice {
+    public:
+        virtual ~RenderDevice() = default;
+
+        // The device every renderer class uses. Created as the GL device on first use unless
+        // another was set.
+        static RenderDevice& Get();
+
+        // Set before creating any render resources; ones made on the previous device would be
+        // released on this one. A device wrapping the previous one, as the render thread's
+        // does, can take over at any time. Returns the previous device.
+        static std::unique_ptr<RenderDevice> SetCurrent(std::unique_ptr<RenderDevice> device);
+
+        virtual const char* GetName() const = 0;
+
+        // Buffers
+        virtual uint32_t CreateBuffer(BufferTarget target, size_t size, const void* data, BufferUsage usage) = 0;
+        virtual void DeleteBuffer(uint32_t buffer) = 0;
+        // Replaces the storage, discarding the contents. Lets the driver hand out fresh memory
+        // instead of waiting for draws that still read the old.
+        virtual void ReallocateBuffer(BufferTarget target, uint32_t buffer, size_t size, BufferUsage usage) = 0;
+        virtual void UpdateBuffer(BufferTarget target, uint32_t buffer, size_t offset, size_t size, const void* data) = 0;
+        virtual void BindBufferBase(BufferTarget target, uint32_t binding, uint32_t buffer) = 0;
+
+        // Vertex arrays. instanceLocation and the three after it take a per-instance mat4,
+        // disabled except during DrawInstanced.
+        virtual uint32_t CreateVertexArray(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t stride,
+                                           const VertexAttribute* attributes, uint32_t attributeCount,
+                                           uint32_t instanceLocation) = 0;
+        virtual void DeleteVertexArray(uint32_t vertexArray) = 0;
+
+        // Programs. Logs compile and link errors and returns 0 on failure.
+        virtual uint32_t CreateProgram(const std::string& vertexSource, const std::string& fragmentSource) = 0;
+        virtual void DeleteProgram(uint32_t program) = 0;
+        virtual int GetUniformLocation(uint32_t program, const char* name) = 0;
+
+        // Uniforms of the program in use; location -1 is ignored
+        virtual void SetUniform(int location, int value) = 0;
+        virtual void SetUniform(int location, float value) = 0;
+        virtual void SetUniform(int location, const glm::vec2& value) = 0;
+        virtual void SetUniform(int location, const glm::vec3& value) = 0;
+        virtual void SetUniform(int location, const glm::vec4& value) = 0;
+        virtual void SetUniform(int location, const glm::mat3& value) = 0;
+        virtual void SetUniform(int location, const glm::mat4& value) = 0;
+
+        // Textures. data is tightly packed rows, bottom row first, or null to leave it undefined.
+        virtual uint32_t CreateTexture(const TextureDesc& desc, const void* data) = 0;
+        virtual void DeleteTexture(uint32_t texture) = 0;
+
+        // Framebuffers. Logs an error if the attachments don't make a complete one.
+        virtual uint32_t CreateFramebuffer(uint32_t colorTexture, uint32_t depthStencilTexture) = 0;
+        virtual void DeleteFramebuffer(uint32_t framebuffer) = 0;
+        // 0 is the window. Also sets the viewport.
+        virtual void BindFramebuffer(uint32_t framebuffer, uint32_t width, uint32_t height) = 0;
+        // Color, depth and stencil of the bound framebuffer
+        virtual void Clear(const glm::vec4& color) = 0;
+
+        // State. Calls go straight through; RenderStateCache filters the redundant ones.
+        virtual void UseProgram(uint32_t program) = 0;
+        virtual void BindVertexArray(uint32_t vertexArray) = 0;
+        virtual void BindTexture(uint32_t unit, uint32_t texture) = 0;
+        virtual void SetDepthTest(bool enabled) = 0;
+        virtual void SetDepthWrite(bool enabled) = 0;
+        virtual void SetBlend(bool enabled) = 0;  // Source alpha, one minus source alpha
+        virtual void SetCullFace(bool enabled) = 0;  // Back faces, counter-clockwise front
+
+        // Triangles from the bound vertex array, indexed if it has an index buffer
+        virtual void Draw(uint32_t count, bool indexed) = 0;
+        // Reads one mat4 per instance from instanceBuffer, starting at offset bytes
+        virtual void DrawInstanced(uint32_t count, bool indexed, uint32_t instanceCount,
+                                   uint32_t instanceBuffer, size_t offset, uint32_t instanceLocation) = 0;
+    };
+
+}
@@ -1,46 +1,142 @@
 #include "RenderQueue.h"
-#include <algorithm>
+#include "Mesh.h"
+#include "Material.h"
+#include "Shader.h"
+#include "../Core/JobSystem.h"
+#include <atomic>
+#include <cstring>
 
 namespace Xi {
 
+    namespace RenderKey {
+
+        uint32_t QuantizeDepth(float distanceSquared) {
+            // Non-negative floats order the same as their bit patterns; keep the top 24 of
+            // the 31 bits below the sign
+            uint32_t bits;
+            std::memcpy(&bits, &distanceSquared, sizeof(bits));
+            if (bits & 0x80000000u) return 0;
+            return bits >> (31 - DEPTH_BITS);
+        }
+
+        uint64_t Encode(uint32_t layer, bool transparent, uint32_t shader, uint32_t material, uint32_t mesh, uint32_t depth) {
+            constexpr uint32_t STATE_BITS = SHADER_BITS + MATERIAL_BITS + MESH_BITS;
+
+            uint64_t state = (static_cast<uint64_t>(shader & ((1u << SHADER_BITS) - 1)) << (MATERIAL_BITS + MESH_BITS)) |
+                             (static_cast<uint64_t>(material & ((1u << MATERIAL_BITS) - 1)) << MESH_BITS) |
+                             static_cast<uint64_t>(mesh & ((1u << MESH_BITS) - 1));
+            depth &= (1u << DEPTH_BITS) - 1;
+
+            uint64_t key = static_cast<uint64_t>(layer & ((1u << LAYER_BITS) - 1)) << 60;
+            if (transparent) {
+                uint32_t backToFront = ((1u << DEPTH_BITS) - 1) - depth;
+                key |= 1ull << 59;
+                key |= static_cast<uint64_t>(backToFront) << STATE_BITS;
+                key |= state;
+            } else {
+                key |= state << DEPTH_BITS;
+                key |= depth;
+            }
+            return key;
+        }
+
+    }
+
+    uint32_t NextRenderSortID() {
+        static std::atomic<uint32_t> s_NextID{ 0 };
+        return s_NextID.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void RenderCommandList::Reset(uint32_t defaultShaderSortID) {
+        m_Commands.clear();
+        m_Bounds.Clear();
+        m_Visible.clear();
+        m_DefaultShaderSortID = defaultShaderSortID;
+    }
+
+    void RenderCommandList::Submit(const Mesh& mesh, const Material& material, const glm::mat4& transform, uint8_t layer) {
+        const MeshBounds& bounds = mesh.GetBounds();
+        glm::vec3 center, extents;
+        TransformBounds(transform, bounds.GetCenter(), bounds.GetExtents(), center, extents);
+        m_Bounds.Add(center, extents);
+
+        RenderCommand cmd;
+        cmd.mesh = &mesh;
+        cmd.material = &material;
+        cmd.transform = transform;
+        cmd.layer = layer;
+        cmd.transparent = material.transparent;
+
+        const Shader* shader = material.GetShader().get();
+        cmd.shaderSortID = shader ? shader->GetSortID() : m_DefaultShaderSortID;
+        m_Commands.push_back(cmd);
+    }
+
     void RenderQueue::Clear() {
-        m_OpaqueCommands.clear();
-        m_TransparentCommands.clear();
+        m_Commands.clear();
+        m_Items.clear();
+        m_TransparentCount = 0;
     }
 
     void RenderQueue::Submit(const RenderCommand& command) {
+        m_Commands.push_back(command);
         if (command.transparent) {
-            m_TransparentCommands.push_back(command);
-        } else {
-            m_OpaqueCommands.push_back(command);
+            m_TransparentCount++;
         }
     }
 
-    void RenderQueue::Sort(const glm::vec3& cameraPosition) {
-        // Calculate distances
-        auto calculateDistance = [&cameraPosition](RenderCommand& cmd) {
-            glm::vec3 position = glm::vec3(cmd.transform[3]);
-            cmd.distanceToCamera = glm::length(position - cameraPosition);
-        };
+    void RenderQueue::Sort(const glm::vec3& cameraPosition, JobSystem* jobs) {
+        m_Items.resize(m_Commands.size());
 
-        for (auto& cmd : m_OpaqueCommands) {
-            calculateDistance(cmd);
-        }
-        for (auto& cmd : m_TransparentCommands) {
-            calculateDistance(cmd);
+        // Each key only depends on its own command
+        constexpr uint32_t KEY_BATCH_SIZE = 4096;
+        ParallelFor(jobs, static_cast<uint32_t>(m_Commands.size()), KEY_BATCH_SIZE, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                const RenderCommand& cmd = m_Commands[i];
+                glm::vec3 offset = glm::vec3(cmd.transform[3]) - cameraPosition;
+                uint32_t depth = RenderKey::QuantizeDepth(glm::dot(offset, offset));
+
+                m_Items[i].key = RenderKey::Encode(cmd.layer, cmd.transparent, cmd.shaderSortID,
+                                                   cmd.material->GetSortID(), cmd.mesh->GetSortID(), depth);
+                m_Items[i].index = i;
+            }
+        });
+
+        RadixSort();
+    }
+
+    void RenderQueue::RadixSort() {
+        // LSD, one byte per pass. All eight histograms come from one read of the keys, and
+        // passes where every key has the same byte are skipped; that is most of them when
+        // the scene uses few layers, shaders and materials.
+        constexpr int PASSES = 8;
+        uint32_t histograms[PASSES][256] = {};
+
+        for (const RenderSortItem& item : m_Items) {
+            for (int pass = 0; pass < PASSES; pass++) {
+                histograms[pass][(item.key >> (pass * 8)) & 0xFF]++;
+            }
         }
 
-        // Sort opaque: front-to-back (minimize overdraw)
-        std::sort(m_OpaqueCommands.begin(), m_OpaqueCommands.end(),
-            [](const RenderCommand& a, const RenderCommand& b) {
-                return a.distanceToCamera < b.distanceToCamera;
-            });
-
-        // Sort transparent: back-to-front (correct blending)
-        std::sort(m_TransparentCommands.begin(), m_TransparentCommands.end(),
-            [](const RenderCommand& a, const RenderCommand& b) {
-                return a.distanceToCamera > b.distanceToCamera;
-            });
+        m_Scratch.resize(m_Items.size());
+        size_t count = m_Items.size();
+
+        for (int pass = 0; pass < PASSES; pass++) {
+            uint32_t* histogram = histograms[pass];
+            if (count == 0 || histogram[(m_Items[0].key >> (pass * 8)) & 0xFF] == count) continue;
+
+            uint32_t offset = 0;
+            for (int bucket = 0; bucket < 256; bucket++) {
+                uint32_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+
+            for (const RenderSortItem& item : m_Items) {
+                m_Scratch[histogram[(item.key >> (pass * 8)) & 0xFF]++] = item;
+            }
+            std::swap(m_Items, m_Scratch);
+        }
     }
 
 }
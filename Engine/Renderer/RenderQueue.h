@@ -1,39 +1,99 @@
 #pragma once
 
+#include "Frustum.h"
 #include <vector>
-#include <memory>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace Xi {
 
     class Mesh;
     class Material;
+    class JobSystem;
 
+    // Plain pointers, so recording and copying commands costs no reference counting. The mesh
+    // and material must outlive the EndFrame that draws them.
     struct RenderCommand {
-        std::shared_ptr<Mesh> mesh;
-        std::shared_ptr<Material> material;
+        const Mesh* mesh = nullptr;
+        const Material* material = nullptr;
         glm::mat4 transform;
-        float distanceToCamera = 0.0f;
+        uint32_t shaderSortID = 0;  // Of the shader the draw will use, which may be a default
+        uint8_t layer = 0;          // Lower layers draw first
         bool transparent = false;
     };
 
+    // 64-bit sort key, most significant bits first:
+    //   opaque:      layer 4 | 0 | shader 10 | material 12 | mesh 13 | depth 24, front to back
+    //   transparent: layer 4 | 1 | depth 24, back to front | shader 10 | material 12 | mesh 13
+    // Opaque draws group by state and transparent draws keep strict depth order. The IDs are
+    // the low bits of the objects' sort IDs, so objects only group less well once that many
+    // have been created.
+    namespace RenderKey {
+
+        constexpr uint32_t LAYER_BITS = 4;
+        constexpr uint32_t SHADER_BITS = 10;
+        constexpr uint32_t MATERIAL_BITS = 12;
+        constexpr uint32_t MESH_BITS = 13;
+        constexpr uint32_t DEPTH_BITS = 24;
+
+        // Monotonic in squared distance from the camera
+        uint32_t QuantizeDepth(float distanceSquared);
+
+        uint64_t Encode(uint32_t layer, bool transparent, uint32_t shader, uint32_t material, uint32_t mesh, uint32_t depth);
+
+    }
+
+    // Unique per shader, material and mesh, for sort keys
+    uint32_t NextRenderSortID();
+
+    struct RenderSortItem {
+        uint64_t key;
+        uint32_t index;  // Into the submitted commands
+    };
+
+    // Commands recorded by one thread, with the world bounds culling needs. The renderer hands
+    // one to each job of a parallel submission and culls and merges them in order at EndFrame.
+    class RenderCommandList {
+    public:
+        void Submit(const Mesh& mesh, const Material& material, const glm::mat4& transform, uint8_t layer = 0);
+
+        size_t GetCount() const { return m_Commands.size(); }
+
+    private:
+        friend class Renderer;
+
+        // defaultShaderSortID is used for materials without a shader of their own
+        void Reset(uint32_t defaultShaderSortID);
+
+        std::vector<RenderCommand> m_Commands;
+        CullingBuffer m_Bounds;  // Same indices as the commands
+        std::vector<uint32_t> m_Visible;
+        uint32_t m_DefaultShaderSortID = 0;
+    };
+
     class RenderQueue {
     public:
         void Clear();
 
         void Submit(const RenderCommand& command);
-        void Sort(const glm::vec3& cameraPosition);
 
-        const std::vector<RenderCommand>& GetOpaqueCommands() const { return m_OpaqueCommands; }
-        const std::vector<RenderCommand>& GetTransparentCommands() const { return m_TransparentCommands; }
+        // Builds the keys, on the job system when there are enough commands, and radix sorts them
+        void Sort(const glm::vec3& cameraPosition, JobSystem* jobs = nullptr);
 
-        size_t GetOpaqueCount() const { return m_OpaqueCommands.size(); }
-        size_t GetTransparentCount() const { return m_TransparentCommands.size(); }
-        size_t GetTotalCount() const { return m_OpaqueCommands.size() + m_TransparentCommands.size(); }
+        const std::vector<RenderCommand>& GetCommands() const { return m_Commands; }
+        const std::vector<RenderSortItem>& GetSortedItems() const { return m_Items; }
+
+        size_t GetOpaqueCount() const { return m_Commands.size() - m_TransparentCount; }
+        size_t GetTransparentCount() const { return m_TransparentCount; }
+        size_t GetTotalCount() const { return m_Commands.size(); }
 
     private:
-        std::vector<RenderCommand> m_OpaqueCommands;
-        std::vector<RenderCommand> m_TransparentCommands;
+        void RadixSort();
+
+        std::vector<RenderCommand> m_Commands;  // In submission order
+        std::vector<RenderSortItem> m_Items;
+        std::vector<RenderSortItem> m_Scratch;
+        size_t m_TransparentCount = 0;
     };
 
 }
@@ -0,0 +1,69 @@
+#include "RenderStateCache.h"
+#include "RenderDevice.h"
+
+namespace Xi {
+
+    void RenderStateCache::Invalidate() {
+        m_Program = UNKNOWN;
+        m_VertexArray = UNKNOWN;
+        m_Textures.fill(UNKNOWN);
+        m_DepthTest = UNKNOWN;
+        m_DepthWrite = UNKNOWN;
+        m_Blend = UNKNOWN;
+        m_CullFace = UNKNOWN;
+    }
+
+    bool RenderStateCache::Change(uint32_t& current, uint32_t value) {
+        if (current == value) {
+            m_Stats.avoided++;
+            return false;
+        }
+        current = value;
+        m_Stats.changes++;
+        return true;
+    }
+
+    void RenderStateCache::UseProgram(uint32_t program) {
+        if (Change(m_Program, program)) {
+            RenderDevice::Get().UseProgram(program);
+        }
+    }
+
+    void RenderStateCache::BindVertexArray(uint32_t vertexArray) {
+        if (Change(m_VertexArray, vertexArray)) {
+            RenderDevice::Get().BindVertexArray(vertexArray);
+        }
+    }
+
+    void RenderStateCache::BindTexture(uint32_t unit, uint32_t texture) {
+        if (unit >= MAX_TEXTURE_UNITS) return;
+        if (Change(m_Textures[unit], texture)) {
+            RenderDevice::Get().BindTexture(unit, texture);
+        }
+    }
+
+    void RenderStateCache::SetDepthTest(bool enabled) {
+        if (Change(m_DepthTest, enabled)) {
+            RenderDevice::Get().SetDepthTest(enabled);
+        }
+    }
+
+    void RenderStateCache::SetDepthWrite(bool enabled) {
+        if (Change(m_DepthWrite, enabled)) {
+            RenderDevice::Get().SetDepthWrite(enabled);
+        }
+    }
+
+    void RenderStateCache::SetBlend(bool enabled) {
+        if (Change(m_Blend, enabled)) {
+            RenderDevice::Get().SetBlend(enabled);
+        }
+    }
+
+    void RenderStateCache::SetCullFace(bool enabled) {
+        if (Change(m_CullFace, enabled)) {
+            RenderDevice::Get().SetCullFace(enabled);
+        }
+    }
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Xi {
+
+    // Mirrors the device state the renderer touches and skips calls that wouldn't change it.
+    // Anything else may change GL state between frames, so the renderer invalidates the
+    // cache before it starts drawing.
+    class RenderStateCache {
+    public:
+        static constexpr uint32_t MAX_TEXTURE_UNITS = 16;
+
+        struct Stats {
+            uint32_t changes = 0;  // Device calls made
+            uint32_t avoided = 0;  // Calls skipped because the state was already set
+        };
+
+        RenderStateCache() { Invalidate(); }
+
+        // Forgets everything, so the next call of each kind reaches GL
+        void Invalidate();
+
+        void UseProgram(uint32_t program);
+        void BindVertexArray(uint32_t vertexArray);
+        void BindTexture(uint32_t unit, uint32_t texture);  // GL_TEXTURE_2D
+
+        void SetDepthTest(bool enabled);
+        void SetDepthWrite(bool enabled);
+        void SetBlend(bool enabled);  // Source alpha, one minus source alpha
+        void SetCullFace(bool enabled);
+
+        const Stats& GetStats() const { return m_Stats; }
+        void ResetStats() { m_Stats = Stats(); }
+
+    private:
+        // Unknown until first set; ~0 never matches a real value
+        static constexpr uint32_t UNKNOWN = 0xFFFFFFFFu;
+
+        bool Change(uint32_t& current, uint32_t value);
+
+        uint32_t m_Program;
+        uint32_t m_VertexArray;
+        std::array<uint32_t, MAX_TEXTURE_UNITS> m_Textures;
+        uint32_t m_DepthTest;
+        uint32_t m_DepthWrite;
+        uint32_t m_Blend;
+        uint32_t m_CullFace;
+
+        Stats m_Stats;
+    };
+
+}
@@ -0,0 +1,316 @@
+#include "RenderThread.h"
+#include "Renderer.h"
+#include "RenderDevice.h"
+#include "../Core/Window.h"
+#include "../Core/Log.h"
+
+#include <string>
+#include <type_traits>
+
+namespace Xi {
+
+    // Current while the render thread runs. Calls made on it go straight to the wrapped device;
+    // calls from any other thread, which has no context, are run there and waited for, except
+    // deletes, which wait on the render thread for the packets that may still use the resource.
+    class RenderThreadDevice : public RenderDevice {
+    public:
+        RenderThreadDevice(RenderThread& thread, RenderDevice& device) : m_Thread(thread), m_Device(device) {}
+
+        const char* GetName() const override { return m_Device.GetName(); }
+
+        uint32_t CreateBuffer(BufferTarget target, size_t size, const void* data, BufferUsage usage) override {
+            return Call([&] { return m_Device.CreateBuffer(target, size, data, usage); });
+        }
+        void DeleteBuffer(uint32_t buffer) override {
+            Defer([this, buffer] { m_Device.DeleteBuffer(buffer); });
+        }
+        void ReallocateBuffer(BufferTarget target, uint32_t buffer, size_t size, BufferUsage usage) override {
+            Call([&] { m_Device.ReallocateBuffer(target, buffer, size, usage); });
+        }
+        void UpdateBuffer(BufferTarget target, uint32_t buffer, size_t offset, size_t size, const void* data) override {
+            Call([&] { m_Device.UpdateBuffer(target, buffer, offset, size, data); });
+        }
+        void BindBufferBase(BufferTarget target, uint32_t binding, uint32_t buffer) override {
+            Call([&] { m_Device.BindBufferBase(target, binding, buffer); });
+        }
+
+        uint32_t CreateVertexArray(uint32_t vertexBuffer, uint32_t indexBuffer, uint32_t stride,
+                                   const VertexAttribute* attributes, uint32_t attributeCount,
+                                   uint32_t instanceLocation) override {
+            return Call([&] {
+                return m_Device.CreateVertexArray(vertexBuffer, indexBuffer, stride, attributes, attributeCount, instanceLocation);
+            });
+        }
+        void DeleteVertexArray(uint32_t vertexArray) override {
+            Defer([this, vertexArray] { m_Device.DeleteVertexArray(vertexArray); });
+        }
+
+        uint32_t CreateProgram(const std::string& vertexSource, const std::string& fragmentSource) override {
+            return Call([&] { return m_Device.CreateProgram(vertexSource, fragmentSource); });
+        }
+        void DeleteProgram(uint32_t program) override {
+            Defer([this, program] { m_Device.DeleteProgram(program); });
+        }
+        int GetUniformLocation(uint32_t program, const char* name) override {
+            return Call([&] { return m_Device.GetUniformLocation(program, name); });
+        }
+
+        void SetUniform(int location, int value) override { Call([&] { m_Device.SetUniform(location, value); }); }
+        void SetUniform(int location, float value) override { Call([&] { m_Device.SetUniform(location, value); }); }
+        void SetUniform(int location, const glm::vec2& value) override { Call([&] { m_Device.SetUniform(location, value); }); }
+        void SetUniform(int location, const glm::vec3& value) override { Call([&] { m_Device.SetUniform(location, value); }); }
+        void SetUniform(int location, const glm::vec4& value) override { Call([&] { m_Device.SetUniform(location, value); }); }
+        void SetUniform(int location, const glm::mat3& value) override { Call([&] { m_Device.SetUniform(location, value); }); }
+        void SetUniform(int location, const glm::mat4& value) override { Call([&] { m_Device.SetUniform(location, value); }); }
+
+        uint32_t CreateTexture(const TextureDesc& desc, const void* data) override {
+            return Call([&] { return m_Device.CreateTexture(desc, data); });
+        }
+        void DeleteTexture(uint32_t texture) override {
+            Defer([this, texture] { m_Device.DeleteTexture(texture); });
+        }
+
+        uint32_t CreateFramebuffer(uint32_t colorTexture, uint32_t depthStencilTexture) override {
+            return Call([&] { return m_Device.CreateFramebuffer(colorTexture, depthStencilTexture); });
+        }
+        void DeleteFramebuffer(uint32_t framebuffer) override {
+            Defer([this, framebuffer] { m_Device.DeleteFramebuffer(framebuffer); });
+        }
+        void BindFramebuffer(uint32_t framebuffer, uint32_t width, uint32_t height) override {
+            Call([&] { m_Device.BindFramebuffer(framebuffer, width, height); });
+        }
+        void Clear(const glm::vec4& color) override {
+            Call([&] { m_Device.Clear(color); });
+        }
+
+        void UseProgram(uint32_t program) override { Call([&] { m_Device.UseProgram(program); }); }
+        void BindVertexArray(uint32_t vertexArray) override { Call([&] { m_Device.BindVertexArray(vertexArray); }); }
+        void BindTexture(uint32_t unit, uint32_t texture) override { Call([&] { m_Device.BindTexture(unit, texture); }); }
+        void SetDepthTest(bool enabled) override { Call([&] { m_Device.SetDepthTest(enabled); }); }
+        void SetDepthWrite(bool enabled) override { Call([&] { m_Device.SetDepthWrite(enabled); }); }
+        void SetBlend(bool enabled) override { Call([&] { m_Device.SetBlend(enabled); }); }
+        void SetCullFace(bool enabled) override { Call([&] { m_Device.SetCullFace(enabled); }); }
+
+        void Draw(uint32_t count, bool indexed) override {
+            Call([&] { m_Device.Draw(count, indexed); });
+        }
+        void DrawInstanced(uint32_t count, bool indexed, uint32_t instanceCount,
+                           uint32_t instanceBuffer, size_t offset, uint32_t instanceLocation) override {
+            Call([&] { m_Device.DrawInstanced(count, indexed, instanceCount, instanceBuffer, offset, instanceLocation); });
+        }
+
+    private:
+        // Arguments are captured by reference; RunSync returns only once the call has run
+        template <typename Func>
+        auto Call(Func func) -> decltype(func()) {
+            if (m_Thread.IsRenderThread()) {
+                return func();
+            }
+
+            if constexpr (std::is_void_v<decltype(func())>) {
+                m_Thread.RunSync(func);
+            } else {
+                decltype(func()) result{};
+                m_Thread.RunSync([&] { result = func(); });
+                return result;
+            }
+        }
+
+        // Captures by value: the caller doesn't wait
+        template <typename Func>
+        void Defer(Func func) {
+            if (m_Thread.IsRenderThread()) {
+                func();
+                return;
+            }
+            m_Thread.RunAfterQueued(func);
+        }
+
+        RenderThread& m_Thread;
+        RenderDevice& m_Device;
+    };
+
+    RenderThread::RenderThread(Window* window, Renderer& renderer, uint32_t maxFrameLatency)
+        : m_Window(window), m_Renderer(renderer) {
+        uint32_t count = glm::clamp(maxFrameLatency, 1u, 4u);
+        for (uint32_t i = 0; i < count; i++) {
+            m_Packets.push_back(std::make_unique<FramePacket>());
+            m_FreePackets.push_back(m_Packets.back().get());
+        }
+    }
+
+    RenderThread::~RenderThread() {
+        Stop();
+    }
+
+    void RenderThread::Start() {
+        if (IsRunning()) return;
+
+        // Resources stay valid: the wrapper hands every call to the same device
+        m_WrappedDevice = RenderDevice::SetCurrent(std::make_unique<RenderThreadDevice>(*this, RenderDevice::Get()));
+
+        if (m_Window) {
+            Window::ReleaseContext();
+        }
+        m_Stopping = false;
+        m_Thread = std::thread([this] { ThreadMain(); });
+
+        XI_LOG_INFO("Render thread started, up to " + std::to_string(m_Packets.size()) + " frames in flight");
+    }
+
+    void RenderThread::Stop() {
+        if (!IsRunning()) return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_WorkReady.notify_all();
+        m_Thread.join();
+        m_ThreadID = std::thread::id();
+
+        if (m_Window) {
+            m_Window->MakeContextCurrent();
+        }
+        RenderDevice::SetCurrent(std::move(m_WrappedDevice));
+    }
+
+    FramePacket& RenderThread::AcquirePacket() {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_WorkDone.wait(lock, [this] { return !m_FreePackets.empty(); });
+
+        FramePacket* packet = m_FreePackets.back();
+        m_FreePackets.pop_back();
+        m_PacketsAcquired++;
+        return *packet;
+    }
+
+    void RenderThread::SubmitPacket(FramePacket& packet) {
+        if (!IsRunning()) {
+            // Nothing would draw it; drop the frame rather than lose the packet
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_FreePackets.push_back(&packet);
+            m_PacketsRetired++;
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_QueuedPackets.push_back(&packet);
+        }
+        m_WorkReady.notify_one();
+    }
+
+    void RenderThread::RunSync(const std::function<void()>& func) {
+        if (!IsRunning() || IsRenderThread()) {
+            func();
+            return;
+        }
+
+        Task task = { &func, false };
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Tasks.push_back(&task);
+        m_WorkReady.notify_one();
+        m_WorkDone.wait(lock, [&task] { return task.done; });
+    }
+
+    void RenderThread::RunAfterQueued(std::function<void()> func) {
+        if (!IsRunning() || IsRenderThread()) {
+            func();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_DeferredTasks.push_back({ std::move(func), m_PacketsAcquired });
+        }
+        m_WorkReady.notify_one();
+    }
+
+    // Deferred tasks are queued in order, so their packet counts never decrease
+    bool RenderThread::HasReadyDeferredTask() const {
+        return !m_DeferredTasks.empty() && m_DeferredTasks.front().afterPacket <= m_PacketsRetired;
+    }
+
+    void RenderThread::ThreadMain() {
+        m_ThreadID = std::this_thread::get_id();
+        if (m_Window) {
+            m_Window->MakeContextCurrent();
+        }
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        while (true) {
+            m_WorkReady.wait(lock, [this] {
+                return m_Stopping || !m_Tasks.empty() || !m_QueuedPackets.empty() || HasReadyDeferredTask();
+            });
+
+            // Tasks first: their callers are blocked on them
+            if (!m_Tasks.empty()) {
+                Task* task = m_Tasks.front();
+                m_Tasks.pop_front();
+
+                lock.unlock();
+                (*task->func)();
+                lock.lock();
+
+                task->done = true;
+                m_WorkDone.notify_all();
+                continue;
+            }
+
+            if (HasReadyDeferredTask()) {
+                std::function<void()> func = std::move(m_DeferredTasks.front().func);
+                m_DeferredTasks.pop_front();
+
+                lock.unlock();
+                func();
+                lock.lock();
+                continue;
+            }
+
+            if (!m_QueuedPackets.empty()) {
+                FramePacket* packet = m_QueuedPackets.front();
+                m_QueuedPackets.pop_front();
+
+                lock.unlock();
+                DrawPacket(*packet);
+                lock.lock();
+
+                m_FreePackets.push_back(packet);
+                m_PacketsRetired++;
+                m_WorkDone.notify_all();
+                continue;
+            }
+
+            // Stopping, with everything submitted drawn. Packets still held by the game thread
+            // won't be, so nothing is left to wait for.
+            break;
+        }
+
+        std::deque<DeferredTask> remaining;
+        remaining.swap(m_DeferredTasks);
+        lock.unlock();
+        for (DeferredTask& task : remaining) {
+            task.func();
+        }
+
+        if (m_Window) {
+            Window::ReleaseContext();
+        }
+    }
+
+    void RenderThread::DrawPacket(FramePacket& packet) {
+        RenderDevice& device = RenderDevice::Get();
+        if (packet.targetWidth > 0 && packet.targetHeight > 0) {
+            device.BindFramebuffer(0, packet.targetWidth, packet.targetHeight);
+        }
+        device.Clear(packet.clearColor);
+
+        m_Renderer.ExecutePacket(packet);
+
+        if (m_Window) {
+            m_Window->SwapBuffers();
+        }
+    }
+
+}
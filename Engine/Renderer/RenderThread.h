@@ -0,0 +1,94 @@
+#pragma once
+
+#include "FramePacket.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Xi {
+
+    class Window;
+    class Renderer;
+    class RenderDevice;
+
+    // Draws frame packets on a thread of its own, which owns the window's GL context while it
+    // runs, so the game thread builds frame N+1 while this one submits frame N and waits on
+    // the swap. Render device calls from other threads, such as meshes and textures being
+    // created, are forwarded here and waited for. Deletes are queued behind the packets
+    // already handed out, which may still draw what is being deleted.
+    class RenderThread {
+    public:
+        // maxFrameLatency packets exist, so the game thread can be that many frames ahead of the
+        // one on screen: 2 double buffers, 3 triple buffers. A null window draws without a
+        // context or presenting, for headless runs on the null device.
+        RenderThread(Window* window, Renderer& renderer, uint32_t maxFrameLatency = 2);
+        ~RenderThread();
+
+        RenderThread(const RenderThread&) = delete;
+        RenderThread& operator=(const RenderThread&) = delete;
+
+        // Takes the context from the calling thread
+        void Start();
+        // Draws what was submitted, then hands the context back to the calling thread
+        void Stop();
+        bool IsRunning() const { return m_Thread.joinable(); }
+
+        // A packet to build the next frame into. Blocks while every packet is queued or drawing.
+        FramePacket& AcquirePacket();
+        // Queues an acquired packet to be drawn and presented
+        void SubmitPacket(FramePacket& packet);
+
+        // Runs func on the render thread and waits for it. On that thread, or when it isn't
+        // running, func runs directly.
+        void RunSync(const std::function<void()>& func);
+        // Runs func on the render thread once every packet acquired so far has been drawn,
+        // without waiting for it. When the thread isn't running, func runs directly.
+        void RunAfterQueued(std::function<void()> func);
+
+        bool IsRenderThread() const { return std::this_thread::get_id() == m_ThreadID.load(); }
+
+        uint32_t GetMaxFrameLatency() const { return static_cast<uint32_t>(m_Packets.size()); }
+
+    private:
+        struct Task {
+            const std::function<void()>* func;
+            bool done;
+        };
+
+        struct DeferredTask {
+            std::function<void()> func;
+            uint64_t afterPacket;  // Runs once this many packets are retired
+        };
+
+        void ThreadMain();
+        bool HasReadyDeferredTask() const;
+        void DrawPacket(FramePacket& packet);
+
+        Window* m_Window;
+        Renderer& m_Renderer;
+        std::unique_ptr<RenderDevice> m_WrappedDevice;  // Current again once stopped
+
+        std::vector<std::unique_ptr<FramePacket>> m_Packets;
+        std::vector<FramePacket*> m_FreePackets;
+        std::deque<FramePacket*> m_QueuedPackets;
+        std::deque<Task*> m_Tasks;
+        std::deque<DeferredTask> m_DeferredTasks;
+        uint64_t m_PacketsAcquired = 0;
+        uint64_t m_PacketsRetired = 0;  // Drawn, or dropped by SubmitPacket
+
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkReady;  // Packets, tasks or stopping, for the render thread
+        std::condition_variable m_WorkDone;   // A packet freed or a task run, for waiting callers
+        bool m_Stopping = false;
+
+        std::thread m_Thread;
+        std::atomic<std::thread::id> m_ThreadID;
+    };
+
+}
@@ -2,9 +2,15 @@
 #include "Shader.h"
 #include "Mesh.h"
 #include "Material.h"
+#include "UniformBuffer.h"
+#include "StorageBuffer.h"
+#include "RenderDevice.h"
+#include "../Core/JobSystem.h"
 #include "../Core/Log.h"
 
-#include <GL/glew.h>
+#include <chrono>
+#include <cmath>
+#include <string>
 
 namespace Xi {
 
@@ -17,20 +23,31 @@ layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
 layout(location = 3) in vec3 a_Tangent;
 
+#ifdef XI_INSTANCED
+layout(location = 4) in mat4 a_InstanceModel;
+#define MODEL_MATRIX a_InstanceModel
+#else
 uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Projection;
+#define MODEL_MATRIX u_Model
+#endif
+
+layout(std140, binding = 0) uniform CameraData {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec3 u_CameraPos;
+};
 
 out vec3 v_WorldPos;
 out vec3 v_Normal;
 out vec2 v_TexCoord;
 out mat3 v_TBN;
+out vec4 v_ClipPos;
 
 void main() {
-    vec4 worldPos = u_Model * vec4(a_Position, 1.0);
+    vec4 worldPos = MODEL_MATRIX * vec4(a_Position, 1.0);
     v_WorldPos = worldPos.xyz;
 
-    mat3 normalMatrix = transpose(inverse(mat3(u_Model)));
+    mat3 normalMatrix = transpose(inverse(mat3(MODEL_MATRIX)));
     v_Normal = normalize(normalMatrix * a_Normal);
 
     vec3 T = normalize(normalMatrix * a_Tangent);
@@ -42,6 +59,7 @@ void main() {
     v_TexCoord = a_TexCoord;
 
     gl_Position = u_Projection * u_View * worldPos;
+    v_ClipPos = gl_Position;
 }
 )";
 
@@ -52,10 +70,16 @@ in vec3 v_WorldPos;
 in vec3 v_Normal;
 in vec2 v_TexCoord;
 in mat3 v_TBN;
+in vec4 v_ClipPos;
 
 out vec4 FragColor;
 
-uniform vec3 u_CameraPos;
+layout(std140, binding = 0) uniform CameraData {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec3 u_CameraPos;
+};
+
 uniform vec4 u_AlbedoColor;
 uniform float u_Metallic;
 uniform float u_Roughness;
@@ -67,13 +91,31 @@ uniform int u_HasNormalMap;
 uniform sampler2D u_AlbedoMap;
 uniform sampler2D u_NormalMap;
 
-// Lights
-uniform int u_NumLights;
-uniform vec3 u_LightPositions[8];
-uniform vec3 u_LightDirections[8];
-uniform vec3 u_LightColors[8];
-uniform float u_LightIntensities[8];
-uniform int u_LightTypes[8]; // 0 = directional, 1 = point, 2 = spot
+// Lights: directional ones first, then point and spot lights, found through the fragment's
+// cluster of the froxel grid
+struct LightData {
+    vec4 position;   // w = type: 0 = directional, 1 = point, 2 = spot
+    vec4 direction;  // w = range
+    vec4 color;      // w = intensity
+    vec4 spot;       // x = cosine of the outer angle, y = of the inner angle, z = attenuation
+};
+
+layout(std140, binding = 1) uniform LightBlock {
+    uvec4 u_ClusterGrid;  // xyz = clusters across, up and in depth, w = directional light count
+    vec4 u_ClusterDepth;  // Slice = log(view depth) * x - y
+};
+
+layout(std430, binding = 0) readonly buffer LightBuffer {
+    LightData u_Lights[];
+};
+
+layout(std430, binding = 1) readonly buffer ClusterBuffer {
+    uvec2 u_Clusters[];  // x = first entry in u_LightIndices, y = count
+};
+
+layout(std430, binding = 2) readonly buffer LightIndexBuffer {
+    uint u_LightIndices[];
+};
 
 const float PI = 3.14159265359;
 
@@ -113,6 +155,59 @@ float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
     return ggx1 * ggx2;
 }
 
+vec3 EvaluateLight(LightData light, vec3 N, vec3 V, vec3 F0, vec3 albedo) {
+    vec3 L;
+    float attenuation = 1.0;
+
+    if (int(light.position.w) == 0) {
+        // Directional light
+        L = normalize(-light.direction.xyz);
+    } else {
+        // Point or spot light: inverse-square falloff, windowed to reach zero at the range
+        vec3 toLight = light.position.xyz - v_WorldPos;
+        float distance = length(toLight);
+        L = toLight / max(distance, 0.0001);
+
+        float ratio = distance / light.direction.w;
+        float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+        attenuation = window * window / (1.0 + light.spot.z * distance * distance);
+
+        if (int(light.position.w) == 2) {
+            float cosAngle = dot(-L, normalize(light.direction.xyz));
+            attenuation *= smoothstep(light.spot.x, light.spot.y, cosAngle);
+        }
+    }
+
+    vec3 H = normalize(V + L);
+    vec3 radiance = light.color.rgb * light.color.w * attenuation;
+
+    float NDF = DistributionGGX(N, H, u_Roughness);
+    float G = GeometrySmith(N, V, L, u_Roughness);
+    vec3 F = FresnelSchlick(max(dot(H, V), 0.0), F0);
+
+    vec3 numerator = NDF * G * F;
+    float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
+    vec3 specular = numerator / denominator;
+
+    vec3 kS = F;
+    vec3 kD = vec3(1.0) - kS;
+    kD *= 1.0 - u_Metallic;
+
+    float NdotL = max(dot(N, L), 0.0);
+    return (kD * albedo / PI + specular) * radiance * NdotL;
+}
+
+uint FindCluster() {
+    vec2 ndc = v_ClipPos.xy / v_ClipPos.w;
+    vec2 grid = vec2(u_ClusterGrid.xy);
+    uvec2 tile = uvec2(clamp((ndc * 0.5 + 0.5) * grid, vec2(0.0), grid - 1.0));
+
+    float depth = max(-(u_View * vec4(v_WorldPos, 1.0)).z, 0.0001);
+    float slice = clamp(floor(log(depth) * u_ClusterDepth.x - u_ClusterDepth.y), 0.0, float(u_ClusterGrid.z) - 1.0);
+
+    return tile.x + tile.y * u_ClusterGrid.x + uint(slice) * u_ClusterGrid.x * u_ClusterGrid.y;
+}
+
 void main() {
     vec4 albedo = u_AlbedoColor;
     if (u_HasAlbedoMap == 1) {
@@ -133,37 +228,13 @@ void main() {
 
     vec3 Lo = vec3(0.0);
 
-    for (int i = 0; i < u_NumLights && i < 8; i++) {
-        vec3 L;
-        float attenuation = 1.0;
-
-        if (u_LightTypes[i] == 0) {
-            // Directional light
-            L = normalize(-u_LightDirections[i]);
-        } else {
-            // Point or spot light
-            L = normalize(u_LightPositions[i] - v_WorldPos);
-            float distance = length(u_LightPositions[i] - v_WorldPos);
-            attenuation = 1.0 / (distance * distance);
-        }
-
-        vec3 H = normalize(V + L);
-        vec3 radiance = u_LightColors[i] * u_LightIntensities[i] * attenuation;
-
-        float NDF = DistributionGGX(N, H, u_Roughness);
-        float G = GeometrySmith(N, V, L, u_Roughness);
-        vec3 F = FresnelSchlick(max(dot(H, V), 0.0), F0);
-
-        vec3 numerator = NDF * G * F;
-        float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
-        vec3 specular = numerator / denominator;
-
-        vec3 kS = F;
-        vec3 kD = vec3(1.0) - kS;
-        kD *= 1.0 - u_Metallic;
+    for (uint i = 0u; i < u_ClusterGrid.w; i++) {
+        Lo += EvaluateLight(u_Lights[i], N, V, F0, albedo.rgb);
+    }
 
-        float NdotL = max(dot(N, L), 0.0);
-        Lo += (kD * albedo.rgb / PI + specular) * radiance * NdotL;
+    uvec2 cluster = u_Clusters[FindCluster()];
+    for (uint i = 0u; i < cluster.y; i++) {
+        Lo += EvaluateLight(u_Lights[u_LightIndices[cluster.x + i]], N, V, F0, albedo.rgb);
     }
 
     vec3 ambient = vec3(0.03) * albedo.rgb * u_AO;
@@ -185,15 +256,25 @@ layout(location = 0) in vec3 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
 
+#ifdef XI_INSTANCED
+layout(location = 4) in mat4 a_InstanceModel;
+#define MODEL_MATRIX a_InstanceModel
+#else
 uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Projection;
+#define MODEL_MATRIX u_Model
+#endif
+
+layout(std140, binding = 0) uniform CameraData {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec3 u_CameraPos;
+};
 
 out vec2 v_TexCoord;
 
 void main() {
     v_TexCoord = a_TexCoord;
-    gl_Position = u_Projection * u_View * u_Model * vec4(a_Position, 1.0);
+    gl_Position = u_Projection * u_View * MODEL_MATRIX * vec4(a_Position, 1.0);
 }
 )";
 
@@ -223,15 +304,25 @@ layout(location = 0) in vec3 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
 
+#ifdef XI_INSTANCED
+layout(location = 4) in mat4 a_InstanceModel;
+#define MODEL_MATRIX a_InstanceModel
+#else
 uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Projection;
+#define MODEL_MATRIX u_Model
+#endif
+
+layout(std140, binding = 0) uniform CameraData {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec3 u_CameraPos;
+};
 
 out vec2 v_TexCoord;
 
 void main() {
     v_TexCoord = a_TexCoord;
-    gl_Position = u_Projection * u_View * u_Model * vec4(a_Position, 1.0);
+    gl_Position = u_Projection * u_View * MODEL_MATRIX * vec4(a_Position, 1.0);
 }
 )";
 
@@ -255,146 +346,484 @@ void main() {
 }
 )";
 
+    // std140 layouts of the CameraData and LightBlock uniform blocks above
+    struct CameraUniforms {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec3 cameraPosition;
+        float padding;
+    };
+
+    struct LightUniforms {
+        glm::uvec4 clusterGrid;   // w = directional light count
+        glm::vec4 clusterDepth;   // x = slice scale, y = slice bias
+    };
+
+    // std430 layout of an element of the LightBuffer storage block
+    struct StoredLight {
+        glm::vec4 position;   // w = type
+        glm::vec4 direction;  // w = range
+        glm::vec4 color;      // w = intensity
+        glm::vec4 spot;       // x = cosine of the outer angle, y = of the inner angle, z = attenuation
+    };
+
+    static_assert(sizeof(CameraUniforms) == 144, "CameraUniforms must match the std140 CameraData block");
+    static_assert(sizeof(LightUniforms) == 32, "LightUniforms must match the std140 LightBlock block");
+    static_assert(sizeof(StoredLight) == 64, "StoredLight must match the std430 LightData struct");
+    static_assert(sizeof(glm::uvec2) == 8, "Clusters must match the std430 uvec2 array");
+
+    // The same source with XI_INSTANCED defined; #version has to stay the first directive
+    static std::string MakeInstancedSource(const char* source) {
+        std::string result = source;
+        size_t version = result.find("#version");
+        size_t lineEnd = version == std::string::npos ? 0 : result.find('\n', version) + 1;
+        result.insert(lineEnd, "#define XI_INSTANCED\n");
+        return result;
+    }
+
+    static std::shared_ptr<Shader> CreateShader(const char* vertexSource, const char* fragmentSource, const char* name) {
+        auto shader = std::make_shared<Shader>();
+        if (!shader->LoadFromSource(vertexSource, fragmentSource)) {
+            XI_LOG_ERROR(std::string("Failed to create ") + name + " shader");
+            return shader;
+        }
+
+        auto instanced = std::make_shared<Shader>();
+        if (instanced->LoadFromSource(MakeInstancedSource(vertexSource), fragmentSource)) {
+            shader->SetInstancedVariant(instanced);
+        } else {
+            XI_LOG_WARN(std::string("Failed to create instanced ") + name + " shader, drawing it without instancing");
+        }
+        return shader;
+    }
+
     Renderer::Renderer() = default;
     Renderer::~Renderer() = default;
 
     void Renderer::Init() {
         XI_LOG_INFO("Renderer initializing...");
 
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-        glFrontFace(GL_CCW);
+        RenderDevice& device = RenderDevice::Get();
+        device.SetDepthTest(true);
+        device.SetCullFace(true);
 
         CreateDefaultShaders();
+        ResetCommandLists();
+        m_InstanceBuffer = device.CreateBuffer(BufferTarget::Vertex, 0, nullptr, BufferUsage::Stream);
+        m_CameraUniforms = std::make_unique<UniformBuffer>(sizeof(CameraUniforms), UniformBinding::Camera);
+        m_LightUniforms = std::make_unique<UniformBuffer>(sizeof(LightUniforms), UniformBinding::Lights);
+        m_LightBuffer = std::make_unique<StorageBuffer>(StorageBinding::Lights);
+        m_ClusterBuffer = std::make_unique<StorageBuffer>(StorageBinding::Clusters);
+        m_LightIndexBuffer = std::make_unique<StorageBuffer>(StorageBinding::LightIndices);
 
         // Set default camera
         m_Camera.SetPerspective(45.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
 
+        // An unlit grid, so immediate drawing before the first frame reads valid clusters
+        FramePacket unlit;
+        m_LightClusters.SetProjection(m_Camera.GetProjectionMatrix(), m_Camera.GetNearClip(), m_Camera.GetFarClip());
+        m_LightClusters.Build(unlit.view, unlit.lights, nullptr, unlit.clusters, unlit.clusterLightIndices);
+        UploadFrameUniforms(unlit);
+
         XI_LOG_INFO("Renderer initialized");
     }
 
     void Renderer::Shutdown() {
+        if (m_InstanceBuffer) {
+            RenderDevice::Get().DeleteBuffer(m_InstanceBuffer);
+            m_InstanceBuffer = 0;
+            m_InstanceBufferCapacity = 0;
+        }
+        m_CameraUniforms.reset();
+        m_LightUniforms.reset();
+        m_LightBuffer.reset();
+        m_ClusterBuffer.reset();
+        m_LightIndexBuffer.reset();
+
+        // Its material copies hold shaders and textures
+        m_Packet.Clear();
+
         m_DefaultShader.reset();
         m_UnlitShader.reset();
         m_SpriteShader.reset();
     }
 
     void Renderer::CreateDefaultShaders() {
-        m_DefaultShader = std::make_shared<Shader>();
-        if (!m_DefaultShader->LoadFromSource(s_DefaultVertexShader, s_DefaultFragmentShader)) {
-            XI_LOG_ERROR("Failed to create default shader");
+        m_DefaultShader = CreateShader(s_DefaultVertexShader, s_DefaultFragmentShader, "default");
+        m_UnlitShader = CreateShader(s_UnlitVertexShader, s_UnlitFragmentShader, "unlit");
+        m_SpriteShader = CreateShader(s_SpriteVertexShader, s_SpriteFragmentShader, "sprite");
+    }
+
+    uint32_t Renderer::GetDefaultShaderSortID() const {
+        return m_DefaultShader ? m_DefaultShader->GetSortID() : 0;
+    }
+
+    void Renderer::BeginFrame() {
+        ResetStats();
+        m_RenderQueue.Clear();
+        ResetCommandLists();
+    }
+
+    void Renderer::ResetCommandLists() {
+        for (uint32_t i = 0; i < m_UsedCommandLists; i++) {
+            m_CommandLists[i].Reset(0);
         }
 
-        m_UnlitShader = std::make_shared<Shader>();
-        if (!m_UnlitShader->LoadFromSource(s_UnlitVertexShader, s_UnlitFragmentShader)) {
-            XI_LOG_ERROR("Failed to create unlit shader");
+        // The Submit list is always open
+        if (m_CommandLists.empty()) {
+            m_CommandLists.resize(1);
         }
+        m_CommandLists[0].Reset(GetDefaultShaderSortID());
+        m_UsedCommandLists = 1;
+    }
 
-        m_SpriteShader = std::make_shared<Shader>();
-        if (!m_SpriteShader->LoadFromSource(s_SpriteVertexShader, s_SpriteFragmentShader)) {
-            XI_LOG_ERROR("Failed to create sprite shader");
+    void Renderer::CullSubmissions() {
+        Frustum frustum(m_Camera.GetViewProjectionMatrix());
+
+        ParallelFor(m_JobSystem, m_UsedCommandLists, 1, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                m_CommandLists[i].m_Bounds.Cull(frustum, m_CommandLists[i].m_Visible);
+            }
+        });
+
+        uint32_t submitted = 0;
+        for (uint32_t i = 0; i < m_UsedCommandLists; i++) {
+            RenderCommandList& list = m_CommandLists[i];
+            for (uint32_t index : list.m_Visible) {
+                m_RenderQueue.Submit(list.m_Commands[index]);
+            }
+            submitted += static_cast<uint32_t>(list.m_Commands.size());
         }
+        ResetCommandLists();
+
+        m_Stats.visibleObjects = static_cast<uint32_t>(m_RenderQueue.GetTotalCount());
+        m_Stats.culledObjects = submitted - m_Stats.visibleObjects;
     }
 
-    void Renderer::BeginFrame() {
-        ResetStats();
-        m_RenderQueue.Clear();
+    static float MillisecondsSince(std::chrono::high_resolution_clock::time_point start) {
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
     }
 
     void Renderer::EndFrame() {
-        m_RenderQueue.Sort(m_Camera.GetPosition());
+        BuildPacket(m_Packet);
+        ExecutePacket(m_Packet);
+        AddSubmitStats(m_Packet.stats);
+    }
+
+    void Renderer::EndFrame(FramePacket& packet) {
+        // The render thread is done with the packet, so its stats are complete
+        AddSubmitStats(packet.stats);
+        BuildPacket(packet);
+    }
+
+    void Renderer::BuildPacket(FramePacket& packet) {
+        packet.Clear();
 
-        // Render opaque objects
-        for (const auto& cmd : m_RenderQueue.GetOpaqueCommands()) {
-            if (cmd.material && cmd.mesh) {
-                DrawMesh(*cmd.mesh, *cmd.material, cmd.transform);
+        auto cullStart = std::chrono::high_resolution_clock::now();
+        CullSubmissions();
+        m_Stats.cullTimeMs = MillisecondsSince(cullStart);
+
+        auto sortStart = std::chrono::high_resolution_clock::now();
+        m_RenderQueue.Sort(m_Camera.GetPosition(), m_JobSystem);
+        m_Stats.sortTimeMs = MillisecondsSince(sortStart);
+
+        auto batchStart = std::chrono::high_resolution_clock::now();
+        BuildDraws(packet);
+        m_Stats.batchTimeMs = MillisecondsSince(batchStart);
+
+        packet.view = m_Camera.GetViewMatrix();
+        packet.projection = m_Camera.GetProjectionMatrix();
+        packet.cameraPosition = m_Camera.GetPosition();
+
+        auto lightStart = std::chrono::high_resolution_clock::now();
+        BuildLights(packet);
+        m_Stats.lightTimeMs = MillisecondsSince(lightStart);
+        ClearLights();
+    }
+
+    void Renderer::BuildLights(FramePacket& packet) {
+        // Directional lights first, then the rest in the order they were added
+        for (const LightData& light : m_Lights) {
+            if (light.type == LightData::Type::Directional) packet.lights.push_back(light);
+        }
+        packet.directionalLightCount = static_cast<uint32_t>(packet.lights.size());
+        for (const LightData& light : m_Lights) {
+            if (light.type != LightData::Type::Directional) packet.lights.push_back(light);
+        }
+
+        m_LightClusters.SetProjection(packet.projection, m_Camera.GetNearClip(), m_Camera.GetFarClip());
+        m_LightClusters.Build(packet.view, packet.lights, m_JobSystem, packet.clusters, packet.clusterLightIndices);
+        packet.clusterSliceScale = m_LightClusters.GetSliceScale();
+        packet.clusterSliceBias = m_LightClusters.GetSliceBias();
+
+        m_Stats.lights = static_cast<uint32_t>(packet.lights.size());
+        m_Stats.clusteredLights = m_LightClusters.GetBinnedLightCount();
+        m_Stats.lightAssignments = static_cast<uint32_t>(packet.clusterLightIndices.size());
+    }
+
+    void Renderer::BuildDraws(FramePacket& packet) {
+        const auto& commands = m_RenderQueue.GetCommands();
+        const auto& items = m_RenderQueue.GetSortedItems();
+        uint32_t itemCount = static_cast<uint32_t>(items.size());
+
+        m_PacketMaterials.clear();
+
+        uint32_t begin = 0;
+        while (begin < itemCount) {
+            const RenderCommand& first = commands[items[begin].index];
+
+            // Equal mesh and material means equal shader and transparency too. The run keeps
+            // its sorted order, and instances rasterize in order, so transparent runs blend
+            // the same as separate draws.
+            uint32_t end = begin + 1;
+            while (end < itemCount) {
+                const RenderCommand& cmd = commands[items[end].index];
+                if (cmd.mesh != first.mesh || cmd.material != first.material || cmd.layer != first.layer) break;
+                end++;
+            }
+
+            const auto& shader = first.material->GetShader() ? first.material->GetShader() : m_DefaultShader;
+
+            FramePacket::Draw draw;
+            draw.mesh = first.mesh->GetDrawInfo();
+            draw.material = AddPacketMaterial(packet, *first.material);
+            draw.count = end - begin;
+            draw.instanced = end - begin > 1 && shader && shader->GetInstancedVariant();
+            draw.transparent = first.transparent;
+
+            std::vector<glm::mat4>& matrices = draw.instanced ? packet.instanceData : packet.transforms;
+            draw.firstTransform = static_cast<uint32_t>(matrices.size());
+            for (uint32_t i = begin; i < end; i++) {
+                matrices.push_back(commands[items[i].index].transform);
             }
+            packet.draws.push_back(draw);
+            begin = end;
+        }
+    }
+
+    uint32_t Renderer::AddPacketMaterial(FramePacket& packet, const Material& material) {
+        auto [it, added] = m_PacketMaterials.try_emplace(&material, static_cast<uint32_t>(packet.materials.size()));
+        if (added) {
+            packet.materials.push_back(material);
         }
+        return it->second;
+    }
+
+    void Renderer::ExecutePacket(FramePacket& packet) {
+        auto submitStart = std::chrono::high_resolution_clock::now();
+        m_SubmitStats = FramePacket::SubmitStats();
+
+        UploadInstances(packet.instanceData);
+        UploadFrameUniforms(packet);
+
+        // Other code, ImGui included, changes GL state between frames
+        InvalidateState();
+        m_State.ResetStats();
+        m_State.SetDepthTest(true);
 
-        // Render transparent objects
-        glDepthMask(GL_FALSE);
-        for (const auto& cmd : m_RenderQueue.GetTransparentCommands()) {
-            if (cmd.material && cmd.mesh) {
-                DrawMesh(*cmd.mesh, *cmd.material, cmd.transform);
+        for (const FramePacket::Draw& draw : packet.draws) {
+            const Material& material = packet.materials[draw.material];
+
+            // Transparent draws test depth but don't write it
+            m_State.SetDepthWrite(!draw.transparent);
+
+            if (draw.instanced) {
+                DrawInstanced(draw.mesh, material, draw.firstTransform, draw.count);
+                continue;
+            }
+
+            for (uint32_t i = 0; i < draw.count; i++) {
+                DrawSingle(draw.mesh, material, packet.transforms[draw.firstTransform + i]);
             }
         }
-        glDepthMask(GL_TRUE);
 
-        ClearLights();
+        RestoreDefaultState();
+        m_SubmitStats.stateChanges = m_State.GetStats().changes;
+        m_SubmitStats.stateChangesAvoided = m_State.GetStats().avoided;
+        m_SubmitStats.submitTimeMs = MillisecondsSince(submitStart);
+        packet.stats = m_SubmitStats;
     }
 
-    void Renderer::SetCamera(const Camera& camera) {
-        m_Camera = camera;
+    void Renderer::AddSubmitStats(const FramePacket::SubmitStats& stats) {
+        // Added, so immediate draws since BeginFrame still count
+        m_Stats.drawCalls += stats.drawCalls;
+        m_Stats.triangles += stats.triangles;
+        m_Stats.instancedDrawCalls += stats.instancedDrawCalls;
+        m_Stats.instancedObjects += stats.instancedObjects;
+        m_Stats.materialBinds += stats.materialBinds;
+        m_Stats.stateChanges += stats.stateChanges;
+        m_Stats.stateChangesAvoided += stats.stateChangesAvoided;
+        m_Stats.submitTimeMs += stats.submitTimeMs;
     }
 
-    void Renderer::Submit(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, const glm::mat4& transform) {
-        RenderCommand cmd;
-        cmd.mesh = mesh;
-        cmd.material = material;
-        cmd.transform = transform;
-        cmd.transparent = material ? material->transparent : false;
-        m_RenderQueue.Submit(cmd);
+    void Renderer::UploadInstances(const std::vector<glm::mat4>& instanceData) {
+        if (instanceData.empty()) return;
+
+        // Orphan the previous frame's storage so the driver doesn't wait on draws still using it
+        RenderDevice& device = RenderDevice::Get();
+        if (instanceData.size() > m_InstanceBufferCapacity) {
+            m_InstanceBufferCapacity = glm::max(instanceData.size(), m_InstanceBufferCapacity * 2);
+        }
+        device.ReallocateBuffer(BufferTarget::Vertex, m_InstanceBuffer, m_InstanceBufferCapacity * sizeof(glm::mat4), BufferUsage::Stream);
+        device.UpdateBuffer(BufferTarget::Vertex, m_InstanceBuffer, 0, instanceData.size() * sizeof(glm::mat4), instanceData.data());
     }
 
-    void Renderer::AddLight(const LightData& light) {
-        if (m_Lights.size() < 8) {
-            m_Lights.push_back(light);
+    Shader& Renderer::BindMaterial(const Material& material, bool instanced) {
+        Shader* shader = material.GetShader() ? material.GetShader().get() : m_DefaultShader.get();
+        if (instanced) {
+            shader = shader->GetInstancedVariant();
+        }
+
+        if (&material != m_BoundMaterial || shader != m_BoundShader) {
+            material.Bind(*shader, m_State);
+            m_BoundMaterial = &material;
+            m_BoundShader = shader;
+            m_SubmitStats.materialBinds++;
         }
+        return *shader;
     }
 
-    void Renderer::ClearLights() {
-        m_Lights.clear();
+    void Renderer::InvalidateState() {
+        m_State.Invalidate();
+        m_BoundMaterial = nullptr;
+        m_BoundShader = nullptr;
     }
 
-    void Renderer::DrawMesh(Mesh& mesh, Material& material, const glm::mat4& transform) {
-        material.Bind();
+    void Renderer::RestoreDefaultState() {
+        // What Init set up, and what code drawing outside the renderer expects
+        m_State.SetDepthWrite(true);
+        m_State.SetBlend(false);
+        m_State.SetCullFace(true);
+        m_State.UseProgram(0);
+        m_State.BindVertexArray(0);
+        m_BoundMaterial = nullptr;
+        m_BoundShader = nullptr;
+    }
 
-        Shader* shader = material.GetShader().get();
-        if (!shader) {
-            shader = m_DefaultShader.get();
-            shader->Bind();
-        }
+    void Renderer::DrawInstanced(const MeshDrawInfo& mesh, const Material& material, uint32_t firstInstance, uint32_t count) {
+        BindMaterial(material, true);
+        mesh.DrawInstanced(m_State, m_InstanceBuffer, firstInstance * sizeof(glm::mat4), count);
 
-        shader->SetMat4("u_Model", transform);
-        shader->SetMat4("u_View", m_Camera.GetViewMatrix());
-        shader->SetMat4("u_Projection", m_Camera.GetProjectionMatrix());
-        shader->SetVec3("u_CameraPos", m_Camera.GetPosition());
+        m_SubmitStats.drawCalls++;
+        m_SubmitStats.instancedDrawCalls++;
+        m_SubmitStats.instancedObjects += count;
+        m_SubmitStats.triangles += mesh.elementCount / 3 * count;
+    }
 
-        SetupLightUniforms(*shader);
+    void Renderer::SetCamera(const Camera& camera) {
+        m_Camera = camera;
+    }
 
-        mesh.Draw();
+    void Renderer::Submit(const Mesh& mesh, const Material& material, const glm::mat4& transform, uint8_t layer) {
+        m_CommandLists[0].Submit(mesh, material, transform, layer);
+    }
 
-        material.Unbind();
+    void Renderer::Submit(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Material>& material,
+                          const glm::mat4& transform, uint8_t layer) {
+        if (!mesh || !material) return;
+        Submit(*mesh, *material, transform, layer);
+    }
 
-        m_Stats.drawCalls++;
-        m_Stats.triangles += mesh.GetIndexCount() / 3;
+    void Renderer::SubmitParallel(uint32_t count, uint32_t batchSize, const RenderSubmitFunc& build) {
+        if (count == 0) return;
+        batchSize = glm::max(batchSize, 1u);
+
+        // Lists are set up before any job runs, so no job resizes the vector under another
+        uint32_t firstList = m_UsedCommandLists;
+        uint32_t batchCount = (count + batchSize - 1) / batchSize;
+        if (m_CommandLists.size() < firstList + batchCount) {
+            m_CommandLists.resize(firstList + batchCount);
+        }
+        uint32_t defaultShaderSortID = GetDefaultShaderSortID();
+        for (uint32_t i = 0; i < batchCount; i++) {
+            m_CommandLists[firstList + i].Reset(defaultShaderSortID);
+        }
+        m_UsedCommandLists += batchCount;
+
+        // Without a job system the whole range arrives as one call and lands in the first list,
+        // which keeps the same order
+        ParallelFor(m_JobSystem, count, batchSize, [&](uint32_t begin, uint32_t end) {
+            build(m_CommandLists[firstList + begin / batchSize], begin, end);
+        });
     }
 
-    void Renderer::SetupLightUniforms(Shader& shader) {
-        shader.SetInt("u_NumLights", static_cast<int>(m_Lights.size()));
+    void Renderer::AddLight(const LightData& light) {
+        m_Lights.push_back(light);
+    }
 
-        for (size_t i = 0; i < m_Lights.size() && i < 8; i++) {
-            std::string prefix = "u_LightPositions[" + std::to_string(i) + "]";
-            shader.SetVec3(prefix, m_Lights[i].position);
+    void Renderer::ClearLights() {
+        m_Lights.clear();
+    }
 
-            prefix = "u_LightDirections[" + std::to_string(i) + "]";
-            shader.SetVec3(prefix, m_Lights[i].direction);
+    void Renderer::DrawMesh(Mesh& mesh, Material& material, const glm::mat4& transform) {
+        MeshDrawInfo info = mesh.GetDrawInfo();
+        InvalidateState();
+        DrawSingle(info, material, transform);
+        RestoreDefaultState();
 
-            prefix = "u_LightColors[" + std::to_string(i) + "]";
-            shader.SetVec3(prefix, m_Lights[i].color);
+        m_Stats.drawCalls++;
+        m_Stats.triangles += info.elementCount / 3;
+        m_Stats.materialBinds++;
+    }
 
-            prefix = "u_LightIntensities[" + std::to_string(i) + "]";
-            shader.SetFloat(prefix, m_Lights[i].intensity);
+    void Renderer::DrawSingle(const MeshDrawInfo& mesh, const Material& material, const glm::mat4& transform) {
+        Shader& shader = BindMaterial(material, false);
+        shader.SetMat4(ShaderUniform::Model, transform);
+        mesh.Draw(m_State);
 
-            prefix = "u_LightTypes[" + std::to_string(i) + "]";
-            shader.SetInt(prefix, static_cast<int>(m_Lights[i].type));
+        m_SubmitStats.drawCalls++;
+        m_SubmitStats.triangles += mesh.elementCount / 3;
+    }
+
+    void Renderer::UploadFrameUniforms(const FramePacket& packet) {
+        CameraUniforms camera;
+        camera.view = packet.view;
+        camera.projection = packet.projection;
+        camera.cameraPosition = packet.cameraPosition;
+        camera.padding = 0.0f;
+        m_CameraUniforms->SetData(&camera, sizeof(camera));
+
+        LightUniforms grid;
+        grid.clusterGrid = glm::uvec4(LightClusters::GRID_X, LightClusters::GRID_Y, LightClusters::GRID_Z,
+                                      packet.directionalLightCount);
+        grid.clusterDepth = glm::vec4(packet.clusterSliceScale, packet.clusterSliceBias, 0.0f, 0.0f);
+        m_LightUniforms->SetData(&grid, sizeof(grid));
+
+        m_StoredLights.resize(packet.lights.size() * sizeof(StoredLight) / sizeof(glm::vec4));
+        StoredLight* stored = reinterpret_cast<StoredLight*>(m_StoredLights.data());
+        for (size_t i = 0; i < packet.lights.size(); i++) {
+            const LightData& light = packet.lights[i];
+            stored[i].position = glm::vec4(light.position, static_cast<float>(light.type));
+            stored[i].direction = glm::vec4(light.direction, light.range);
+            stored[i].color = glm::vec4(light.color, light.intensity);
+            stored[i].spot = glm::vec4(std::cos(glm::radians(light.spotAngle)),
+                                       std::cos(glm::radians(glm::min(light.innerSpotAngle, light.spotAngle))),
+                                       light.attenuation, 0.0f);
         }
+
+        m_LightBuffer->SetData(m_StoredLights.data(), m_StoredLights.size() * sizeof(glm::vec4));
+        m_ClusterBuffer->SetData(packet.clusters.data(), packet.clusters.size() * sizeof(glm::uvec2));
+        m_LightIndexBuffer->SetData(packet.clusterLightIndices.data(), packet.clusterLightIndices.size() * sizeof(uint32_t));
     }
 
     void Renderer::ResetStats() {
         m_Stats.drawCalls = 0;
         m_Stats.triangles = 0;
+        m_Stats.visibleObjects = 0;
+        m_Stats.culledObjects = 0;
+        m_Stats.cullTimeMs = 0.0f;
+        m_Stats.sortTimeMs = 0.0f;
+        m_Stats.batchTimeMs = 0.0f;
+        m_Stats.lightTimeMs = 0.0f;
+        m_Stats.submitTimeMs = 0.0f;
+        m_Stats.instancedDrawCalls = 0;
+        m_Stats.instancedObjects = 0;
+        m_Stats.materialBinds = 0;
+        m_Stats.stateChanges = 0;
+        m_Stats.stateChangesAvoided = 0;
+        m_Stats.lights = 0;
+        m_Stats.clusteredLights = 0;
+        m_Stats.lightAssignments = 0;
     }
 
 }
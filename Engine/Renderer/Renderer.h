@@ -2,7 +2,13 @@
 
 #include "RenderQueue.h"
 #include "Camera.h"
+#include "Frustum.h"
+#include "RenderStateCache.h"
+#include "FramePacket.h"
+#include "LightClusters.h"
+#include <functional>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <glm/glm.hpp>
 
@@ -11,18 +17,12 @@ namespace Xi {
     class Shader;
     class Mesh;
     class Material;
+    class UniformBuffer;
+    class StorageBuffer;
+    class JobSystem;
 
-    struct LightData {
-        enum class Type { Directional, Point, Spot };
-
-        Type type = Type::Directional;
-        glm::vec3 position = glm::vec3(0.0f);
-        glm::vec3 direction = glm::vec3(0.0f, -1.0f, 0.0f);
-        glm::vec3 color = glm::vec3(1.0f);
-        float intensity = 1.0f;
-        float range = 10.0f;
-        float spotAngle = 45.0f;
-    };
+    // Records the commands for items [begin, end) of a parallel submission
+    using RenderSubmitFunc = std::function<void(RenderCommandList& list, uint32_t begin, uint32_t end)>;
 
     class Renderer {
     public:
@@ -33,18 +33,44 @@ namespace Xi {
         void Shutdown();
 
         void BeginFrame();
+
+        // Builds the frame packet and draws it
         void EndFrame();
 
+        // Builds the frame into packet and leaves drawing it to ExecutePacket, usually on the
+        // render thread. The draw stats become those of the frame the packet last carried.
+        void EndFrame(FramePacket& packet);
+
+        // Uploads the packet's instance data, camera and lights and makes its draw calls. Uses
+        // only render-side state, so it can run while the game thread builds the next packet.
+        void ExecutePacket(FramePacket& packet);
+
         void SetCamera(const Camera& camera);
         const Camera& GetCamera() const { return m_Camera; }
         Camera& GetCamera() { return m_Camera; }
 
-        void Submit(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, const glm::mat4& transform);
+        // Used for parallel submission, culling and key building; null does it all on the calling thread
+        void SetJobSystem(JobSystem* jobs) { m_JobSystem = jobs; }
+
+        // Queued for EndFrame, which drops it if its bounds are outside the camera's frustum.
+        // Lower layers draw first; within a layer opaque draws come before transparent ones.
+        // The mesh and material are not retained and must outlive EndFrame.
+        void Submit(const Mesh& mesh, const Material& material, const glm::mat4& transform, uint8_t layer = 0);
+        void Submit(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Material>& material,
+                    const glm::mat4& transform, uint8_t layer = 0);
 
+        // Calls build over [0, count) in batches of batchSize on the job system, each batch
+        // recording into a list of its own. build runs on worker threads, so it may only read
+        // shared data. Lists are merged in batch order after the commands from Submit, so the
+        // frame is the same whatever the thread count.
+        void SubmitParallel(uint32_t count, uint32_t batchSize, const RenderSubmitFunc& build);
+
+        // Any number of lights; EndFrame bins the point and spot lights into clusters
         void AddLight(const LightData& light);
         void ClearLights();
 
-        // Immediate mode drawing
+        // Immediate mode drawing. Uses the camera and lights last uploaded by EndFrame. Draws on
+        // the calling thread, so not while a render thread is drawing packets.
         void DrawMesh(Mesh& mesh, Material& material, const glm::mat4& transform);
 
         // Default resources
@@ -56,22 +82,80 @@ namespace Xi {
         struct Stats {
             uint32_t drawCalls = 0;
             uint32_t triangles = 0;
+            uint32_t visibleObjects = 0;  // Submitted and inside the frustum
+            uint32_t culledObjects = 0;   // Submitted and outside it
+            float cullTimeMs = 0.0f;    // CPU time in EndFrame's stages
+            float sortTimeMs = 0.0f;
+            float batchTimeMs = 0.0f;   // Building the packet's draws
+            float lightTimeMs = 0.0f;   // Binning lights into clusters
+            float submitTimeMs = 0.0f;  // ExecutePacket: instance and uniform uploads and draw calls
+            uint32_t instancedDrawCalls = 0;  // Included in drawCalls
+            uint32_t instancedObjects = 0;    // Objects drawn by those calls
+            uint32_t materialBinds = 0;       // Consecutive draws with the same material bind it once
+            uint32_t stateChanges = 0;        // Program, vertex array, texture and fixed-function calls made
+            uint32_t stateChangesAvoided = 0; // Calls skipped because the state was already set
+            uint32_t lights = 0;              // Added this frame
+            uint32_t clusteredLights = 0;     // Point and spot lights in view, binned into clusters
+            uint32_t lightAssignments = 0;    // Light entries over all clusters
         };
         const Stats& GetStats() const { return m_Stats; }
         void ResetStats();
 
     private:
         void CreateDefaultShaders();
-        void SetupLightUniforms(Shader& shader);
+        void ResetCommandLists();
+        void CullSubmissions();
+        void BuildPacket(FramePacket& packet);
+        void BuildDraws(FramePacket& packet);
+        void BuildLights(FramePacket& packet);
+        uint32_t AddPacketMaterial(FramePacket& packet, const Material& material);
+        void AddSubmitStats(const FramePacket::SubmitStats& stats);
+        void UploadInstances(const std::vector<glm::mat4>& instanceData);
+        void UploadFrameUniforms(const FramePacket& packet);
+        void DrawInstanced(const MeshDrawInfo& mesh, const Material& material, uint32_t firstInstance, uint32_t count);
+        void DrawSingle(const MeshDrawInfo& mesh, const Material& material, const glm::mat4& transform);
+        Shader& BindMaterial(const Material& material, bool instanced);
+        uint32_t GetDefaultShaderSortID() const;
+        void InvalidateState();
+        void RestoreDefaultState();
 
         Camera m_Camera;
         RenderQueue m_RenderQueue;
+
+        // Submitted this frame, before culling. The first list takes Submit; the rest are
+        // handed to SubmitParallel's batches. Kept across frames to reuse their storage.
+        std::vector<RenderCommandList> m_CommandLists;
+        uint32_t m_UsedCommandLists = 0;
+        JobSystem* m_JobSystem = nullptr;
+
+        // The packet EndFrame() builds and draws itself
+        FramePacket m_Packet;
+        std::unordered_map<const Material*, uint32_t> m_PacketMaterials;  // Into the packet being built
+
         std::vector<LightData> m_Lights;
+        LightClusters m_LightClusters;
 
         std::shared_ptr<Shader> m_DefaultShader;
         std::shared_ptr<Shader> m_UnlitShader;
         std::shared_ptr<Shader> m_SpriteShader;
 
+        // Render side: only ExecutePacket and immediate drawing use these
+        uint32_t m_InstanceBuffer = 0;
+        size_t m_InstanceBufferCapacity = 0;  // In matrices
+
+        // Camera and lights, uploaded once per frame and shared by every draw
+        std::unique_ptr<UniformBuffer> m_CameraUniforms;
+        std::unique_ptr<UniformBuffer> m_LightUniforms;
+        std::unique_ptr<StorageBuffer> m_LightBuffer;
+        std::unique_ptr<StorageBuffer> m_ClusterBuffer;
+        std::unique_ptr<StorageBuffer> m_LightIndexBuffer;
+        std::vector<glm::vec4> m_StoredLights;  // Four per light, in the storage block's layout
+
+        RenderStateCache m_State;
+        const Material* m_BoundMaterial = nullptr;
+        const Shader* m_BoundShader = nullptr;
+        FramePacket::SubmitStats m_SubmitStats;
+
         Stats m_Stats;
     };
 
@@ -1,18 +1,38 @@
 #include "Shader.h"
+#include "RenderQueue.h"
+#include "RenderDevice.h"
 #include "../Core/Log.h"
 
-#include <GL/glew.h>
-#include <glm/gtc/type_ptr.hpp>
 #include <fstream>
 #include <sstream>
 
 namespace Xi {
 
-    Shader::Shader() = default;
+    const char* GetUniformName(ShaderUniform uniform) {
+        static const char* const s_Names[] = {
+            "u_Model",
+            "u_AlbedoColor",
+            "u_Metallic",
+            "u_Roughness",
+            "u_AO",
+            "u_Emissive",
+            "u_AlbedoMap",
+            "u_HasAlbedoMap",
+            "u_NormalMap",
+            "u_HasNormalMap",
+        };
+        static_assert(sizeof(s_Names) / sizeof(s_Names[0]) == static_cast<size_t>(ShaderUniform::Count),
+                      "Every ShaderUniform needs a name");
+        return s_Names[static_cast<size_t>(uniform)];
+    }
+
+    Shader::Shader() : m_SortID(NextRenderSortID()) {
+        m_UniformLocations.fill(-1);
+    }
 
     Shader::~Shader() {
         if (m_Program) {
-            glDeleteProgram(m_Program);
+            RenderDevice::Get().DeleteProgram(m_Program);
         }
     }
 
@@ -28,90 +48,71 @@ namespace Xi {
     }
 
     bool Shader::LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource) {
-        uint32_t vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
-        uint32_t fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
-
-        if (!vertexShader || !fragmentShader) {
-            if (vertexShader) glDeleteShader(vertexShader);
-            if (fragmentShader) glDeleteShader(fragmentShader);
-            return false;
-        }
-
-        m_Program = glCreateProgram();
-        glAttachShader(m_Program, vertexShader);
-        glAttachShader(m_Program, fragmentShader);
-        glLinkProgram(m_Program);
-
-        int success;
-        glGetProgramiv(m_Program, GL_LINK_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetProgramInfoLog(m_Program, 512, nullptr, infoLog);
-            XI_LOG_ERROR("Shader link error: " + std::string(infoLog));
-            glDeleteProgram(m_Program);
-            m_Program = 0;
+        RenderDevice& device = RenderDevice::Get();
+        if (m_Program) {
+            device.DeleteProgram(m_Program);
         }
 
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
+        m_Program = device.CreateProgram(vertexSource, fragmentSource);
+        ResolveUniformLocations();
 
         return m_Program != 0;
     }
 
     void Shader::Bind() const {
-        glUseProgram(m_Program);
+        RenderDevice::Get().UseProgram(m_Program);
     }
 
     void Shader::Unbind() const {
-        glUseProgram(0);
+        RenderDevice::Get().UseProgram(0);
+    }
+
+    void Shader::SetInt(ShaderUniform uniform, int value) {
+        RenderDevice::Get().SetUniform(GetUniformLocation(uniform), value);
+    }
+
+    void Shader::SetFloat(ShaderUniform uniform, float value) {
+        RenderDevice::Get().SetUniform(GetUniformLocation(uniform), value);
+    }
+
+    void Shader::SetVec3(ShaderUniform uniform, const glm::vec3& value) {
+        RenderDevice::Get().SetUniform(GetUniformLocation(uniform), value);
+    }
+
+    void Shader::SetVec4(ShaderUniform uniform, const glm::vec4& value) {
+        RenderDevice::Get().SetUniform(GetUniformLocation(uniform), value);
+    }
+
+    void Shader::SetMat4(ShaderUniform uniform, const glm::mat4& value) {
+        RenderDevice::Get().SetUniform(GetUniformLocation(uniform), value);
     }
 
     void Shader::SetInt(const std::string& name, int value) {
-        glUniform1i(GetUniformLocation(name), value);
+        RenderDevice::Get().SetUniform(GetUniformLocation(name), value);
     }
 
     void Shader::SetFloat(const std::string& name, float value) {
-        glUniform1f(GetUniformLocation(name), value);
+        RenderDevice::Get().SetUniform(GetUniformLocation(name), value);
     }
 
     void Shader::SetVec2(const std::string& name, const glm::vec2& value) {
-        glUniform2fv(GetUniformLocation(name), 1, glm::value_ptr(value));
+        RenderDevice::Get().SetUniform(GetUniformLocation(name), value);
     }
 
     void Shader::SetVec3(const std::string& name, const glm::vec3& value) {
-        glUniform3fv(GetUniformLocation(name), 1, glm::value_ptr(value));
+        RenderDevice::Get().SetUniform(GetUniformLocation(name), value);
     }
 
     void Shader::SetVec4(const std::string& name, const glm::vec4& value) {
-        glUniform4fv(GetUniformLocation(name), 1, glm::value_ptr(value));
+        RenderDevice::Get().SetUniform(GetUniformLocation(name), value);
     }
 
     void Shader::SetMat3(const std::string& name, const glm::mat3& value) {
-        glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+        RenderDevice::Get().SetUniform(GetUniformLocation(name), value);
     }
 
     void Shader::SetMat4(const std::string& name, const glm::mat4& value) {
-        glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
-    }
-
-    uint32_t Shader::CompileShader(uint32_t type, const std::string& source) {
-        uint32_t shader = glCreateShader(type);
-        const char* src = source.c_str();
-        glShaderSource(shader, 1, &src, nullptr);
-        glCompileShader(shader);
-
-        int success;
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-        if (!success) {
-            char infoLog[512];
-            glGetShaderInfoLog(shader, 512, nullptr, infoLog);
-            std::string shaderType = (type == GL_VERTEX_SHADER) ? "Vertex" : "Fragment";
-            XI_LOG_ERROR(shaderType + " shader compile error: " + std::string(infoLog));
-            glDeleteShader(shader);
-            return 0;
-        }
-
-        return shader;
+        RenderDevice::Get().SetUniform(GetUniformLocation(name), value);
     }
 
     int Shader::GetUniformLocation(const std::string& name) {
@@ -120,11 +121,19 @@ namespace Xi {
             return it->second;
         }
 
-        int location = glGetUniformLocation(m_Program, name.c_str());
+        int location = RenderDevice::Get().GetUniformLocation(m_Program, name.c_str());
         m_UniformCache[name] = location;
         return location;
     }
 
+    void Shader::ResolveUniformLocations() {
+        m_UniformCache.clear();
+        RenderDevice& device = RenderDevice::Get();
+        for (size_t i = 0; i < m_UniformLocations.size(); i++) {
+            m_UniformLocations[i] = m_Program ? device.GetUniformLocation(m_Program, GetUniformName(static_cast<ShaderUniform>(i))) : -1;
+        }
+    }
+
     std::string Shader::ReadFile(const std::string& path) {
         std::ifstream file(path);
         if (!file.is_open()) {
@@ -1,11 +1,33 @@
 #pragma once
 
 #include <string>
+#include <array>
+#include <memory>
+#include <cstdint>
 #include <unordered_map>
 #include <glm/glm.hpp>
 
 namespace Xi {
 
+    // Uniforms the engine sets on every draw. Their locations are looked up once when the
+    // program links, so setting one is an array index instead of a string hash.
+    enum class ShaderUniform : uint8_t {
+        Model,
+        AlbedoColor,
+        Metallic,
+        Roughness,
+        AO,
+        Emissive,
+        AlbedoMap,
+        HasAlbedoMap,
+        NormalMap,
+        HasNormalMap,
+        Count
+    };
+
+    // The GLSL name, e.g. "u_Model"
+    const char* GetUniformName(ShaderUniform uniform);
+
     class Shader {
     public:
         Shader();
@@ -19,8 +41,21 @@ namespace Xi {
 
         uint32_t GetProgram() const { return m_Program; }
         bool IsValid() const { return m_Program != 0; }
+        uint32_t GetSortID() const { return m_SortID; }
+
+        // The same shader compiled with XI_INSTANCED defined, taking the model matrix from the
+        // per-instance attribute at location 4. The renderer uses it for batched draws.
+        void SetInstancedVariant(std::shared_ptr<Shader> variant) { m_InstancedVariant = std::move(variant); }
+        Shader* GetInstancedVariant() const { return m_InstancedVariant.get(); }
+
+        // Engine uniforms, resolved at link time. Shaders without the uniform ignore the call.
+        void SetInt(ShaderUniform uniform, int value);
+        void SetFloat(ShaderUniform uniform, float value);
+        void SetVec3(ShaderUniform uniform, const glm::vec3& value);
+        void SetVec4(ShaderUniform uniform, const glm::vec4& value);
+        void SetMat4(ShaderUniform uniform, const glm::mat4& value);
 
-        // Uniform setters
+        // Uniform setters by name, for user shaders; cached after the first lookup
         void SetInt(const std::string& name, int value);
         void SetFloat(const std::string& name, float value);
         void SetVec2(const std::string& name, const glm::vec2& value);
@@ -30,11 +65,15 @@ namespace Xi {
         void SetMat4(const std::string& name, const glm::mat4& value);
 
     private:
-        uint32_t CompileShader(uint32_t type, const std::string& source);
         int GetUniformLocation(const std::string& name);
+        int GetUniformLocation(ShaderUniform uniform) const { return m_UniformLocations[static_cast<size_t>(uniform)]; }
+        void ResolveUniformLocations();
         std::string ReadFile(const std::string& path);
 
         uint32_t m_Program = 0;
+        uint32_t m_SortID = 0;
+        std::shared_ptr<Shader> m_InstancedVariant;
+        std::array<int, static_cast<size_t>(ShaderUniform::Count)> m_UniformLocations;
         mutable std::unordered_map<std::string, int> m_UniformCache;
     };
 
@@ -0,0 +1,36 @@
+#include "StorageBuffer.h"
+#include "RenderDevice.h"
+
+namespace Xi {
+
+    // Never zero, so the binding always has a buffer with storage behind it
+    static constexpr size_t MIN_CAPACITY = 256;
+
+    StorageBuffer::StorageBuffer(uint32_t binding)
+        : m_Binding(binding), m_Capacity(MIN_CAPACITY) {
+        RenderDevice& device = RenderDevice::Get();
+        m_BufferID = device.CreateBuffer(BufferTarget::Storage, m_Capacity, nullptr, BufferUsage::Stream);
+        device.BindBufferBase(BufferTarget::Storage, m_Binding, m_BufferID);
+    }
+
+    StorageBuffer::~StorageBuffer() {
+        if (m_BufferID) RenderDevice::Get().DeleteBuffer(m_BufferID);
+    }
+
+    void StorageBuffer::SetData(const void* data, size_t size) {
+        RenderDevice& device = RenderDevice::Get();
+        if (size > m_Capacity) {
+            m_Capacity = size > m_Capacity * 2 ? size : m_Capacity * 2;
+        }
+
+        // Orphan the previous frame's storage so the driver doesn't wait on draws still reading it
+        device.ReallocateBuffer(BufferTarget::Storage, m_BufferID, m_Capacity, BufferUsage::Stream);
+        if (size > 0) {
+            device.UpdateBuffer(BufferTarget::Storage, m_BufferID, 0, size, data);
+        }
+
+        // Keep the binding point ours even if something else used it since
+        device.BindBufferBase(BufferTarget::Storage, m_Binding, m_BufferID);
+    }
+
+}
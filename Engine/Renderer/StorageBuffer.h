@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Xi {
+
+    // Binding points of the engine's shader storage blocks, declared with
+    // layout(std430, binding = N) in shaders. Separate from the uniform block bindings.
+    namespace StorageBinding {
+        constexpr uint32_t Lights = 0;
+        constexpr uint32_t Clusters = 1;
+        constexpr uint32_t LightIndices = 2;
+    }
+
+    // A shader storage buffer attached to one binding point, for arrays whose length changes
+    // from frame to frame. Its contents are replaced wholesale, growing the storage as needed.
+    class StorageBuffer {
+    public:
+        explicit StorageBuffer(uint32_t binding);
+        ~StorageBuffer();
+
+        StorageBuffer(const StorageBuffer&) = delete;
+        StorageBuffer& operator=(const StorageBuffer&) = delete;
+
+        void SetData(const void* data, size_t size);
+
+        uint32_t GetBinding() const { return m_Binding; }
+        size_t GetCapacity() const { return m_Capacity; }
+
+    private:
+        uint32_t m_BufferID = 0;
+        uint32_t m_Binding = 0;
+        size_t m_Capacity = 0;
+    };
+
+}
@@ -1,35 +1,25 @@
 #include "Texture.h"
+#include "RenderDevice.h"
 #include "../Core/Log.h"
 
-#include <GL/glew.h>
-
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 namespace Xi {
 
-    static GLenum GetGLFilter(TextureFilter filter) {
-        switch (filter) {
-            case TextureFilter::Nearest: return GL_NEAREST;
-            case TextureFilter::Linear:  return GL_LINEAR;
+    static TextureFormat GetFormat(int channels) {
+        switch (channels) {
+            case 1: return TextureFormat::R8;
+            case 3: return TextureFormat::RGB8;
         }
-        return GL_LINEAR;
-    }
-
-    static GLenum GetGLWrap(TextureWrap wrap) {
-        switch (wrap) {
-            case TextureWrap::Repeat:         return GL_REPEAT;
-            case TextureWrap::ClampToEdge:    return GL_CLAMP_TO_EDGE;
-            case TextureWrap::MirroredRepeat: return GL_MIRRORED_REPEAT;
-        }
-        return GL_REPEAT;
+        return TextureFormat::RGBA8;
     }
 
     Texture::Texture() = default;
 
     Texture::~Texture() {
         if (m_TextureID) {
-            glDeleteTextures(1, &m_TextureID);
+            RenderDevice::Get().DeleteTexture(m_TextureID);
         }
     }
 
@@ -44,30 +34,12 @@ namespace Xi {
             return false;
         }
 
-        GLenum internalFormat = GL_RGBA8;
-        GLenum dataFormat = GL_RGBA;
-
-        if (m_Channels == 1) {
-            internalFormat = GL_R8;
-            dataFormat = GL_RED;
-        } else if (m_Channels == 3) {
-            internalFormat = GL_RGB8;
-            dataFormat = GL_RGB;
-        } else if (m_Channels == 4) {
-            internalFormat = GL_RGBA8;
-            dataFormat = GL_RGBA;
-        }
-
-        glGenTextures(1, &m_TextureID);
-        glBindTexture(GL_TEXTURE_2D, m_TextureID);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Width, m_Height, 0, dataFormat, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        TextureDesc desc;
+        desc.width = static_cast<uint32_t>(m_Width);
+        desc.height = static_cast<uint32_t>(m_Height);
+        desc.format = GetFormat(m_Channels);
+        desc.generateMipmaps = true;
+        m_TextureID = RenderDevice::Get().CreateTexture(desc, data);
 
         stbi_image_free(data);
 
@@ -80,46 +52,26 @@ namespace Xi {
         m_Height = spec.height;
         m_Channels = spec.channels;
 
-        GLenum internalFormat = GL_RGBA8;
-        GLenum dataFormat = GL_RGBA;
-
-        if (spec.channels == 1) {
-            internalFormat = GL_R8;
-            dataFormat = GL_RED;
-        } else if (spec.channels == 3) {
-            internalFormat = GL_RGB8;
-            dataFormat = GL_RGB;
-        }
-
-        glGenTextures(1, &m_TextureID);
-        glBindTexture(GL_TEXTURE_2D, m_TextureID);
-
-        GLenum minFilter = GetGLFilter(spec.minFilter);
-        if (spec.generateMipmaps && spec.minFilter == TextureFilter::Linear) {
-            minFilter = GL_LINEAR_MIPMAP_LINEAR;
-        }
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GetGLFilter(spec.magFilter));
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GetGLWrap(spec.wrapS));
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GetGLWrap(spec.wrapT));
-
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Width, m_Height, 0, dataFormat, GL_UNSIGNED_BYTE, data);
-
-        if (spec.generateMipmaps) {
-            glGenerateMipmap(GL_TEXTURE_2D);
-        }
+        TextureDesc desc;
+        desc.width = static_cast<uint32_t>(spec.width);
+        desc.height = static_cast<uint32_t>(spec.height);
+        desc.format = GetFormat(spec.channels);
+        desc.minFilter = spec.minFilter;
+        desc.magFilter = spec.magFilter;
+        desc.wrapS = spec.wrapS;
+        desc.wrapT = spec.wrapT;
+        desc.generateMipmaps = spec.generateMipmaps;
+        m_TextureID = RenderDevice::Get().CreateTexture(desc, data);
 
         return true;
     }
 
     void Texture::Bind(uint32_t slot) const {
-        glActiveTexture(GL_TEXTURE0 + slot);
-        glBindTexture(GL_TEXTURE_2D, m_TextureID);
+        RenderDevice::Get().BindTexture(slot, m_TextureID);
     }
 
-    void Texture::Unbind() const {
-        glBindTexture(GL_TEXTURE_2D, 0);
+    void Texture::Unbind(uint32_t slot) const {
+        RenderDevice::Get().BindTexture(slot, 0);
     }
 
 }
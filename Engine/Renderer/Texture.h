@@ -36,7 +36,7 @@ namespace Xi {
         bool Create(const TextureSpec& spec, const unsigned char* data = nullptr);
 
         void Bind(uint32_t slot = 0) const;
-        void Unbind() const;
+        void Unbind(uint32_t slot = 0) const;
 
         uint32_t GetID() const { return m_TextureID; }
         int GetWidth() const { return m_Width; }
@@ -0,0 +1,27 @@
+#include "UniformBuffer.h"
+#include "RenderDevice.h"
+
+namespace Xi {
+
+    UniformBuffer::UniformBuffer(size_t size, uint32_t binding)
+        : m_Binding(binding), m_Size(size) {
+        RenderDevice& device = RenderDevice::Get();
+        m_BufferID = device.CreateBuffer(BufferTarget::Uniform, size, nullptr, BufferUsage::Dynamic);
+        device.BindBufferBase(BufferTarget::Uniform, m_Binding, m_BufferID);
+    }
+
+    UniformBuffer::~UniformBuffer() {
+        if (m_BufferID) RenderDevice::Get().DeleteBuffer(m_BufferID);
+    }
+
+    void UniformBuffer::SetData(const void* data, size_t size) {
+        if (size > m_Size) size = m_Size;
+
+        RenderDevice& device = RenderDevice::Get();
+        device.UpdateBuffer(BufferTarget::Uniform, m_BufferID, 0, size, data);
+
+        // Keep the binding point ours even if something else used it since
+        device.BindBufferBase(BufferTarget::Uniform, m_Binding, m_BufferID);
+    }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Xi {
+
+    // Binding points of the engine's uniform blocks, declared with layout(binding = N) in shaders
+    namespace UniformBinding {
+        constexpr uint32_t Camera = 0;
+        constexpr uint32_t Lights = 1;
+    }
+
+    // A fixed-size uniform buffer attached to one binding point. Its contents are replaced
+    // wholesale, once per frame.
+    class UniformBuffer {
+    public:
+        UniformBuffer(size_t size, uint32_t binding);
+        ~UniformBuffer();
+
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+        // size must not exceed the buffer's
+        void SetData(const void* data, size_t size);
+
+        uint32_t GetBinding() const { return m_Binding; }
+        size_t GetSize() const { return m_Size; }
+
+    private:
+        uint32_t m_BufferID = 0;
+        uint32_t m_Binding = 0;
+        size_t m_Size = 0;
+    };
+
+}
@@ -8,10 +8,13 @@
 #include "../ECS/Components/Collider.h"
 #include "../ECS/Components/RigidBody.h"
 #include "../ECS/Components/AudioSource.h"
+#include "../Physics/TriangleMesh.h"
+#include "../Physics/Heightfield.h"
 #include "../Core/Log.h"
 
 #include <json.hpp>
 #include <fstream>
+#include <unordered_map>
 
 using json = nlohmann::json;
 
@@ -42,6 +45,39 @@ namespace Xi {
         return glm::vec4(j[0].get<float>(), j[1].get<float>(), j[2].get<float>(), j[3].get<float>());
     }
 
+    static json TriangleMeshToJson(const TriangleMesh& mesh) {
+        json vertices = json::array();
+        for (const glm::vec3& v : mesh.GetVertices()) {
+            vertices.push_back(v.x);
+            vertices.push_back(v.y);
+            vertices.push_back(v.z);
+        }
+        return { {"vertices", vertices}, {"indices", mesh.GetIndices()} };
+    }
+
+    static std::shared_ptr<TriangleMesh> JsonToTriangleMesh(const json& j) {
+        std::vector<float> flat = j["vertices"].get<std::vector<float>>();
+        std::vector<glm::vec3> vertices;
+        for (size_t i = 0; i + 2 < flat.size(); i += 3) {
+            vertices.emplace_back(flat[i], flat[i + 1], flat[i + 2]);
+        }
+        return std::make_shared<TriangleMesh>(vertices, j["indices"].get<std::vector<uint32_t>>());
+    }
+
+    static json HeightfieldToJson(const Heightfield& heightfield) {
+        return {
+            {"columns", heightfield.GetColumns()},
+            {"rows", heightfield.GetRows()},
+            {"spacing", heightfield.GetSpacing()},
+            {"heights", heightfield.GetHeights()}
+        };
+    }
+
+    static std::shared_ptr<Heightfield> JsonToHeightfield(const json& j) {
+        return std::make_shared<Heightfield>(j["columns"].get<uint32_t>(), j["rows"].get<uint32_t>(),
+                                             j["heights"].get<std::vector<float>>(), j["spacing"].get<float>());
+    }
+
     SceneSerializer::SceneSerializer(World& world)
         : m_World(world) {}
 
@@ -51,6 +87,13 @@ namespace Xi {
         scene["name"] = "Scene";
         scene["entities"] = json::array();
 
+        // Collision geometry is written once and referenced by index, so colliders that
+        // shared it still do after loading
+        scene["triangleMeshes"] = json::array();
+        scene["heightfields"] = json::array();
+        std::unordered_map<const TriangleMesh*, size_t> meshIndices;
+        std::unordered_map<const Heightfield*, size_t> heightfieldIndices;
+
         for (const auto& [entity, info] : m_World.GetEntities()) {
             json entityJson;
             entityJson["id"] = entity;
@@ -110,6 +153,22 @@ namespace Xi {
                     {"layer", c.layer},
                     {"mask", c.mask}
                 };
+
+                json& colliderJson = entityJson["components"]["Collider"];
+                if (c.triangleMesh) {
+                    auto [it, added] = meshIndices.try_emplace(c.triangleMesh.get(), meshIndices.size());
+                    if (added) scene["triangleMeshes"].push_back(TriangleMeshToJson(*c.triangleMesh));
+                    colliderJson["triangleMesh"] = it->second;
+                }
+                if (c.heightfield) {
+                    auto [it, added] = heightfieldIndices.try_emplace(c.heightfield.get(), heightfieldIndices.size());
+                    if (added) scene["heightfields"].push_back(HeightfieldToJson(*c.heightfield));
+                    colliderJson["heightfield"] = it->second;
+                }
+
+                if ((c.type == ColliderType::Mesh && !c.triangleMesh) || (c.type == ColliderType::Heightfield && !c.heightfield)) {
+                    XI_LOG_WARN("Collider on '" + info.name + "' has no shape data and collides with nothing");
+                }
             }
 
             // RigidBody
@@ -122,7 +181,8 @@ namespace Xi {
                     {"angularDrag", rb.angularDrag},
                     {"useGravity", rb.useGravity},
                     {"friction", rb.friction},
-                    {"bounciness", rb.bounciness}
+                    {"bounciness", rb.bounciness},
+                    {"isBullet", rb.isBullet}
                 };
             }
 
@@ -172,6 +232,20 @@ namespace Xi {
 
         m_World.Clear();
 
+        std::vector<std::shared_ptr<TriangleMesh>> triangleMeshes;
+        if (scene.contains("triangleMeshes")) {
+            for (const auto& meshJson : scene["triangleMeshes"]) {
+                triangleMeshes.push_back(JsonToTriangleMesh(meshJson));
+            }
+        }
+
+        std::vector<std::shared_ptr<Heightfield>> heightfields;
+        if (scene.contains("heightfields")) {
+            for (const auto& heightfieldJson : scene["heightfields"]) {
+                heightfields.push_back(JsonToHeightfield(heightfieldJson));
+            }
+        }
+
         // First pass: create all entities
         std::unordered_map<Entity, Entity> entityMap; // Old ID -> New ID
 
@@ -246,6 +320,19 @@ namespace Xi {
                 col.isTrigger = c["isTrigger"].get<bool>();
                 col.layer = c["layer"].get<uint32_t>();
                 col.mask = c["mask"].get<uint32_t>();
+
+                if (c.contains("triangleMesh")) {
+                    size_t index = c["triangleMesh"].get<size_t>();
+                    if (index < triangleMeshes.size()) col.triangleMesh = triangleMeshes[index];
+                }
+                if (c.contains("heightfield")) {
+                    size_t index = c["heightfield"].get<size_t>();
+                    if (index < heightfields.size()) col.heightfield = heightfields[index];
+                }
+
+                if ((col.type == ColliderType::Mesh && !col.triangleMesh) || (col.type == ColliderType::Heightfield && !col.heightfield)) {
+                    XI_LOG_WARN("Collider on '" + m_World.GetEntityName(entity) + "' has no shape data and collides with nothing");
+                }
             }
 
             // RigidBody
@@ -259,6 +346,7 @@ namespace Xi {
                 rb.useGravity = r["useGravity"].get<bool>();
                 rb.friction = r["friction"].get<float>();
                 rb.bounciness = r["bounciness"].get<float>();
+                if (r.contains("isBullet")) rb.isBullet = r["isBullet"].get<bool>();
             }
 
             // AudioSource
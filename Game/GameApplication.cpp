@@ -9,6 +9,8 @@
 #include "../Engine/ECS/Components/Collider.h"
 #include "../Engine/ECS/Components/RigidBody.h"
 #include "../Engine/Renderer/Renderer.h"
+#include "../Engine/Physics/PhysicsWorld.h"
+#include "../Engine/Physics/PhysicsSystem.h"
 #include "../Engine/Renderer/Primitives.h"
 #include "../Engine/Renderer/Material.h"
 #include "../Engine/Resources/ResourceManager.h"
@@ -143,6 +145,8 @@ namespace Xi {
         if (Input::IsKeyPressed(KeyCode::Escape)) {
             Quit();
         }
+
+        CollectLights();
     }
 
     void GameApplication::OnFixedUpdate(float dt) {
@@ -150,11 +154,10 @@ namespace Xi {
         // Fixed timestep physics updates are handled by Application
     }
 
-    void GameApplication::OnRender() {
+    void GameApplication::CollectLights() {
         World& world = GetWorld();
-        Renderer& renderer = GetRenderer();
+        m_Lights.clear();
 
-        // Collect lights from the scene
         auto* lightPool = world.GetComponentPool<Light>();
         auto* transformPool = world.GetComponentPool<Transform>();
 
@@ -172,31 +175,49 @@ namespace Xi {
                 lightData.color = l.color;
                 lightData.intensity = l.intensity;
                 lightData.range = l.range;
+                lightData.attenuation = l.attenuation;
                 lightData.spotAngle = l.outerAngle;
+                lightData.innerSpotAngle = l.innerAngle;
 
-                renderer.AddLight(lightData);
+                m_Lights.push_back(lightData);
             }
         }
+    }
 
-        // Submit mesh renderers to the render queue
-        auto* meshPool = world.GetComponentPool<MeshRenderer>();
-        if (meshPool && transformPool) {
-            int submitted = 0;
-            for (Entity entity : meshPool->GetEntities()) {
-                if (!world.HasComponent<Transform>(entity)) continue;
-                if (!world.IsEntityActive(entity)) continue;
+    void GameApplication::OnRender() {
+        World& world = GetWorld();
+        Renderer& renderer = GetRenderer();
 
-                const Transform& t = world.GetComponent<Transform>(entity);
-                const MeshRenderer& mr = world.GetComponent<MeshRenderer>(entity);
+        for (const LightData& light : m_Lights) {
+            renderer.AddLight(light);
+        }
 
-                if (mr.visible && mr.mesh && mr.material) {
-                    renderer.Submit(mr.mesh, mr.material, t.GetMatrix());
-                    submitted++;
-                }
-            }
-            // Log once per second to avoid spam
-            static float logTimer = 0.0f;
-            logTimer += 0.016f;
+        // Submit mesh renderers to the render queue. Bodies are drawn between their last two
+        // physics poses so motion stays smooth when frames and fixed steps don't line up.
+        const PhysicsWorld& physics = GetPhysics();
+        float alpha = GetPhysicsSystem().GetInterpolationAlpha();
+
+        // Workers only read the world and physics, and record into lists of their own
+        auto* meshPool = world.GetComponentPool<MeshRenderer>();
+        auto* transformPool = world.GetComponentPool<Transform>();
+        if (meshPool && transformPool) {
+            const World& scene = world;
+            const std::vector<Entity>& entities = meshPool->GetEntities();
+            renderer.SubmitParallel(static_cast<uint32_t>(entities.size()), 256,
+                [&](RenderCommandList& list, uint32_t begin, uint32_t end) {
+                    for (uint32_t i = begin; i < end; i++) {
+                        Entity entity = entities[i];
+                        if (!scene.HasComponent<Transform>(entity)) continue;
+                        if (!scene.IsEntityActive(entity)) continue;
+
+                        const Transform& t = scene.GetComponent<Transform>(entity);
+                        const MeshRenderer& mr = scene.GetComponent<MeshRenderer>(entity);
+
+                        if (mr.visible && mr.mesh && mr.material) {
+                            list.Submit(*mr.mesh, *mr.material, physics.GetInterpolatedMatrix(entity, t, alpha));
+                        }
+                    }
+                });
         }
     }
 
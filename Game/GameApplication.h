@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../Engine/Core/Application.h"
+#include "../Engine/Renderer/FramePacket.h"
+#include <vector>
 
 namespace Xi {
 
@@ -19,6 +21,11 @@ namespace Xi {
 
     private:
         void CreateDemoScene();
+        void CollectLights();
+
+        // Collected in OnUpdate, before physics steps on its own thread and writes the
+        // transforms of bodies, and added to the renderer in OnRender
+        std::vector<LightData> m_Lights;
     };
 
 }
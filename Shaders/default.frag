@@ -4,10 +4,16 @@ in vec3 v_WorldPos;
 in vec3 v_Normal;
 in vec2 v_TexCoord;
 in mat3 v_TBN;
+in vec4 v_ClipPos;
 
 out vec4 FragColor;
 
-uniform vec3 u_CameraPos;
+layout(std140, binding = 0) uniform CameraData {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec3 u_CameraPos;
+};
+
 uniform vec4 u_AlbedoColor;
 uniform float u_Metallic;
 uniform float u_Roughness;
@@ -19,13 +25,31 @@ uniform int u_HasNormalMap;
 uniform sampler2D u_AlbedoMap;
 uniform sampler2D u_NormalMap;
 
-// Lights
-uniform int u_NumLights;
-uniform vec3 u_LightPositions[8];
-uniform vec3 u_LightDirections[8];
-uniform vec3 u_LightColors[8];
-uniform float u_LightIntensities[8];
-uniform int u_LightTypes[8]; // 0 = directional, 1 = point, 2 = spot
+// Lights: directional ones first, then point and spot lights, found through the fragment's
+// cluster of the froxel grid
+struct LightData {
+    vec4 position;   // w = type: 0 = directional, 1 = point, 2 = spot
+    vec4 direction;  // w = range
+    vec4 color;      // w = intensity
+    vec4 spot;       // x = cosine of the outer angle, y = of the inner angle, z = attenuation
+};
+
+layout(std140, binding = 1) uniform LightBlock {
+    uvec4 u_ClusterGrid;  // xyz = clusters across, up and in depth, w = directional light count
+    vec4 u_ClusterDepth;  // Slice = log(view depth) * x - y
+};
+
+layout(std430, binding = 0) readonly buffer LightBuffer {
+    LightData u_Lights[];
+};
+
+layout(std430, binding = 1) readonly buffer ClusterBuffer {
+    uvec2 u_Clusters[];  // x = first entry in u_LightIndices, y = count
+};
+
+layout(std430, binding = 2) readonly buffer LightIndexBuffer {
+    uint u_LightIndices[];
+};
 
 const float PI = 3.14159265359;
 
@@ -65,6 +89,59 @@ float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
     return ggx1 * ggx2;
 }
 
+vec3 EvaluateLight(LightData light, vec3 N, vec3 V, vec3 F0, vec3 albedo) {
+    vec3 L;
+    float attenuation = 1.0;
+
+    if (int(light.position.w) == 0) {
+        // Directional light
+        L = normalize(-light.direction.xyz);
+    } else {
+        // Point or spot light: inverse-square falloff, windowed to reach zero at the range
+        vec3 toLight = light.position.xyz - v_WorldPos;
+        float distance = length(toLight);
+        L = toLight / max(distance, 0.0001);
+
+        float ratio = distance / light.direction.w;
+        float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+        attenuation = window * window / (1.0 + light.spot.z * distance * distance);
+
+        if (int(light.position.w) == 2) {
+            float cosAngle = dot(-L, normalize(light.direction.xyz));
+            attenuation *= smoothstep(light.spot.x, light.spot.y, cosAngle);
+        }
+    }
+
+    vec3 H = normalize(V + L);
+    vec3 radiance = light.color.rgb * light.color.w * attenuation;
+
+    float NDF = DistributionGGX(N, H, u_Roughness);
+    float G = GeometrySmith(N, V, L, u_Roughness);
+    vec3 F = FresnelSchlick(max(dot(H, V), 0.0), F0);
+
+    vec3 numerator = NDF * G * F;
+    float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
+    vec3 specular = numerator / denominator;
+
+    vec3 kS = F;
+    vec3 kD = vec3(1.0) - kS;
+    kD *= 1.0 - u_Metallic;
+
+    float NdotL = max(dot(N, L), 0.0);
+    return (kD * albedo / PI + specular) * radiance * NdotL;
+}
+
+uint FindCluster() {
+    vec2 ndc = v_ClipPos.xy / v_ClipPos.w;
+    vec2 grid = vec2(u_ClusterGrid.xy);
+    uvec2 tile = uvec2(clamp((ndc * 0.5 + 0.5) * grid, vec2(0.0), grid - 1.0));
+
+    float depth = max(-(u_View * vec4(v_WorldPos, 1.0)).z, 0.0001);
+    float slice = clamp(floor(log(depth) * u_ClusterDepth.x - u_ClusterDepth.y), 0.0, float(u_ClusterGrid.z) - 1.0);
+
+    return tile.x + tile.y * u_ClusterGrid.x + uint(slice) * u_ClusterGrid.x * u_ClusterGrid.y;
+}
+
 void main() {
     vec4 albedo = u_AlbedoColor;
     if (u_HasAlbedoMap == 1) {
@@ -85,37 +162,13 @@ void main() {
 
     vec3 Lo = vec3(0.0);
 
-    for (int i = 0; i < u_NumLights && i < 8; i++) {
-        vec3 L;
-        float attenuation = 1.0;
-
-        if (u_LightTypes[i] == 0) {
-            // Directional light
-            L = normalize(-u_LightDirections[i]);
-        } else {
-            // Point or spot light
-            L = normalize(u_LightPositions[i] - v_WorldPos);
-            float distance = length(u_LightPositions[i] - v_WorldPos);
-            attenuation = 1.0 / (distance * distance);
-        }
-
-        vec3 H = normalize(V + L);
-        vec3 radiance = u_LightColors[i] * u_LightIntensities[i] * attenuation;
-
-        float NDF = DistributionGGX(N, H, u_Roughness);
-        float G = GeometrySmith(N, V, L, u_Roughness);
-        vec3 F = FresnelSchlick(max(dot(H, V), 0.0), F0);
-
-        vec3 numerator = NDF * G * F;
-        float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
-        vec3 specular = numerator / denominator;
-
-        vec3 kS = F;
-        vec3 kD = vec3(1.0) - kS;
-        kD *= 1.0 - u_Metallic;
+    for (uint i = 0u; i < u_ClusterGrid.w; i++) {
+        Lo += EvaluateLight(u_Lights[i], N, V, F0, albedo.rgb);
+    }
 
-        float NdotL = max(dot(N, L), 0.0);
-        Lo += (kD * albedo.rgb / PI + specular) * radiance * NdotL;
+    uvec2 cluster = u_Clusters[FindCluster()];
+    for (uint i = 0u; i < cluster.y; i++) {
+        Lo += EvaluateLight(u_Lights[u_LightIndices[cluster.x + i]], N, V, F0, albedo.rgb);
     }
 
     vec3 ambient = vec3(0.03) * albedo.rgb * u_AO;
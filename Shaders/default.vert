@@ -5,20 +5,31 @@ layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
 layout(location = 3) in vec3 a_Tangent;
 
+#ifdef XI_INSTANCED
+layout(location = 4) in mat4 a_InstanceModel;
+#define MODEL_MATRIX a_InstanceModel
+#else
 uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Projection;
+#define MODEL_MATRIX u_Model
+#endif
+
+layout(std140, binding = 0) uniform CameraData {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec3 u_CameraPos;
+};
 
 out vec3 v_WorldPos;
 out vec3 v_Normal;
 out vec2 v_TexCoord;
 out mat3 v_TBN;
+out vec4 v_ClipPos;
 
 void main() {
-    vec4 worldPos = u_Model * vec4(a_Position, 1.0);
+    vec4 worldPos = MODEL_MATRIX * vec4(a_Position, 1.0);
     v_WorldPos = worldPos.xyz;
 
-    mat3 normalMatrix = transpose(inverse(mat3(u_Model)));
+    mat3 normalMatrix = transpose(inverse(mat3(MODEL_MATRIX)));
     v_Normal = normalize(normalMatrix * a_Normal);
 
     vec3 T = normalize(normalMatrix * a_Tangent);
@@ -30,4 +41,5 @@ void main() {
     v_TexCoord = a_TexCoord;
 
     gl_Position = u_Projection * u_View * worldPos;
+    v_ClipPos = gl_Position;
 }
@@ -4,13 +4,23 @@ layout(location = 0) in vec3 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
 
+#ifdef XI_INSTANCED
+layout(location = 4) in mat4 a_InstanceModel;
+#define MODEL_MATRIX a_InstanceModel
+#else
 uniform mat4 u_Model;
-uniform mat4 u_View;
-uniform mat4 u_Projection;
+#define MODEL_MATRIX u_Model
+#endif
+
+layout(std140, binding = 0) uniform CameraData {
+    mat4 u_View;
+    mat4 u_Projection;
+    vec3 u_CameraPos;
+};
 
 out vec2 v_TexCoord;
 
 void main() {
     v_TexCoord = a_TexCoord;
-    gl_Position = u_Projection * u_View * u_Model * vec4(a_Position, 1.0);
+    gl_Position = u_Projection * u_View * MODEL_MATRIX * vec4(a_Position, 1.0);
 }